@@ -0,0 +1,422 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Benchmark driver for catching performance regressions between releases.
+ * Loads all MPS/OPB instances of a directory (or a single instance), runs the
+ * complete presolve and every presolve method in isolation and reports wall
+ * time, reductions and peak memory for every run as JSON.
+ */
+
+#include "papilo/core/Presolve.hpp"
+#include "papilo/core/Problem.hpp"
+#include "papilo/io/Parser.hpp"
+#include "papilo/misc/Timer.hpp"
+#include "papilo/misc/Vec.hpp"
+#include "papilo/misc/fmt.hpp"
+#ifdef PAPILO_TBB
+#include "papilo/misc/tbb.hpp"
+#endif
+#include "papilo/external/pdqsort/pdqsort.h"
+
+#include <boost/algorithm/string/trim.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/resource.h>
+#endif
+
+using namespace papilo;
+
+struct BenchRun
+{
+   std::string instance;
+   std::string presolver;
+   std::string timing;
+   double time = 0.0;
+   PresolveStatus status = PresolveStatus::kUnchanged;
+   Statistics stats;
+   int nrows = 0;
+   int ncols = 0;
+   int nnz = 0;
+   long peak_memory_kb = 0;
+};
+
+static bool
+isDirectory( const std::string& name )
+{
+   struct stat buff;
+   return stat( name.c_str(), &buff ) == 0 && S_ISDIR( buff.st_mode );
+}
+
+static bool
+isInstanceFile( const std::string& name )
+{
+   return name.find( ".mps" ) != std::string::npos ||
+          name.find( ".opb" ) != std::string::npos;
+}
+
+static Vec<std::string>
+collectInstances( const std::string& path )
+{
+   Vec<std::string> instances;
+
+   if( !isDirectory( path ) )
+   {
+      instances.push_back( path );
+      return instances;
+   }
+
+#ifndef _WIN32
+   DIR* dir = opendir( path.c_str() );
+   if( dir == nullptr )
+      return instances;
+
+   while( struct dirent* entry = readdir( dir ) )
+   {
+      std::string name = entry->d_name;
+      if( name == "." || name == ".." )
+         continue;
+
+      std::string full = path + "/" + name;
+      if( isDirectory( full ) )
+      {
+         Vec<std::string> sub = collectInstances( full );
+         instances.insert( instances.end(), sub.begin(), sub.end() );
+      }
+      else if( isInstanceFile( name ) )
+         instances.push_back( full );
+   }
+   closedir( dir );
+#else
+   fmt::print( "reading instance directories is not supported on this "
+               "platform\n" );
+#endif
+
+   pdqsort( instances.begin(), instances.end() );
+   return instances;
+}
+
+/// returns the peak resident set size of the process in kilobytes and resets
+/// the counter if the operating system allows it, such that consecutive runs
+/// report their own peak
+static long
+peakMemoryKb()
+{
+#if defined( __linux__ )
+   // ru_maxrss also holds the peak of exited threads, e.g. TBB workers, and
+   // cannot be reset, hence the high water mark of the address space is read
+   long peak = 0;
+   std::ifstream status( "/proc/self/status" );
+   for( std::string line; std::getline( status, line ); )
+   {
+      if( line.compare( 0, 6, "VmHWM:" ) == 0 )
+      {
+         peak = std::strtol( line.c_str() + 6, nullptr, 10 );
+         break;
+      }
+   }
+
+   // writing 5 to clear_refs resets the high water mark (Linux >= 4.0)
+   std::FILE* clear_refs = std::fopen( "/proc/self/clear_refs", "w" );
+   if( clear_refs != nullptr )
+   {
+      std::fputs( "5", clear_refs );
+      std::fclose( clear_refs );
+   }
+   return peak;
+#elif !defined( _WIN32 )
+   struct rusage usage;
+   if( getrusage( RUSAGE_SELF, &usage ) == 0 )
+      return usage.ru_maxrss;
+   return 0;
+#else
+   return 0;
+#endif
+}
+
+static std::string
+timingName( PresolverTiming timing )
+{
+   switch( timing )
+   {
+   case PresolverTiming::kFast:
+      return "fast";
+   case PresolverTiming::kMedium:
+      return "medium";
+   case PresolverTiming::kExhaustive:
+      return "exhaustive";
+   }
+   return "undefined";
+}
+
+static std::string
+statusName( PresolveStatus status )
+{
+   switch( status )
+   {
+   case PresolveStatus::kUnchanged:
+      return "unchanged";
+   case PresolveStatus::kReduced:
+      return "reduced";
+   case PresolveStatus::kUnbndOrInfeas:
+      return "unbounded_or_infeasible";
+   case PresolveStatus::kUnbounded:
+      return "unbounded";
+   case PresolveStatus::kInfeasible:
+      return "infeasible";
+   }
+   return "undefined";
+}
+
+static std::string
+escapeJson( const std::string& str )
+{
+   std::string escaped;
+   escaped.reserve( str.size() );
+   for( char c : str )
+   {
+      if( c == '"' || c == '\\' )
+         escaped.push_back( '\\' );
+      escaped.push_back( c );
+   }
+   return escaped;
+}
+
+static bool
+loadSettings( ParameterSet& paramSet, const std::string& settingsFile )
+{
+   std::ifstream input( settingsFile );
+   if( !input )
+   {
+      fmt::print( "could not read parameter file '{}'\n", settingsFile );
+      return false;
+   }
+
+   for( String line; getline( input, line ); )
+   {
+      std::size_t pos = line.find_first_of( '#' );
+      if( pos != String::npos )
+         line = line.substr( 0, pos );
+
+      pos = line.find_first_of( '=' );
+      if( pos == String::npos )
+         continue;
+
+      String key = line.substr( 0, pos );
+      String value = line.substr( pos + 1 );
+      boost::algorithm::trim( key );
+      boost::algorithm::trim( value );
+
+      try
+      {
+         paramSet.parseParameter( key.c_str(), value.c_str() );
+      }
+      catch( const std::exception& e )
+      {
+         fmt::print( "parameter '{}' could not be set: {}\n", line, e.what() );
+      }
+   }
+   return true;
+}
+
+/// runs presolve on a copy of the given problem. If a presolver name is given
+/// all other presolvers are disabled
+static BenchRun
+runPresolve( const Problem<double>& original, const std::string& instance,
+             const std::string& presolverName, int threads,
+             const std::string& settingsFile )
+{
+   BenchRun run;
+   run.instance = instance;
+   run.presolver = presolverName.empty() ? "all" : presolverName;
+   run.timing = "all";
+
+   Problem<double> problem = original;
+   Presolve<double> presolve;
+   presolve.addDefaultPresolvers();
+
+   ParameterSet paramSet = presolve.getParameters();
+   if( !settingsFile.empty() )
+      loadSettings( paramSet, settingsFile );
+
+   if( !presolverName.empty() )
+   {
+      for( const auto& presolver : presolve.getPresolvers() )
+      {
+         bool enabled = presolver->getName() == presolverName;
+         paramSet.setParameter(
+             fmt::format( "{}.enabled", presolver->getName() ).c_str(),
+             enabled );
+         if( enabled )
+            run.timing = timingName( presolver->getTiming() );
+      }
+   }
+
+   presolve.getPresolveOptions().threads = std::max( 0, threads );
+   presolve.setVerbosityLevel( VerbosityLevel::kQuiet );
+
+   peakMemoryKb();
+   {
+      Timer t( run.time );
+      PresolveResult<double> result = presolve.apply( problem, false );
+      run.status = result.status;
+   }
+   run.peak_memory_kb = peakMemoryKb();
+
+   run.stats = presolve.getStatistics();
+   run.nrows = problem.getNRows();
+   run.ncols = problem.getNCols();
+   run.nnz = problem.getConstraintMatrix().getNnz();
+
+   return run;
+}
+
+static void
+printRun( fmt::memory_buffer& out, const BenchRun& run, bool last )
+{
+   fmt::format_to(
+       out,
+       "    {{\"instance\": \"{}\", \"presolver\": \"{}\", \"timing\": "
+       "\"{}\", \"status\": \"{}\", \"time\": {:.6f}, \"rounds\": {}, "
+       "\"deleted_cols\": {}, \"deleted_rows\": {}, \"bound_changes\": {}, "
+       "\"side_changes\": {}, \"coef_changes\": {}, \"tsx_applied\": {}, "
+       "\"tsx_conflicts\": {}, \"reduced_rows\": {}, \"reduced_cols\": {}, "
+       "\"reduced_nnz\": {}, \"peak_memory_kb\": {}}}{}\n",
+       escapeJson( run.instance ), escapeJson( run.presolver ), run.timing,
+       statusName( run.status ), run.time, run.stats.nrounds,
+       run.stats.ndeletedcols, run.stats.ndeletedrows, run.stats.nboundchgs,
+       run.stats.nsidechgs, run.stats.ncoefchgs, run.stats.ntsxapplied,
+       run.stats.ntsxconflicts, run.nrows, run.ncols, run.nnz,
+       run.peak_memory_kb, last ? "" : "," );
+}
+
+int
+main( int argc, char* argv[] )
+{
+   std::string path;
+   std::string outputFile;
+   std::string settingsFile;
+   int threads = 0;
+   bool isolated = true;
+
+   for( int i = 1; i < argc; ++i )
+   {
+      std::string arg = argv[i];
+      if( ( arg == "-o" || arg == "--output" ) && i + 1 < argc )
+         outputFile = argv[++i];
+      else if( ( arg == "-t" || arg == "--threads" ) && i + 1 < argc )
+         threads = std::atoi( argv[++i] );
+      else if( ( arg == "-p" || arg == "--parameter-settings" ) &&
+               i + 1 < argc )
+         settingsFile = argv[++i];
+      else if( arg == "--no-isolated" )
+         isolated = false;
+      else if( path.empty() && arg[0] != '-' )
+         path = arg;
+      else
+      {
+         path.clear();
+         break;
+      }
+   }
+
+   if( path.empty() )
+   {
+      fmt::print( "usage:\n" );
+      fmt::print( "./papilo-bench <instance or directory> [-o results.json] "
+                  "[-t threads] [-p settings.set] [--no-isolated]\n" );
+      fmt::print( "  runs presolve and every presolver in isolation on all "
+                  "MPS/OPB instances and reports the results as JSON\n" );
+      return 1;
+   }
+
+   Vec<std::string> instances = collectInstances( path );
+   if( instances.empty() )
+   {
+      fmt::print( "Error: no instances found at `{}`\n", path );
+      return 1;
+   }
+
+   Vec<BenchRun> runs;
+   Vec<std::pair<std::string, double>> readtimes;
+
+   for( const std::string& instance : instances )
+   {
+      double readtime = 0;
+      boost::optional<Problem<double>> prob;
+      {
+         Timer t( readtime );
+         prob = Parser<double>::loadProblem( instance );
+      }
+      if( !prob )
+      {
+         fmt::print( stderr, "error loading problem {}\n", instance );
+         continue;
+      }
+      readtimes.emplace_back( instance, readtime );
+
+      runs.push_back( runPresolve( *prob, instance, "", threads,
+                                   settingsFile ) );
+
+      if( !isolated )
+         continue;
+
+      Presolve<double> defaults;
+      defaults.addDefaultPresolvers();
+      for( const auto& presolver : defaults.getPresolvers() )
+         runs.push_back( runPresolve( *prob, instance, presolver->getName(),
+                                      threads, settingsFile ) );
+   }
+
+   fmt::memory_buffer out;
+   fmt::format_to( out, "{{\n  \"threads\": {},\n  \"reading\": [\n",
+                   threads );
+   for( std::size_t i = 0; i < readtimes.size(); ++i )
+      fmt::format_to( out, "    {{\"instance\": \"{}\", \"time\": {:.6f}}}{}\n",
+                      escapeJson( readtimes[i].first ), readtimes[i].second,
+                      i + 1 == readtimes.size() ? "" : "," );
+   fmt::format_to( out, "  ],\n  \"runs\": [\n" );
+   for( std::size_t i = 0; i < runs.size(); ++i )
+      printRun( out, runs[i], i + 1 == runs.size() );
+   fmt::format_to( out, "  ]\n}}\n" );
+
+   if( outputFile.empty() )
+      fmt::print( "{}", fmt::to_string( out ) );
+   else
+   {
+      std::ofstream ofs( outputFile );
+      if( !ofs )
+      {
+         fmt::print( "Error: can not write to `{}`\n", outputFile );
+         return 1;
+      }
+      ofs << fmt::to_string( out );
+   }
+
+   return 0;
+}
@@ -29,6 +29,7 @@
 #include "papilo/core/Objective.hpp"
 #include "papilo/core/Problem.hpp"
 #include "papilo/core/VariableDomains.hpp"
+#include "papilo/io/BinaryWriter.hpp"
 #include "papilo/io/Parser.hpp"
 #include "papilo/misc/Hash.hpp"
 #include "papilo/misc/Vec.hpp"
@@ -39,6 +40,7 @@
 #include "papilo/external/pdqsort/pdqsort.h"
 #include "tbb/concurrent_unordered_set.h"
 #include <algorithm>
+#include <numeric>
 
 using namespace papilo;
 
@@ -163,17 +165,40 @@ convMPS( const Problem<double>& prob )
 int
 main( int argc, char* argv[] )
 {
-   if( argc != 2 )
+   if( argc != 2 && argc != 3 )
    {
       fmt::print( "usage:\n" );
       fmt::print( "./convMPS instance1.mps         - create array of cpp code "
                   "to load instance.mps to papilo\n" );
+      fmt::print( "./convMPS instance1.mps out.pbin - convert instance.mps to "
+                  "the binary problem format\n" );
       return 1;
    }
-   assert( argc == 2 );
 
    auto prob = Parser<double>::loadProblem( argv[1] );
 
+   if( !prob )
+   {
+      fmt::print( "could not load problem {}\n", argv[1] );
+      return 1;
+   }
+
+   if( argc == 3 )
+   {
+      Vec<int> row_mapping( prob->getNRows() );
+      Vec<int> col_mapping( prob->getNCols() );
+      std::iota( row_mapping.begin(), row_mapping.end(), 0 );
+      std::iota( col_mapping.begin(), col_mapping.end(), 0 );
+
+      if( !BinaryWriter<double>::writeProb( argv[2], prob.get(), row_mapping,
+                                            col_mapping ) )
+      {
+         fmt::print( "could not write problem to {}\n", argv[2] );
+         return 1;
+      }
+      return 0;
+   }
+
    convMPS( prob.get() );
 
    return 0;
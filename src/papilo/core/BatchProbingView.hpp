@@ -0,0 +1,572 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _PAPILO_CORE_BATCH_PROBING_VIEW_HPP_
+#define _PAPILO_CORE_BATCH_PROBING_VIEW_HPP_
+
+#include "papilo/core/ImplicationStore.hpp"
+#include "papilo/core/ProbingView.hpp"
+#include "papilo/core/Problem.hpp"
+#include "papilo/misc/Hash.hpp"
+#include "papilo/misc/Vec.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace papilo
+{
+
+/// probes up to 32 binary columns with both values at once. Probe 2 * i fixes
+/// the i-th column of the batch to 1 and probe 2 * i + 1 fixes it to 0. The
+/// fixings of a column and the rows that need to be propagated are stored as
+/// bitmasks over the 64 probes, so that a single sweep over a changed row
+/// serves all probes that changed its activity. Only binary columns are
+/// propagated, bounds of other columns are not tightened. Like the ProbingView
+/// only the columns and rows touched by the batch are stored.
+template <typename REAL>
+class BatchProbingView
+{
+ public:
+   static constexpr int kMaxBatchCols = 32;
+
+   BatchProbingView( const Problem<REAL>& problem, const Num<REAL>& num );
+
+   /// probes the given binary columns with both values and stores the
+   /// resulting bound changes, substitutions and, if an implication store is
+   /// given, the implications between binary columns. The stored implications
+   /// are applied before propagating. Returns true if both values of a column
+   /// are infeasible.
+   bool
+   probeBatch( const int* cols, int ncols,
+               const ImplicationStore* implications );
+
+   /// column whose values were both infeasible in the last batch, or -1
+   int
+   getInfeasibleCol() const
+   {
+      return infeasibleCol;
+   }
+
+   const Vec<ProbingBoundChg<REAL>>&
+   getProbingBoundChanges() const
+   {
+      return boundChanges;
+   }
+
+   const Vec<ProbingSubstitution<REAL>>&
+   getProbingSubstitutions() const
+   {
+      return substitutions;
+   }
+
+   const Vec<std::pair<int, int>>&
+   getProbingImplications() const
+   {
+      return binaryImplications;
+   }
+
+   int64_t
+   getAmountOfWork() const
+   {
+      return amountofwork;
+   }
+
+   void
+   clearResults()
+   {
+      amountofwork = 0;
+      boundChanges.clear();
+      substitutions.clear();
+      binaryImplications.clear();
+   }
+
+ private:
+   struct ColState
+   {
+      int col;
+      uint64_t fixedToZero;
+      uint64_t fixedToOne;
+   };
+
+   struct RowState
+   {
+      int row;
+      uint64_t dirty;
+      REAL maxabscoef;
+   };
+
+   const Problem<REAL>& problem;
+   const Num<REAL>& num;
+
+   // state of the current batch
+   HashMap<int, int> colslots;
+   Vec<ColState> colstates;
+   HashMap<int, int> rowslots;
+   Vec<RowState> rowstates;
+   /// change of the minimal and maximal activity for every probe of a row
+   Vec<REAL> mindelta;
+   Vec<REAL> maxdelta;
+   Vec<int> proprows;
+   Vec<int> nextproprows;
+   uint64_t infeasibleProbes;
+   int infeasibleCol;
+
+   // scratch space for propagating a row
+   Vec<std::pair<REAL, int>> rhsSlacks;
+   Vec<std::pair<REAL, int>> lhsSlacks;
+   Vec<uint64_t> rhsPrefixMasks;
+   Vec<uint64_t> lhsPrefixMasks;
+
+   // results of probing and statistics
+   Vec<ProbingBoundChg<REAL>> boundChanges;
+   Vec<ProbingSubstitution<REAL>> substitutions;
+   Vec<std::pair<int, int>> binaryImplications;
+
+   int64_t amountofwork;
+
+   static int
+   lowestBit( uint64_t mask )
+   {
+      assert( mask != 0 );
+#if defined( __GNUC__ ) || defined( __clang__ )
+      return __builtin_ctzll( mask );
+#else
+      int bit = 0;
+      while( ( mask & 1 ) == 0 )
+      {
+         mask >>= 1;
+         ++bit;
+      }
+      return bit;
+#endif
+   }
+
+   bool
+   isUnfixedBinary( int col ) const
+   {
+      const VariableDomains<REAL>& domains = problem.getVariableDomains();
+
+      return domains.isBinary( col ) && domains.lower_bounds[col] == 0 &&
+             domains.upper_bounds[col] == 1;
+   }
+
+   uint64_t
+   getFixedProbes( int col ) const
+   {
+      auto it = colslots.find( col );
+      if( it == colslots.end() )
+         return 0;
+      return colstates[it->second].fixedToZero |
+             colstates[it->second].fixedToOne;
+   }
+
+   int
+   getRowSlot( int row );
+
+   void
+   fixCol( int col, bool value, uint64_t probes );
+
+   void
+   propagateRow( int slot, uint64_t probes );
+
+   void
+   propagate();
+
+   bool
+   analyze( const int* cols, int ncols, bool storeImplications );
+
+   void
+   clearBatch();
+};
+
+#ifdef PAPILO_USE_EXTERN_TEMPLATES
+extern template class BatchProbingView<double>;
+extern template class BatchProbingView<Quad>;
+extern template class BatchProbingView<Rational>;
+#endif
+
+template <typename REAL>
+BatchProbingView<REAL>::BatchProbingView( const Problem<REAL>& problem_,
+                                          const Num<REAL>& num_ )
+    : problem( problem_ ), num( num_ )
+{
+   infeasibleProbes = 0;
+   infeasibleCol = -1;
+   amountofwork = 0;
+}
+
+template <typename REAL>
+void
+BatchProbingView<REAL>::clearBatch()
+{
+   colslots.clear();
+   colstates.clear();
+   rowslots.clear();
+   rowstates.clear();
+   mindelta.clear();
+   maxdelta.clear();
+   proprows.clear();
+   nextproprows.clear();
+   infeasibleProbes = 0;
+}
+
+template <typename REAL>
+int
+BatchProbingView<REAL>::getRowSlot( int row )
+{
+   auto insres = rowslots.emplace( row, static_cast<int>( rowstates.size() ) );
+   if( !insres.second )
+      return insres.first->second;
+
+   // the largest coefficient of a binary column decides whether a row can
+   // fix a column for a probe at all
+   auto rowvec = problem.getConstraintMatrix().getRowCoefficients( row );
+   const int* rowcols = rowvec.getIndices();
+   const REAL* rowvals = rowvec.getValues();
+   const int rowlen = rowvec.getLength();
+
+   REAL maxabscoef = 0;
+   for( int k = 0; k != rowlen; ++k )
+   {
+      if( isUnfixedBinary( rowcols[k] ) )
+         maxabscoef = std::max( maxabscoef, REAL( abs( rowvals[k] ) ) );
+   }
+   amountofwork += rowlen;
+
+   rowstates.push_back( RowState{ row, 0, maxabscoef } );
+   mindelta.resize( mindelta.size() + 64, REAL{ 0 } );
+   maxdelta.resize( maxdelta.size() + 64, REAL{ 0 } );
+
+   return insres.first->second;
+}
+
+template <typename REAL>
+void
+BatchProbingView<REAL>::fixCol( int col, bool value, uint64_t probes )
+{
+   auto insres = colslots.emplace( col, static_cast<int>( colstates.size() ) );
+   if( insres.second )
+      colstates.push_back( ColState{ col, 0, 0 } );
+
+   ColState& state = colstates[insres.first->second];
+
+   // fixing the column to the other value makes the probes infeasible
+   infeasibleProbes |= probes & ( value ? state.fixedToZero : state.fixedToOne );
+   probes &= ~( state.fixedToZero | state.fixedToOne | infeasibleProbes );
+
+   if( probes == 0 )
+      return;
+
+   if( value )
+      state.fixedToOne |= probes;
+   else
+      state.fixedToZero |= probes;
+
+   const Vec<RowFlags>& rflags = problem.getConstraintMatrix().getRowFlags();
+   auto colvec = problem.getConstraintMatrix().getColumnCoefficients( col );
+   const int* colrows = colvec.getIndices();
+   const REAL* colvals = colvec.getValues();
+   const int collen = colvec.getLength();
+
+   for( int i = 0; i != collen; ++i )
+   {
+      if( rflags[colrows[i]].test( RowFlag::kRedundant ) )
+         continue;
+
+      const int slot = getRowSlot( colrows[i] );
+      const REAL& val = colvals[i];
+
+      // raising the lower bound to 1 or lowering the upper bound to 0
+      // changes one side of the activity by the coefficient
+      Vec<REAL>& delta = ( value == ( val > 0 ) ) ? mindelta : maxdelta;
+      const REAL change = value ? val : REAL( -val );
+
+      for( uint64_t m = probes; m != 0; m &= m - 1 )
+         delta[64 * size_t( slot ) + lowestBit( m )] += change;
+
+      if( rowstates[slot].dirty == 0 )
+         nextproprows.push_back( slot );
+      rowstates[slot].dirty |= probes;
+   }
+
+   amountofwork += collen;
+}
+
+template <typename REAL>
+void
+BatchProbingView<REAL>::propagateRow( int slot, uint64_t probes )
+{
+   const ConstraintMatrix<REAL>& consMatrix = problem.getConstraintMatrix();
+   const RowState state = rowstates[slot];
+   const int row = state.row;
+   const RowFlags rflags = consMatrix.getRowFlags()[row];
+   const RowActivity<REAL>& activity = problem.getRowActivities()[row];
+   const REAL& rhs = consMatrix.getRightHandSides()[row];
+   const REAL& lhs = consMatrix.getLeftHandSides()[row];
+
+   rhsSlacks.clear();
+   lhsSlacks.clear();
+
+   // check the probes for infeasibility and collect the ones whose slack is
+   // small enough to fix a column of the row
+   if( !rflags.test( RowFlag::kRhsInf ) && activity.ninfmin == 0 )
+   {
+      for( uint64_t m = probes; m != 0; m &= m - 1 )
+      {
+         const int probe = lowestBit( m );
+         REAL minact = activity.min + mindelta[64 * size_t( slot ) + probe];
+
+         if( num.isFeasLT( rhs, minact ) && num.isSafeLT( rhs, minact ) )
+            infeasibleProbes |= uint64_t{ 1 } << probe;
+         else if( num.isFeasLT( REAL( rhs - minact ), state.maxabscoef ) )
+            rhsSlacks.emplace_back( rhs - minact, probe );
+      }
+   }
+
+   if( !rflags.test( RowFlag::kLhsInf ) && activity.ninfmax == 0 )
+   {
+      for( uint64_t m = probes & ~infeasibleProbes; m != 0; m &= m - 1 )
+      {
+         const int probe = lowestBit( m );
+         REAL maxact = activity.max + maxdelta[64 * size_t( slot ) + probe];
+
+         if( num.isFeasGT( lhs, maxact ) && num.isSafeGT( lhs, maxact ) )
+            infeasibleProbes |= uint64_t{ 1 } << probe;
+         else if( num.isFeasLT( REAL( maxact - lhs ), state.maxabscoef ) )
+            lhsSlacks.emplace_back( maxact - lhs, probe );
+      }
+   }
+
+   if( rhsSlacks.empty() && lhsSlacks.empty() )
+      return;
+
+   // sorting the probes by their slack turns the probes in which a
+   // coefficient fixes its column into a prefix of the sorted probes
+   auto buildPrefixMasks = []( Vec<std::pair<REAL, int>>& slacks,
+                               Vec<uint64_t>& prefixMasks ) {
+      std::sort( slacks.begin(), slacks.end() );
+      prefixMasks.resize( slacks.size() + 1 );
+      prefixMasks[0] = 0;
+      for( size_t i = 0; i != slacks.size(); ++i )
+         prefixMasks[i + 1] =
+             prefixMasks[i] | ( uint64_t{ 1 } << slacks[i].second );
+   };
+
+   buildPrefixMasks( rhsSlacks, rhsPrefixMasks );
+   buildPrefixMasks( lhsSlacks, lhsPrefixMasks );
+
+   auto getFixingProbes = [this]( const Vec<std::pair<REAL, int>>& slacks,
+                                  const Vec<uint64_t>& prefixMasks,
+                                  const REAL& abscoef ) {
+      auto end = std::partition_point(
+          slacks.begin(), slacks.end(),
+          [&]( const std::pair<REAL, int>& slack ) {
+             return num.isFeasLT( slack.first, abscoef );
+          } );
+      return prefixMasks[end - slacks.begin()];
+   };
+
+   auto rowvec = consMatrix.getRowCoefficients( row );
+   const int* rowcols = rowvec.getIndices();
+   const REAL* rowvals = rowvec.getValues();
+   const int rowlen = rowvec.getLength();
+
+   for( int k = 0; k != rowlen; ++k )
+   {
+      const int col = rowcols[k];
+
+      if( !isUnfixedBinary( col ) )
+         continue;
+
+      const REAL abscoef = abs( rowvals[k] );
+      const uint64_t unfixed = ~( getFixedProbes( col ) | infeasibleProbes );
+
+      // the column would exceed the right hand side if it was moved away
+      // from the bound that gives the minimal activity
+      uint64_t fixing =
+          getFixingProbes( rhsSlacks, rhsPrefixMasks, abscoef ) & unfixed;
+      if( fixing != 0 )
+         fixCol( col, rowvals[k] < 0, fixing );
+
+      fixing = getFixingProbes( lhsSlacks, lhsPrefixMasks, abscoef ) &
+               ~( getFixedProbes( col ) | infeasibleProbes );
+      if( fixing != 0 )
+         fixCol( col, rowvals[k] > 0, fixing );
+   }
+
+   amountofwork += rowlen;
+}
+
+template <typename REAL>
+void
+BatchProbingView<REAL>::propagate()
+{
+   using std::swap;
+
+   swap( proprows, nextproprows );
+   nextproprows.clear();
+
+   while( !proprows.empty() )
+   {
+      for( int slot : proprows )
+      {
+         uint64_t probes = rowstates[slot].dirty & ~infeasibleProbes;
+         rowstates[slot].dirty = 0;
+
+         if( probes != 0 )
+            propagateRow( slot, probes );
+      }
+
+      swap( proprows, nextproprows );
+      nextproprows.clear();
+   }
+}
+
+template <typename REAL>
+bool
+BatchProbingView<REAL>::probeBatch( const int* cols, int ncols,
+                                    const ImplicationStore* implications )
+{
+   assert( ncols > 0 && ncols <= kMaxBatchCols );
+
+   clearBatch();
+   infeasibleCol = -1;
+
+   for( int i = 0; i != ncols; ++i )
+   {
+      assert( isUnfixedBinary( cols[i] ) );
+
+      for( int value = 1; value >= 0; --value )
+      {
+         const uint64_t probe = uint64_t{ 1 } << ( 2 * i + 1 - value );
+         fixCol( cols[i], value == 1, probe );
+
+         if( implications == nullptr )
+            continue;
+
+         amountofwork += implications->forEachImplied(
+             ImplicationStore::literal( cols[i], value == 1 ),
+             [&]( int lit ) {
+                const int col = ImplicationStore::getCol( lit );
+                if( isUnfixedBinary( col ) )
+                   fixCol( col, ImplicationStore::getValue( lit ), probe );
+             } );
+      }
+   }
+
+   propagate();
+
+   return analyze( cols, ncols, implications != nullptr );
+}
+
+template <typename REAL>
+bool
+BatchProbingView<REAL>::analyze( const int* cols, int ncols,
+                                 bool storeImplications )
+{
+   for( int i = 0; i != ncols; ++i )
+   {
+      if( ( ( infeasibleProbes >> ( 2 * i ) ) & 3 ) == 3 )
+      {
+         infeasibleCol = cols[i];
+         return true;
+      }
+   }
+
+   for( const ColState& state : colstates )
+   {
+      const int col = state.col;
+
+      for( int i = 0; i != ncols; ++i )
+      {
+         const uint64_t oneProbe = uint64_t{ 1 } << ( 2 * i );
+         const uint64_t zeroProbe = oneProbe << 1;
+
+         const bool oneInfeasible = ( infeasibleProbes & oneProbe ) != 0;
+         const bool zeroInfeasible = ( infeasibleProbes & zeroProbe ) != 0;
+
+         // only one value is feasible, so its fixings including the fixing of
+         // the probed column are valid for the problem
+         if( oneInfeasible || zeroInfeasible )
+         {
+            const uint64_t probe = oneInfeasible ? zeroProbe : oneProbe;
+
+            if( state.fixedToZero & probe )
+               boundChanges.emplace_back( true, col, 0, -1 );
+            else if( state.fixedToOne & probe )
+               boundChanges.emplace_back( false, col, 1, -1 );
+
+            continue;
+         }
+
+         if( col == cols[i] )
+            continue;
+
+         const bool fixedInOne = ( ( state.fixedToZero | state.fixedToOne ) &
+                                   oneProbe ) != 0;
+         const bool fixedInZero = ( ( state.fixedToZero | state.fixedToOne ) &
+                                    zeroProbe ) != 0;
+
+         if( storeImplications && fixedInOne )
+            binaryImplications.emplace_back(
+                ImplicationStore::literal( cols[i], true ),
+                ImplicationStore::literal(
+                    col, ( state.fixedToOne & oneProbe ) != 0 ) );
+
+         if( storeImplications && fixedInZero )
+            binaryImplications.emplace_back(
+                ImplicationStore::literal( cols[i], false ),
+                ImplicationStore::literal(
+                    col, ( state.fixedToOne & zeroProbe ) != 0 ) );
+
+         if( !fixedInOne || !fixedInZero )
+            continue;
+
+         REAL onefixval = ( state.fixedToOne & oneProbe ) ? 1 : 0;
+         REAL zerofixval = ( state.fixedToOne & zeroProbe ) ? 1 : 0;
+
+         if( onefixval == zerofixval )
+         {
+            // column is fixed to the same value in both probing branches
+            boundChanges.emplace_back( onefixval == 0, col, onefixval,
+                                       cols[i] );
+            continue;
+         }
+
+         // column is fixed to different values in both probing branches, the
+         // column with the smaller index is kept
+         int col1 = col;
+         int col2 = cols[i];
+         REAL scale = onefixval - zerofixval;
+
+         if( col1 < col2 )
+            std::swap( col1, col2 );
+
+         substitutions.emplace_back( col1, scale, col2, zerofixval );
+      }
+   }
+
+   return false;
+}
+
+} // namespace papilo
+
+#endif
@@ -24,10 +24,13 @@
 #define _PAPILO_CORE_COMPONENTS_HPP_
 
 #include "papilo/core/Problem.hpp"
-#include "papilo/misc/Hash.hpp"
+#include "papilo/misc/Array.hpp"
 #include "papilo/misc/Vec.hpp"
 #include "papilo/external/pdqsort/pdqsort.h"
-#include <boost/pending/disjoint_sets.hpp>
+#ifdef PAPILO_TBB
+#include "papilo/misc/tbb.hpp"
+#endif
+#include <atomic>
 
 namespace papilo
 {
@@ -107,12 +110,10 @@ class Components
    detectComponents( const Problem<REAL>& problem )
    {
       const int ncols = problem.getNCols();
-      std::unique_ptr<int[]> rank{ new int[ncols] };
-      std::unique_ptr<int[]> parent{ new int[ncols] };
-      boost::disjoint_sets<int*, int*> djsets( rank.get(), parent.get() );
+      Array<std::atomic_int> parent( ncols );
 
       for( int i = 0; i != ncols; ++i )
-         djsets.make_set( i );
+         parent[i].store( i, std::memory_order_relaxed );
 
       const ConstraintMatrix<REAL>& consMatrix = problem.getConstraintMatrix();
       const IndexRange* ranges;
@@ -121,40 +122,57 @@ class Components
       std::tie( ranges, nrows ) = consMatrix.getRangeInfo();
       const int* colinds = consMatrix.getColumns();
 
+#ifdef PAPILO_TBB
+      tbb::parallel_for(
+          tbb::blocked_range<int>( 0, nrows ),
+          [&]( const tbb::blocked_range<int>& range ) {
+             for( int r = range.begin(); r != range.end(); ++r )
+#else
       for( int r = 0; r != nrows; ++r )
-      {
-         if( ranges[r].end - ranges[r].start <= 1 )
-            continue;
+#endif
+             {
+                if( ranges[r].end - ranges[r].start <= 1 )
+                   continue;
 
-         int firstcol = colinds[ranges[r].start];
+                int firstcol = colinds[ranges[r].start];
 
-         for( int i = ranges[r].start + 1; i != ranges[r].end; ++i )
-            djsets.link( firstcol, colinds[i] );
-      }
+                for( int i = ranges[r].start + 1; i != ranges[r].end; ++i )
+                   link( parent, firstcol, colinds[i] );
+             }
+#ifdef PAPILO_TBB
+          } );
+#endif
+
+      // every set is represented by its smallest column, so the components
+      // are numbered in the order of their first column
+      Vec<int> colcomp( ncols );
+
+#ifdef PAPILO_TBB
+      tbb::parallel_for( tbb::blocked_range<int>( 0, ncols ),
+                         [&]( const tbb::blocked_range<int>& range ) {
+                            for( int i = range.begin(); i != range.end(); ++i )
+                               colcomp[i] = findRoot( parent, i );
+                         } );
+#else
+      for( int i = 0; i != ncols; ++i )
+         colcomp[i] = findRoot( parent, i );
+#endif
 
-      HashMap<int, int> componentmap;
+      int numcomponents = 0;
 
       for( int i = 0; i != ncols; ++i )
       {
-         int nextid = static_cast<int>( componentmap.size() );
-         componentmap.insert( { djsets.find_set( i ), nextid } );
+         if( colcomp[i] == i )
+            colcomp[i] = numcomponents++;
+         else
+            colcomp[i] = colcomp[colcomp[i]];
       }
 
-      int numcomponents = static_cast<int>( componentmap.size() );
-
       if( numcomponents > 1 )
       {
-         col2comp.resize( ncols );
-         compcols.resize( ncols );
-
-         for( int i = 0; i != ncols; ++i )
-         {
-            col2comp[i] = componentmap[djsets.find_set( i )];
-            compcols[i] = i;
-         }
+         col2comp = std::move( colcomp );
 
          row2comp.resize( nrows );
-         comprows.resize( nrows );
          for( int i = 0; i != nrows; ++i )
          {
             assert( problem.getConstraintMatrix()
@@ -164,74 +182,14 @@ class Components
                           .getRowCoefficients( i )
                           .getIndices()[0];
             row2comp[i] = col2comp[col];
-            comprows[i] = i;
          }
 
-         pdqsort( compcols.begin(), compcols.end(), [&]( int col1, int col2 ) {
-            return col2comp[col1] < col2comp[col2];
-         } );
-
-         compcolstart.resize( numcomponents + 1 );
-         int k = 0;
-
-         // first component starts at 0
-         compcolstart[0] = 0;
-
-         // fill out starts for second to last components, also reuse the
-         // col2comp vector to map the columns of a component to indices
+         // sort the columns and rows by their component, within a component
+         // they keep their order. The col2comp and row2comp vectors are
+         // reused to map the columns and rows of a component to indices
          // starting at 0 without gaps
-         for( int i = 1; i != numcomponents; ++i )
-         {
-            while( k != ncols && col2comp[compcols[k]] == i - 1 )
-            {
-               col2comp[compcols[k]] = k - compcolstart[i - 1];
-               ++k;
-            }
-
-            compcolstart[i] = k;
-         }
-
-         while( k != ncols )
-         {
-            assert( col2comp[compcols[k]] == numcomponents - 1 );
-            col2comp[compcols[k]] = k - compcolstart[numcomponents - 1];
-            ++k;
-         }
-
-         // last component ends at ncols
-         compcolstart[numcomponents] = ncols;
-
-         pdqsort( comprows.begin(), comprows.end(), [&]( int row1, int row2 ) {
-            return row2comp[row1] < row2comp[row2];
-         } );
-
-         comprowstart.resize( numcomponents + 1 );
-         k = 0;
-         // first component starts at 0
-         comprowstart[0] = 0;
-
-         // fill out starts for second to last components, also reuse the
-         // row2comp vector to map the rows of a component to indices starting
-         // at 0 without gaps
-         for( int i = 1; i != numcomponents; ++i )
-         {
-            while( k != nrows && row2comp[comprows[k]] == i - 1 )
-            {
-               row2comp[comprows[k]] = k - comprowstart[i - 1];
-               ++k;
-            }
-
-            comprowstart[i] = k;
-         }
-
-         while( k != nrows )
-         {
-            assert( row2comp[comprows[k]] == numcomponents - 1 );
-            row2comp[comprows[k]] = k - comprowstart[numcomponents - 1];
-            ++k;
-         }
-         // last component ends at nrows
-         comprowstart[numcomponents] = nrows;
+         sortByComponent( numcomponents, col2comp, compcols, compcolstart );
+         sortByComponent( numcomponents, row2comp, comprows, comprowstart );
 
          // compute size informaton of components
          compInfo.resize( numcomponents );
@@ -257,6 +215,143 @@ class Components
 
       return numcomponents;
    }
+
+   /// the sizes of the components formed by the active rows and columns in
+   /// the order of getComponentInfo() after the problem is compressed and its
+   /// components are detected. The problem does not need to be compressed, so
+   /// that it can be checked whether it splits before compressing it.
+   template <typename REAL>
+   static Vec<ComponentInfo>
+   getActiveComponentInfo( const Problem<REAL>& problem )
+   {
+      const int ncols = problem.getNCols();
+      Array<std::atomic_int> parent( ncols );
+
+      for( int i = 0; i != ncols; ++i )
+         parent[i].store( i, std::memory_order_relaxed );
+
+      const ConstraintMatrix<REAL>& consMatrix = problem.getConstraintMatrix();
+      const Vec<RowFlags>& rflags = consMatrix.getRowFlags();
+      const IndexRange* ranges;
+      int nrows;
+
+      std::tie( ranges, nrows ) = consMatrix.getRangeInfo();
+      const int* colinds = consMatrix.getColumns();
+
+      for( int r = 0; r != nrows; ++r )
+      {
+         if( rflags[r].test( RowFlag::kRedundant ) ||
+             ranges[r].end - ranges[r].start <= 1 )
+            continue;
+
+         int firstcol = colinds[ranges[r].start];
+
+         for( int i = ranges[r].start + 1; i != ranges[r].end; ++i )
+            link( parent, firstcol, colinds[i] );
+      }
+
+      // compressing keeps the order of the columns, hence numbering the
+      // components by their first active column gives the same ids
+      const auto& colsizes = problem.getColSizes();
+      const auto& cflags = problem.getColFlags();
+      Vec<int> rootcomp( ncols, -1 );
+      Vec<ComponentInfo> info;
+
+      for( int i = 0; i != ncols; ++i )
+      {
+         if( cflags[i].test( ColFlag::kInactive ) )
+            continue;
+
+         int root = findRoot( parent, i );
+         if( rootcomp[root] == -1 )
+         {
+            rootcomp[root] = static_cast<int>( info.size() );
+            info.push_back( ComponentInfo{ rootcomp[root], 0, 0, 0 } );
+         }
+
+         ComponentInfo& comp = info[rootcomp[root]];
+         if( cflags[i].test( ColFlag::kIntegral ) )
+            ++comp.nintegral;
+         else
+            ++comp.ncontinuous;
+         comp.nnonz += colsizes[i];
+      }
+
+      pdqsort( info.begin(), info.end() );
+
+      return info;
+   }
+
+ private:
+   /// returns the representative of the set of the column, halves the path
+   /// to it on the way. The parent of a column is never larger than the
+   /// column itself, therefore a failed update only means that another
+   /// thread has already shortened the path
+   static int
+   findRoot( Array<std::atomic_int>& parent, int col )
+   {
+      while( true )
+      {
+         int p = parent[col].load( std::memory_order_relaxed );
+         if( p == col )
+            return col;
+
+         int gp = parent[p].load( std::memory_order_relaxed );
+         if( gp != p )
+            parent[col].compare_exchange_weak( p, gp,
+                                               std::memory_order_relaxed );
+         col = gp;
+      }
+   }
+
+   /// joins the sets of the two columns by attaching the larger
+   /// representative to the smaller one, retries if the larger
+   /// representative got attached by another thread in the meantime
+   static void
+   link( Array<std::atomic_int>& parent, int col1, int col2 )
+   {
+      while( true )
+      {
+         col1 = findRoot( parent, col1 );
+         col2 = findRoot( parent, col2 );
+
+         if( col1 == col2 )
+            return;
+
+         if( col1 < col2 )
+            std::swap( col1, col2 );
+
+         int expected = col1;
+         if( parent[col1].compare_exchange_strong( expected, col2 ) )
+            return;
+      }
+   }
+
+   /// counting sort of the indices by their component
+   static void
+   sortByComponent( int numcomponents, Vec<int>& index2comp,
+                    Vec<int>& compindices, Vec<int>& compstart )
+   {
+      const int nindices = static_cast<int>( index2comp.size() );
+
+      compstart.assign( numcomponents + 1, 0 );
+      for( int i = 0; i != nindices; ++i )
+         ++compstart[index2comp[i] + 1];
+
+      for( int i = 0; i != numcomponents; ++i )
+         compstart[i + 1] += compstart[i];
+
+      compindices.resize( nindices );
+      Vec<int> pos( compstart.begin(), compstart.end() - 1 );
+
+      for( int i = 0; i != nindices; ++i )
+      {
+         int comp = index2comp[i];
+         compindices[pos[comp]] = i;
+         index2comp[i] = pos[comp] - compstart[comp];
+         ++pos[comp];
+      }
+   }
 };
 
 } // namespace papilo
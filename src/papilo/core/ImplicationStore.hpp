@@ -0,0 +1,485 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _PAPILO_CORE_IMPLICATION_STORE_HPP_
+#define _PAPILO_CORE_IMPLICATION_STORE_HPP_
+
+#include "papilo/core/Problem.hpp"
+#include "papilo/misc/Num.hpp"
+#include "papilo/misc/Vec.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+namespace papilo
+{
+
+/// Implications and cliques between binary columns that stay valid for the
+/// remaining presolve rounds. A literal 2 * col + val stands for fixing the
+/// binary column col to val. An implication (a, b) states that literal a
+/// being true forces literal b, a clique states that at most one of its
+/// literals is true. The store is kept in the column indices of the current
+/// problem and can be handed to a solver after presolving.
+class ImplicationStore
+{
+ public:
+   static int
+   literal( int col, bool value )
+   {
+      return 2 * col + ( value ? 1 : 0 );
+   }
+
+   static int
+   getCol( int lit )
+   {
+      return lit >> 1;
+   }
+
+   static bool
+   getValue( int lit )
+   {
+      return ( lit & 1 ) != 0;
+   }
+
+   static int
+   negated( int lit )
+   {
+      return lit ^ 1;
+   }
+
+   /// a negative maxsize does not limit the number of stored implications and
+   /// clique entries
+   explicit ImplicationStore( int ncols = 0, int64_t maxsize = -1 )
+       : ncols( ncols ), maxsize( maxsize ),
+         implication_start( 2 * size_t( ncols ) + 1, 0 ),
+         clique_start( 1, 0 ), literal_clique_start( 2 * size_t( ncols ) + 1, 0 )
+   {
+   }
+
+   int
+   getNCols() const
+   {
+      return ncols;
+   }
+
+   int64_t
+   getNImplications() const
+   {
+      return static_cast<int64_t>( implications.size() );
+   }
+
+   int
+   getNCliques() const
+   {
+      return static_cast<int>( clique_start.size() ) - 1;
+   }
+
+   bool
+   empty() const
+   {
+      return implications.empty() && clique_literals.empty();
+   }
+
+   /// implications sorted by their literals
+   const Vec<std::pair<int, int>>&
+   getImplications() const
+   {
+      return implications;
+   }
+
+   /// the literals of clique i are clique_literals[clique_start[i]] up to
+   /// clique_literals[clique_start[i + 1] - 1]
+   const Vec<int>&
+   getCliqueStart() const
+   {
+      return clique_start;
+   }
+
+   const Vec<int>&
+   getCliqueLiterals() const
+   {
+      return clique_literals;
+   }
+
+   /// adds the implications together with their contrapositives and returns
+   /// the number of new implications, implications exceeding the maximal size
+   /// of the store are dropped
+   int
+   addImplications( const Vec<std::pair<int, int>>& newimplications );
+
+   /// adds cliques stored in the same format as the cliques of the store and
+   /// returns the number of added cliques
+   int
+   addCliques( const Vec<int>& start, const Vec<int>& literals );
+
+   /// adds a clique for every row in which no two binary literals can be true
+   /// at the same time, only rows that consist of binary columns are
+   /// considered
+   template <typename REAL>
+   int
+   detectCliques( const Problem<REAL>& problem, const Num<REAL>& num );
+
+   /// returns whether the literal implied is forced by the literal lit either
+   /// directly or through a common clique
+   bool
+   implies( int lit, int implied ) const;
+
+   /// calls f for every literal that is forced by lit, literals can be passed
+   /// more than once if they are implied through several cliques; returns the
+   /// number of scanned implications and clique entries as amount of work
+   template <typename F>
+   int64_t
+   forEachImplied( int lit, F&& f ) const
+   {
+      assert( lit >= 0 && lit < 2 * ncols );
+
+      int64_t work = implication_start[lit + 1] - implication_start[lit];
+      for( int i = implication_start[lit]; i != implication_start[lit + 1];
+           ++i )
+         f( implications[i].second );
+
+      for( int i = literal_clique_start[lit];
+           i != literal_clique_start[lit + 1]; ++i )
+      {
+         int clique = literal_cliques[i];
+         work += clique_start[clique + 1] - clique_start[clique];
+         for( int k = clique_start[clique]; k != clique_start[clique + 1]; ++k )
+         {
+            if( clique_literals[k] != lit )
+               f( negated( clique_literals[k] ) );
+         }
+      }
+
+      return work;
+   }
+
+   /// removes the implications and cliques entries of deleted columns and
+   /// renumbers the remaining ones
+   void
+   compress( const Vec<int>& colmap, bool full = false );
+
+ private:
+   int ncols;
+   int64_t maxsize;
+
+   Vec<std::pair<int, int>> implications;
+   /// position of the first implication of every literal
+   Vec<int> implication_start;
+
+   Vec<int> clique_start;
+   Vec<int> clique_literals;
+   /// cliques containing a literal
+   Vec<int> literal_clique_start;
+   Vec<int> literal_cliques;
+
+   int64_t
+   getSize() const
+   {
+      return static_cast<int64_t>( implications.size() + clique_literals.size() );
+   }
+
+   void
+   buildImplicationStart();
+
+   void
+   buildCliqueIndex();
+};
+
+inline int
+ImplicationStore::addImplications(
+    const Vec<std::pair<int, int>>& newimplications )
+{
+   Vec<std::pair<int, int>> added;
+   added.reserve( 2 * newimplications.size() );
+
+   for( const std::pair<int, int>& impl : newimplications )
+   {
+      assert( impl.first >= 0 && impl.first < 2 * ncols );
+      assert( impl.second >= 0 && impl.second < 2 * ncols );
+
+      if( impl.first == impl.second )
+         continue;
+
+      added.push_back( impl );
+      added.emplace_back( negated( impl.second ), negated( impl.first ) );
+   }
+
+   std::sort( added.begin(), added.end() );
+   added.erase( std::unique( added.begin(), added.end() ), added.end() );
+   added.erase( std::remove_if( added.begin(), added.end(),
+                                [this]( const std::pair<int, int>& impl ) {
+                                   return implies( impl.first, impl.second );
+                                } ),
+                added.end() );
+
+   // the batch is sorted so that the dropped implications do not depend on
+   // the order in which they were found
+   if( maxsize >= 0 &&
+       getSize() + static_cast<int64_t>( added.size() ) > maxsize )
+      added.resize( static_cast<size_t>(
+          std::max( int64_t{ 0 }, maxsize - getSize() ) ) );
+
+   if( added.empty() )
+      return 0;
+
+   Vec<std::pair<int, int>> merged;
+   merged.reserve( implications.size() + added.size() );
+   std::merge( implications.begin(), implications.end(), added.begin(),
+               added.end(), std::back_inserter( merged ) );
+   implications.swap( merged );
+
+   buildImplicationStart();
+
+   return static_cast<int>( added.size() );
+}
+
+inline int
+ImplicationStore::addCliques( const Vec<int>& start, const Vec<int>& literals )
+{
+   assert( !start.empty() && start.back() == (int) literals.size() );
+
+   int ncliques = 0;
+   for( size_t i = 0; i + 1 < start.size(); ++i )
+   {
+      int len = start[i + 1] - start[i];
+      if( len < 2 )
+         continue;
+
+      if( maxsize >= 0 && getSize() + len > maxsize )
+         break;
+
+      clique_literals.insert( clique_literals.end(),
+                              literals.begin() + start[i],
+                              literals.begin() + start[i + 1] );
+      clique_start.push_back( static_cast<int>( clique_literals.size() ) );
+      ++ncliques;
+   }
+
+   if( ncliques != 0 )
+      buildCliqueIndex();
+
+   return ncliques;
+}
+
+template <typename REAL>
+int
+ImplicationStore::detectCliques( const Problem<REAL>& problem,
+                                 const Num<REAL>& num )
+{
+   const ConstraintMatrix<REAL>& consMatrix = problem.getConstraintMatrix();
+   const VariableDomains<REAL>& domains = problem.getVariableDomains();
+   const Vec<RowFlags>& rflags = consMatrix.getRowFlags();
+   const Vec<REAL>& lhs = consMatrix.getLeftHandSides();
+   const Vec<REAL>& rhs = consMatrix.getRightHandSides();
+
+   assert( problem.getNCols() == ncols );
+
+   Vec<int> start{ 0 };
+   Vec<int> literals;
+   Vec<REAL> weights;
+
+   for( int row = 0; row != problem.getNRows(); ++row )
+   {
+      if( rflags[row].test( RowFlag::kRedundant ) )
+         continue;
+
+      auto rowvec = consMatrix.getRowCoefficients( row );
+      const int* rowcols = rowvec.getIndices();
+      const REAL* rowvals = rowvec.getValues();
+      const int rowlen = rowvec.getLength();
+
+      if( rowlen < 2 ||
+          !std::all_of( rowcols, rowcols + rowlen,
+                        [&]( int col ) { return domains.isBinary( col ); } ) )
+         continue;
+
+      // the row side rhs is written as a knapsack with positive weights by
+      // complementing the columns with negative coefficients, the literals
+      // form a clique if the two smallest weights exceed the capacity
+      auto addCliqueOfSide = [&]( REAL side, REAL scale ) {
+         REAL capacity = side * scale;
+         weights.clear();
+         for( int k = 0; k != rowlen; ++k )
+         {
+            REAL val = rowvals[k] * scale;
+            if( val < 0 )
+               capacity -= val;
+            weights.push_back( abs( val ) );
+         }
+
+         REAL smallest = weights[0];
+         REAL second = weights[1];
+         if( second < smallest )
+            std::swap( smallest, second );
+         for( int k = 2; k < rowlen && second > capacity / 2; ++k )
+         {
+            if( weights[k] < smallest )
+            {
+               second = smallest;
+               smallest = weights[k];
+            }
+            else if( weights[k] < second )
+               second = weights[k];
+         }
+
+         if( !num.isFeasGT( smallest + second, capacity ) )
+            return;
+
+         for( int k = 0; k != rowlen; ++k )
+            literals.push_back( literal( rowcols[k], rowvals[k] * scale > 0 ) );
+         start.push_back( static_cast<int>( literals.size() ) );
+      };
+
+      if( !rflags[row].test( RowFlag::kRhsInf ) )
+         addCliqueOfSide( rhs[row], REAL{ 1 } );
+      if( !rflags[row].test( RowFlag::kLhsInf ) )
+         addCliqueOfSide( lhs[row], REAL{ -1 } );
+   }
+
+   return addCliques( start, literals );
+}
+
+inline bool
+ImplicationStore::implies( int lit, int implied ) const
+{
+   assert( lit >= 0 && lit < 2 * ncols );
+
+   if( std::binary_search( implications.begin() + implication_start[lit],
+                           implications.begin() + implication_start[lit + 1],
+                           std::make_pair( lit, implied ) ) )
+      return true;
+
+   // lit and the negation of implied are contained in a common clique
+   int other = negated( implied );
+   if( other == lit )
+      return false;
+
+   for( int i = literal_clique_start[lit]; i != literal_clique_start[lit + 1];
+        ++i )
+   {
+      int clique = literal_cliques[i];
+      if( std::find( clique_literals.begin() + clique_start[clique],
+                     clique_literals.begin() + clique_start[clique + 1],
+                     other ) !=
+          clique_literals.begin() + clique_start[clique + 1] )
+         return true;
+   }
+
+   return false;
+}
+
+inline void
+ImplicationStore::compress( const Vec<int>& colmap, bool full )
+{
+   auto mapLiteral = [&colmap]( int lit ) {
+      int col = colmap[getCol( lit )];
+      return col == -1 ? -1 : literal( col, getValue( lit ) );
+   };
+
+   assert( static_cast<int>( colmap.size() ) == ncols );
+   ncols = static_cast<int>(
+       std::count_if( colmap.begin(), colmap.end(),
+                      []( int col ) { return col != -1; } ) );
+
+   // the column mapping keeps the order of the columns, so the implications
+   // stay sorted
+   size_t nimplications = 0;
+   for( const std::pair<int, int>& impl : implications )
+   {
+      int first = mapLiteral( impl.first );
+      int second = mapLiteral( impl.second );
+      if( first != -1 && second != -1 )
+         implications[nimplications++] = { first, second };
+   }
+   implications.resize( nimplications );
+   assert( std::is_sorted( implications.begin(), implications.end() ) );
+
+   size_t nliterals = 0;
+   int ncliques = 0;
+   // clique_start is overwritten while compressing, so the start of the next
+   // clique in the old storage is remembered separately
+   int oldstart = 0;
+   for( int i = 0; i < getNCliques(); ++i )
+   {
+      size_t cliquestart = nliterals;
+      const int oldend = clique_start[i + 1];
+      for( int k = oldstart; k != oldend; ++k )
+      {
+         int lit = mapLiteral( clique_literals[k] );
+         if( lit != -1 )
+            clique_literals[nliterals++] = lit;
+      }
+      oldstart = oldend;
+
+      // cliques of fewer than two literals carry no information
+      if( nliterals - cliquestart < 2 )
+         nliterals = cliquestart;
+      else
+         clique_start[++ncliques] = static_cast<int>( nliterals );
+   }
+   clique_literals.resize( nliterals );
+   clique_start.resize( ncliques + 1 );
+
+   buildImplicationStart();
+   buildCliqueIndex();
+
+   if( full )
+   {
+      implications.shrink_to_fit();
+      clique_literals.shrink_to_fit();
+      clique_start.shrink_to_fit();
+      literal_cliques.shrink_to_fit();
+   }
+}
+
+inline void
+ImplicationStore::buildImplicationStart()
+{
+   implication_start.assign( 2 * size_t( ncols ) + 1, 0 );
+   for( const std::pair<int, int>& impl : implications )
+      ++implication_start[impl.first + 1];
+   for( int lit = 0; lit < 2 * ncols; ++lit )
+      implication_start[lit + 1] += implication_start[lit];
+}
+
+inline void
+ImplicationStore::buildCliqueIndex()
+{
+   literal_clique_start.assign( 2 * size_t( ncols ) + 1, 0 );
+   for( int lit : clique_literals )
+      ++literal_clique_start[lit + 1];
+   for( int lit = 0; lit < 2 * ncols; ++lit )
+      literal_clique_start[lit + 1] += literal_clique_start[lit];
+
+   literal_cliques.resize( clique_literals.size() );
+   Vec<int> next( literal_clique_start.begin(), literal_clique_start.end() - 1 );
+   for( int i = 0; i < getNCliques(); ++i )
+   {
+      for( int k = clique_start[i]; k != clique_start[i + 1]; ++k )
+         literal_cliques[next[clique_literals[k]]++] = i;
+   }
+}
+
+} // namespace papilo
+
+#endif
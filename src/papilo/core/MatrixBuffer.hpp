@@ -25,6 +25,10 @@
 
 #include "papilo/core/SparseStorage.hpp"
 #include "papilo/misc/Vec.hpp"
+#ifdef PAPILO_TBB
+#include "papilo/misc/tbb.hpp"
+#endif
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 
@@ -66,7 +70,11 @@ template <bool RowMajor>
 struct GetNodeProperty;
 
 /// data structure for sparse matrix entries that allows efficient row
-/// major and column major traversal
+/// major and column major traversal. Entries added with addEntry() are linked
+/// into the trees immediately. Entries added with appendEntry() are only
+/// stored and sortOrLink() decides before the traversal whether they are
+/// linked into the trees or, for large batches, whether all entries are
+/// sorted into flat row major and column major orders instead.
 template <typename REAL>
 struct MatrixBuffer
 {
@@ -224,6 +232,68 @@ struct MatrixBuffer
       *currnode = n;
    }
 
+   /// link all appended entries that are not yet part of the trees
+   void
+   linkPending()
+   {
+      for( ; nlinked != (int)entries.size(); ++nlinked )
+      {
+         this->template link<true>( nlinked );
+         this->template link<false>( nlinked );
+      }
+
+      sorted = false;
+   }
+
+   /// computes the order of the entries for the given storage order with two
+   /// stable counting sort passes, first by the minor and then by the major
+   /// index
+   template <bool RowMajor>
+   void
+   sortOrder( Vec<int>& order, int nrows, int ncols ) const
+   {
+      int nentries = (int)entries.size() - 1;
+      Vec<int> count( std::max( nrows, ncols ) + 1 );
+      Vec<int> tmp( nentries );
+      order.resize( nentries );
+
+      auto countingPass = [&]( bool major, const int* in, int* out ) {
+         auto key = [&]( int k ) {
+            return major == RowMajor ? entries[k].row : entries[k].col;
+         };
+
+         std::fill( count.begin(), count.end(), 0 );
+         for( int i = 0; i != nentries; ++i )
+            ++count[key( in == nullptr ? i + 1 : in[i] ) + 1];
+
+         for( int i = 1; i < (int)count.size(); ++i )
+            count[i] += count[i - 1];
+
+         for( int i = 0; i != nentries; ++i )
+         {
+            int k = in == nullptr ? i + 1 : in[i];
+            out[count[key( k )]++] = k;
+         }
+      };
+
+      countingPass( false, nullptr, tmp.data() );
+      countingPass( true, tmp.data(), order.data() );
+   }
+
+   /// entry at the given position of the sorted order, or the dummy entry
+   /// if the position is past the last entry
+   template <bool RowMajor>
+   const MatrixEntry<REAL>*
+   sortedEntry( int pos ) const
+   {
+      const Vec<int>& order = RowMajor ? row_order : col_order;
+
+      if( pos < (int)order.size() )
+         return &entries[order[pos]];
+
+      return &entries[0];
+   }
+
    bool
    empty() const
    {
@@ -236,16 +306,73 @@ struct MatrixBuffer
       entries.resize( 1 );
       col_major_root = 0;
       row_major_root = 0;
+      nlinked = 1;
+      sorted = false;
+      row_order.clear();
+      col_order.clear();
    }
 
    void
    addEntry( int row, int col, const REAL& val )
    {
-      int n = entries.size();
       entries.emplace_back( row, col, val );
 
-      this->template link<true>( n );
-      this->template link<false>( n );
+      linkPending();
+   }
+
+   /// add an entry without linking it, sortOrLink() must be called before
+   /// the entries are traversed
+   void
+   appendEntry( int row, int col, const REAL& val )
+   {
+      entries.emplace_back( row, col, val );
+      sorted = false;
+   }
+
+   /// prepares the appended entries for the traversal. Below sort_threshold
+   /// appended entries they are linked into the trees, otherwise all entries
+   /// are sorted by (row,col) and by (col,row) which is cheaper than linking
+   /// a large batch entry by entry
+   void
+   sortOrLink()
+   {
+      if( sorted )
+         return;
+
+      if( (int)entries.size() - nlinked < sort_threshold )
+      {
+         linkPending();
+         return;
+      }
+
+      int nrows = 0;
+      int ncols = 0;
+      for( int i = 1; i != (int)entries.size(); ++i )
+      {
+         nrows = std::max( nrows, entries[i].row + 1 );
+         ncols = std::max( ncols, entries[i].col + 1 );
+      }
+
+#ifdef PAPILO_TBB
+      tbb::parallel_invoke(
+          [&]() { this->template sortOrder<true>( row_order, nrows, ncols ); },
+          [&]() {
+             this->template sortOrder<false>( col_order, nrows, ncols );
+          } );
+#else
+      this->template sortOrder<true>( row_order, nrows, ncols );
+      this->template sortOrder<false>( col_order, nrows, ncols );
+#endif
+
+      sorted = true;
+   }
+
+   /// returns whether the entries are traversed in the sorted orders instead
+   /// of the trees
+   bool
+   isSorted() const
+   {
+      return sorted;
    }
 
    template <bool RowMajor>
@@ -255,6 +382,8 @@ struct MatrixBuffer
       using Node = GetNodeProperty<RowMajor>;
       MatrixEntry<REAL> entry( row, col, REAL{ 0 } );
 
+      linkPending();
+
       int k = Node::root( this );
 
       while( k != 0 )
@@ -294,6 +423,12 @@ struct MatrixBuffer
       stack.clear();
       stack.push_back( 0 );
 
+      // in the sorted mode the stack only holds the current position
+      if( sorted )
+         return sortedEntry<RowMajor>( 0 );
+
+      assert( nlinked == (int)entries.size() );
+
       int k = Node::root( this );
 
       while( k != 0 )
@@ -320,6 +455,22 @@ struct MatrixBuffer
 
       MatrixEntry<REAL> dummy( row, col, REAL{ 0 } );
 
+      if( sorted )
+      {
+         const Vec<int>& order = RowMajor ? row_order : col_order;
+         stack.back() = std::upper_bound( order.begin(), order.end(), dummy,
+                                          [&]( const MatrixEntry<REAL>& e,
+                                               int i ) {
+                                             return Node::lesser( e,
+                                                                  entries[i] );
+                                          } ) -
+                        order.begin();
+
+         return sortedEntry<RowMajor>( stack.back() );
+      }
+
+      assert( nlinked == (int)entries.size() );
+
       while( k != 0 )
       {
          if( Node::lesser( dummy, entries[k] ) )
@@ -342,6 +493,9 @@ struct MatrixBuffer
    {
       using Node = GetNodeProperty<RowMajor>;
 
+      if( sorted )
+         return sortedEntry<RowMajor>( ++stack.back() );
+
       int k = stack.back();
       stack.pop_back();
 
@@ -370,6 +524,7 @@ struct MatrixBuffer
    void
    startBadge()
    {
+      linkPending();
       badge_start = entries.size();
    }
 
@@ -399,6 +554,7 @@ struct MatrixBuffer
          this->template link<false>( i );
       }
 
+      nlinked = entries.size();
       badge_start = -1;
    }
 
@@ -416,6 +572,8 @@ struct MatrixBuffer
    {
       int nnz = getNnz();
 
+      sortOrLink();
+
       SparseStorage<REAL> csrStorage( nrows, ncols, nnz, spareRatio,
                                       mininterrowspace );
 
@@ -467,6 +625,8 @@ struct MatrixBuffer
    {
       int nnz = getNnz();
 
+      sortOrLink();
+
       SparseStorage<REAL> cscStorage( ncols, nrows, nnz, spareRatio,
                                       minintercolspace );
 
@@ -524,6 +684,15 @@ struct MatrixBuffer
    int row_major_root;
    int col_major_root;
    Vec<MatrixEntry<REAL>> entries;
+
+   /// entries before this position are linked into the trees
+   int nlinked = 1;
+   /// number of appended entries from which sortOrLink() sorts instead of
+   /// linking them
+   int sort_threshold = 1024;
+   bool sorted = false;
+   Vec<int> row_order;
+   Vec<int> col_order;
 };
 
 template <>
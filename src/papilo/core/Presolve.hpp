@@ -24,15 +24,19 @@
 #define _PAPILO_CORE_PRESOLVE_HPP_
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <fstream>
 #include <initializer_list>
 #include <memory>
+#include <sstream>
 #include <utility>
 
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
 
+#include "papilo/core/Components.hpp"
+#include "papilo/core/ImplicationStore.hpp"
 #include "papilo/core/PresolveMethod.hpp"
 #include "papilo/core/PresolveOptions.hpp"
 #include "papilo/core/Problem.hpp"
@@ -76,6 +80,9 @@ struct PresolveResult
 {
    PostsolveStorage<REAL> postsolve;
    PresolveStatus status;
+   /// implications and cliques between the binary columns of the reduced
+   /// problem
+   ImplicationStore implications;
 };
 
 enum class Delegator
@@ -162,6 +169,13 @@ class Presolve
       presolvers.emplace_back( std::move( presolveMethod ) );
    }
 
+   /// access the registered presolve methods
+   const Vec<std::unique_ptr<PresolveMethod<REAL>>>&
+   getPresolvers() const
+   {
+      return presolvers;
+   }
+
    void
    setLPSolverFactory( std::unique_ptr<SolverFactory<REAL>> value )
    {
@@ -369,11 +383,33 @@ class Presolve
                    const std::pair<int, int>& presolver_2_run,
                    ProblemUpdate<REAL>& probUpdate, bool& run_sequential, const Timer& timer );
 
+#ifdef PAPILO_TBB
+   void
+   run_presolvers_async( const Problem<REAL>& problem,
+                         const std::pair<int, int>& presolver_2_run,
+                         const std::pair<int, int>& fast_presolvers,
+                         ProblemUpdate<REAL>& probUpdate, bool& run_sequential,
+                         const Timer& timer );
+#endif
+
    bool
    is_status_infeasible_or_unbounded( const PresolveStatus& status ) const;
 
    bool
    are_only_dual_postsolve_presolvers_enabled();
+
+   bool
+   presolve_components( Problem<REAL>& problem,
+                        ProblemUpdate<REAL>& probUpdate,
+                        PresolveResult<REAL>& result, const Timer& timer );
+
+   static Problem<REAL>
+   extract_subproblem( const Problem<REAL>& problem, const Vec<int>& cols,
+                       const Vec<int>& rows, const Vec<int>& col2local );
+
+   static Problem<REAL>
+   join_problems( const Problem<REAL>& problem,
+                  const Vec<Problem<REAL>>& subproblems );
 };
 
 #ifdef PAPILO_USE_EXTERN_TEMPLATES
@@ -505,6 +541,7 @@ Presolve<REAL>::apply( Problem<REAL>& problem, bool store_dual_postsolve )
 
       for( int i = 0; i != npresolvers; ++i )
       {
+         presolvers[i]->resetChangeTracking();
          if( presolvers[i]->isEnabled() )
          {
             if( presolvers[i]->initialize( problem, presolveOptions ) )
@@ -521,12 +558,19 @@ Presolve<REAL>::apply( Problem<REAL>& problem, bool store_dual_postsolve )
          probUpdate.getCertificateInterface()->infeasible();
          return result;
       }
+
+      if( problem.getNumIntegralCols() != 0 )
+         probUpdate.getImplications().detectCliques( problem, num );
       printRoundStats( false, "Trivial" );
       round_to_evaluate = Delegator::kFast;
 
       finishRound( probUpdate );
       ++stats.nrounds;
 
+      if( presolveOptions.componentsminnnz >= 0 &&
+          presolve_components( problem, probUpdate, result, timer ) )
+         return result;
+
       nunsuccessful = 0;
       rundelayed = true;
       for( int i = 0; i < npresolvers; ++i )
@@ -558,6 +602,17 @@ Presolve<REAL>::apply( Problem<REAL>& problem, bool store_dual_postsolve )
                             was_executed_sequential, timer );
             break;
          case Delegator::kExhaustive:
+#ifdef PAPILO_TBB
+            if( presolveOptions.async_exhaustive_rounds &&
+                !presolveOptions.runs_sequential() &&
+                !presolveOptions.verification_with_VeriPB )
+            {
+               run_presolvers_async( problem, exhaustivePresolvers,
+                                     fastPresolvers, probUpdate,
+                                     was_executed_sequential, timer );
+               break;
+            }
+#endif
             run_presolvers( problem, exhaustivePresolvers, probUpdate,
                             was_executed_sequential, timer );
             break;
@@ -945,6 +1000,7 @@ Presolve<REAL>::apply( Problem<REAL>& problem, bool store_dual_postsolve )
             }
          }
 
+         result.implications = std::move( probUpdate.getImplications() );
          logStatus( probUpdate, result.postsolve );
          result.status = PresolveStatus::kReduced;
          //TODO:
@@ -970,6 +1026,7 @@ Presolve<REAL>::apply( Problem<REAL>& problem, bool store_dual_postsolve )
          return result;
       }
 
+      result.implications = std::move( probUpdate.getImplications() );
       logStatus( probUpdate, result.postsolve );
 
       // problem was not changed
@@ -1039,6 +1096,188 @@ Presolve<REAL>::run_presolvers( const Problem<REAL>& problem,
 #endif
 }
 
+#ifdef PAPILO_TBB
+template <typename REAL>
+void
+Presolve<REAL>::run_presolvers_async(
+    const Problem<REAL>& problem, const std::pair<int, int>& presolver_2_run,
+    const std::pair<int, int>& fast_presolvers,
+    ProblemUpdate<REAL>& probUpdate, bool& run_sequential, const Timer& timer )
+{
+   // the reductions are applied here while the presolvers run
+   run_sequential = true;
+
+   // the presolvers run as tasks on a copy of the problem so that the
+   // problem can be modified meanwhile. It is not compressed before all tasks
+   // finished, hence their reductions refer to the same rows and columns.
+   Problem<REAL> snapshot = problem;
+   PostsolveStorage<REAL> snapshotPostsolve( snapshot.getNRows(),
+                                             snapshot.getNCols() );
+   Statistics snapshotStats;
+   ProblemUpdate<REAL> snapshotUpdate( snapshot, snapshotPostsolve,
+                                       snapshotStats, presolveOptions, num,
+                                       msg );
+   snapshotUpdate.copyTrackingOf( probUpdate );
+   const int snapshotEpoch = probUpdate.getChangeEpoch();
+
+   // applies the reductions of the marked presolvers in the same way as the
+   // reductions of a round, returns false if the problem became infeasible
+   Vec<uint8_t> marked( presolvers.size(), 0 );
+   auto apply_marked = [this, &probUpdate, &marked]() {
+      int npresolvers = static_cast<int>( presolvers.size() );
+      int last = -1;
+      probUpdate.setPostponeSubstitutions( true );
+      postponedReductionToPresolver.push_back( 0 );
+      for( int i = 0; i != npresolvers; ++i )
+      {
+         if( marked[i] )
+         {
+            apply_reduction_of_solver( probUpdate, i );
+            last = i;
+         }
+         postponedReductionToPresolver.push_back( postponedReductions.size() );
+      }
+
+      bool feasible = true;
+      for( int i = 0; i != npresolvers; ++i )
+      {
+         if( marked[i] && results[i] == PresolveStatus::kInfeasible )
+            feasible = false;
+      }
+
+      if( feasible )
+      {
+         probUpdate.flushChangedCoeffs();
+         applyPostponed( probUpdate );
+         if( probUpdate.flush( true ) == PresolveStatus::kInfeasible )
+         {
+            results[last] = PresolveStatus::kInfeasible;
+            feasible = false;
+         }
+         else
+            probUpdate.clearStates();
+      }
+      else
+      {
+         postponedReductions.clear();
+         postponedReductionToPresolver.clear();
+      }
+
+      for( int i = 0; i != npresolvers; ++i )
+      {
+         if( marked[i] )
+            reductions[i].clear();
+      }
+      std::fill( marked.begin(), marked.end(), 0 );
+      return feasible;
+   };
+
+   tbb::concurrent_queue<int> finished;
+   std::atomic_bool applying{ false };
+   bool infeasible = false;
+   Vec<int> causes( presolvers.size(), -1 );
+   Vec<uint8_t> fast_reduced( presolvers.size(), 0 );
+
+   // applies the reductions of the finished presolvers and resubmits the
+   // fast presolvers on the updated problem until they find nothing or
+   // another presolver finished. Only one thread applies at a time, a
+   // thread that finds the applier busy leaves its result in the queue.
+   auto apply_finished = [&]() {
+      while( !finished.empty() )
+      {
+         bool expected = false;
+         if( !applying.compare_exchange_strong( expected, true ) )
+            return;
+
+         bool applied = false;
+         int p;
+         while( finished.try_pop( p ) )
+         {
+            if( results[p] == PresolveStatus::kInfeasible && causes[p] != -1 )
+               probUpdate.getCertificateInterface()->setInfeasibleCause(
+                   causes[p] );
+            if( is_status_infeasible_or_unbounded( results[p] ) )
+               infeasible = true;
+            else if( results[p] == PresolveStatus::kReduced )
+            {
+               marked[p] = true;
+               applied = true;
+            }
+         }
+
+         // the reductions found on the copy must not lock rows or columns
+         // that were modified since the copy was taken
+         if( !infeasible && applied )
+         {
+            probUpdate.setConflictEpoch( snapshotEpoch );
+            infeasible = !apply_marked();
+            probUpdate.setConflictEpoch( -1 );
+         }
+
+         while( !infeasible && applied && finished.empty() &&
+                !is_time_exceeded( timer ) &&
+                probUpdate.getNActiveCols() != 0 &&
+                probUpdate.getNActiveRows() != 0 )
+         {
+            bool fast_sequential = false;
+            run_presolvers( problem, fast_presolvers, probUpdate,
+                            fast_sequential, timer );
+            probUpdate.clearChangeInfo();
+
+            applied = false;
+            for( int i = fast_presolvers.first; i != fast_presolvers.second;
+                 ++i )
+            {
+               if( is_status_infeasible_or_unbounded( results[i] ) )
+                  infeasible = true;
+               else if( results[i] == PresolveStatus::kReduced )
+               {
+                  marked[i] = true;
+                  fast_reduced[i] = true;
+                  applied = true;
+               }
+            }
+
+            if( !infeasible && applied )
+               infeasible = !apply_marked();
+
+            if( !infeasible )
+            {
+               for( int i = fast_presolvers.first;
+                    i != fast_presolvers.second; ++i )
+                  results[i] = PresolveStatus::kUnchanged;
+            }
+         }
+
+         applying.store( false );
+      }
+   };
+
+   tbb::task_group tasks;
+   for( int i = presolver_2_run.first; i != presolver_2_run.second; ++i )
+   {
+      tasks.run( [this, i, &snapshot, &snapshotUpdate, &finished, &causes,
+                  &timer, &apply_finished]() {
+         results[i] = presolvers[i]->run( snapshot, snapshotUpdate, num,
+                                          reductions[i], timer, causes[i] );
+         finished.push( i );
+         apply_finished();
+      } );
+   }
+   tasks.wait();
+   apply_finished();
+
+   if( !infeasible )
+   {
+      for( int i = fast_presolvers.first; i != fast_presolvers.second; ++i )
+      {
+         if( fast_reduced[i] )
+            results[i] = PresolveStatus::kReduced;
+      }
+   }
+}
+#endif
+
 template <typename REAL>
 void
 Presolve<REAL>::apply_result_sequential( int index_presolver,
@@ -1168,6 +1407,14 @@ void
 Presolve<REAL>::apply_reduction_of_solver( ProblemUpdate<REAL>& probUpdate,
                                            size_t index_presolver )
 {
+   Vec<std::pair<int, int>>& implications =
+       presolvers[index_presolver]->getFoundImplications();
+   if( !implications.empty() )
+   {
+      probUpdate.getImplications().addImplications( implications );
+      implications.clear();
+   }
+
    if( results[index_presolver] != PresolveStatus::kReduced )
       return;
 
@@ -1458,6 +1705,17 @@ Presolve<REAL>::printPresolversStats()
       presolvers[i]->printStats( msg, presolverStats[i] );
    }
 
+#ifdef PAPILO_USE_ARENA_ALLOCATOR
+   ArenaStatistics arenaStats = Arena::getStatistics();
+   msg.info( "\n {:>18} {:>12} {:>18} \n", "arena subsystem", "allocations",
+             "allocated(MB)" );
+   for( const auto& subsystem : arenaStats.subsystems )
+      msg.info( " {:>18} {:>12} {:>18.1f}\n", subsystem.name,
+                subsystem.allocations, subsystem.bytes / 1048576.0 );
+   msg.info( " {:>18} {:>12} {:>18.1f}\n", "reserved", "",
+             arenaStats.reservedbytes / 1048576.0 );
+#endif
+
    msg.info( "\n" );
 }
 
@@ -1539,6 +1797,420 @@ Presolve<REAL>::are_only_dual_postsolve_presolvers_enabled()
    return true;
 }
 
+
+/// splits the problem into its disconnected components and presolves groups
+/// of them as separate problems in parallel. Components are grouped in the
+/// order of their size until a group has componentsminnnz nonzeros. The
+/// reduced problems of the groups are joined into the reduced problem and
+/// their postsolve storages are appended to the one of the result. Returns
+/// false if the problem is not split.
+template <typename REAL>
+bool
+Presolve<REAL>::presolve_components( Problem<REAL>& problem,
+                                     ProblemUpdate<REAL>& probUpdate,
+                                     PresolveResult<REAL>& result,
+                                     const Timer& timer )
+{
+   // the dual postsolve and the certificate refer to the whole problem
+   if( result.postsolve.postsolveType == PostsolveType::kFull ||
+       presolveOptions.verification_with_VeriPB ||
+       probUpdate.getNActiveCols() == 0 || probUpdate.getNActiveRows() == 0 )
+      return false;
+
+   // the groups are presolved with the default presolvers, other presolvers
+   // can not be copied
+   Presolve<REAL> defaultPresolve;
+   defaultPresolve.addDefaultPresolvers();
+   for( const std::unique_ptr<PresolveMethod<REAL>>& presolver : presolvers )
+   {
+      if( std::none_of( defaultPresolve.presolvers.begin(),
+                        defaultPresolve.presolvers.end(),
+                        [&]( const std::unique_ptr<PresolveMethod<REAL>>& p ) {
+                           return p->getName() == presolver->getName();
+                        } ) )
+         return false;
+   }
+
+   // consecutive components are joined into groups of at least
+   // componentsminnnz nonzeros, the last group takes the remaining components
+   auto groupComponents = [this]( const Vec<ComponentInfo>& compInfo ) {
+      const int ncomponents = static_cast<int>( compInfo.size() );
+      Vec<int> groupstart{ 0 };
+      int64_t groupnnz = 0;
+
+      for( int i = 0; i < ncomponents - 1; ++i )
+      {
+         groupnnz += compInfo[i].nnonz;
+         if( groupnnz >= presolveOptions.componentsminnnz )
+         {
+            groupstart.push_back( i + 1 );
+            groupnnz = 0;
+         }
+      }
+      groupstart.push_back( ncomponents );
+
+      return groupstart;
+   };
+
+   // the decision is taken on the active part of the problem, so that a
+   // problem that is not split is not compressed
+   if( groupComponents( Components::getActiveComponentInfo( problem ) )
+           .size() <= 2 )
+      return false;
+
+   probUpdate.compress( true );
+
+   Components components;
+   int ncomponents = components.detectComponents( problem );
+   const Vec<ComponentInfo>& compInfo = components.getComponentInfo();
+   Vec<int> groupstart = groupComponents( compInfo );
+
+   const int ngroups = static_cast<int>( groupstart.size() ) - 1;
+   assert( ncomponents > 1 && ngroups > 1 );
+
+   msg.info( "presolving {} disconnected components in {} groups\n",
+             ncomponents, ngroups );
+
+   // the groups use the parameters of this presolve
+   Vec<std::pair<String, String>> settings;
+   {
+      String params;
+      getParameters().printParams( std::back_inserter( params ) );
+      std::istringstream input( params );
+
+      for( String line; std::getline( input, line ); )
+      {
+         std::size_t pos = line.find( " = " );
+         if( line.empty() || line[0] == '#' || pos == String::npos )
+            continue;
+
+         settings.emplace_back( line.substr( 0, pos ), line.substr( pos + 3 ) );
+      }
+   }
+
+   Vec<Vec<int>> groupcols( ngroups );
+   Vec<Vec<int>> grouprows( ngroups );
+   Vec<Problem<REAL>> subproblems( ngroups );
+   Vec<PresolveResult<REAL>> subresults( ngroups );
+   Vec<Statistics> substats( ngroups );
+   // every group writes the entries of its own columns
+   Vec<int> col2local( problem.getNCols() );
+
+   auto presolveGroup = [&]( int g ) {
+      Vec<int>& cols = groupcols[g];
+      Vec<int>& rows = grouprows[g];
+
+      for( int i = groupstart[g]; i != groupstart[g + 1]; ++i )
+      {
+         int c = compInfo[i].componentid;
+         const int* compcols = components.getComponentsCols( c );
+         const int* comprows = components.getComponentsRows( c );
+         cols.insert( cols.end(), compcols,
+                      compcols + components.getComponentsNumCols( c ) );
+         rows.insert( rows.end(), comprows,
+                      comprows + components.getComponentsNumRows( c ) );
+      }
+
+      pdqsort( cols.begin(), cols.end() );
+      pdqsort( rows.begin(), rows.end() );
+
+      for( int j = 0; j != (int) cols.size(); ++j )
+         col2local[cols[j]] = j;
+
+      subproblems[g] = extract_subproblem( problem, cols, rows, col2local );
+
+      Presolve<REAL> subpresolve;
+      subpresolve.addDefaultPresolvers();
+      subpresolve.presolvers.erase(
+          std::remove_if(
+              subpresolve.presolvers.begin(), subpresolve.presolvers.end(),
+              [&]( const std::unique_ptr<PresolveMethod<REAL>>& p ) {
+                 return std::none_of(
+                     presolvers.begin(), presolvers.end(),
+                     [&]( const std::unique_ptr<PresolveMethod<REAL>>& q ) {
+                        return p->getName() == q->getName();
+                     } );
+              } ),
+          subpresolve.presolvers.end() );
+
+      ParameterSet paramSet = subpresolve.getParameters();
+      for( const std::pair<String, String>& setting : settings )
+         paramSet.parseParameter( setting.first.c_str(),
+                                  setting.second.c_str() );
+
+      PresolveOptions& options = subpresolve.getPresolveOptions();
+      options.componentsminnnz = -1;
+      options.componentsmaxint = -1;
+      options.threads = 1;
+      if( options.tlim != std::numeric_limits<double>::max() )
+         options.tlim = std::max( options.tlim - timer.getTime(), 0.0 );
+      subpresolve.setVerbosityLevel( VerbosityLevel::kQuiet );
+
+      subresults[g] = subpresolve.apply( subproblems[g], false );
+      substats[g] = subpresolve.getStatistics();
+   };
+
+#ifdef PAPILO_TBB
+   // the groups are sorted by size, start with the largest ones
+   tbb::parallel_for(
+       tbb::blocked_range<int>( 0, ngroups, 1 ),
+       [&]( const tbb::blocked_range<int>& r ) {
+          for( int i = r.begin(); i != r.end(); ++i )
+             presolveGroup( ngroups - 1 - i );
+       },
+       tbb::simple_partitioner() );
+#else
+   for( int i = 0; i != ngroups; ++i )
+      presolveGroup( ngroups - 1 - i );
+#endif
+
+   int nrounds = 0;
+   for( int g = 0; g != ngroups; ++g )
+   {
+      PresolveStatus status = subresults[g].status;
+      if( status == PresolveStatus::kInfeasible ||
+          ( status == PresolveStatus::kUnbndOrInfeas &&
+            result.status != PresolveStatus::kInfeasible ) ||
+          ( status == PresolveStatus::kUnbounded &&
+            !is_status_infeasible_or_unbounded( result.status ) ) )
+         result.status = status;
+
+      stats.ntsxapplied += substats[g].ntsxapplied;
+      stats.ntsxconflicts += substats[g].ntsxconflicts;
+      stats.nboundchgs += substats[g].nboundchgs;
+      stats.nsidechgs += substats[g].nsidechgs;
+      stats.ncoefchgs += substats[g].ncoefchgs;
+      stats.ndeletedcols += substats[g].ndeletedcols;
+      stats.ndeletedrows += substats[g].ndeletedrows;
+      nrounds = std::max( nrounds, substats[g].nrounds );
+   }
+   stats.nrounds += nrounds;
+
+   if( is_status_infeasible_or_unbounded( result.status ) )
+      return true;
+
+   // append the postsolve storages of the groups, their original columns and
+   // rows are columns and rows of the current problem
+   Vec<int> origcol_mapping;
+   Vec<int> origrow_mapping;
+   Vec<int> colmapping;
+   Vec<int> rowmapping;
+   ImplicationStore implications;
+   {
+      int ncols = 0;
+      for( const Problem<REAL>& subproblem : subproblems )
+         ncols += subproblem.getNCols();
+      implications = ImplicationStore( ncols );
+   }
+
+   int coloffset = 0;
+   for( int g = 0; g != ngroups; ++g )
+   {
+      const PostsolveStorage<REAL>& subpostsolve = subresults[g].postsolve;
+
+      colmapping.resize( groupcols[g].size() );
+      for( int j = 0; j != (int) groupcols[g].size(); ++j )
+         colmapping[j] = result.postsolve.origcol_mapping[groupcols[g][j]];
+
+      rowmapping.resize( grouprows[g].size() );
+      for( int j = 0; j != (int) grouprows[g].size(); ++j )
+         rowmapping[j] = result.postsolve.origrow_mapping[grouprows[g][j]];
+
+      for( int col : subpostsolve.origcol_mapping )
+         origcol_mapping.push_back( colmapping[col] );
+      for( int row : subpostsolve.origrow_mapping )
+         origrow_mapping.push_back( rowmapping[row] );
+
+      result.postsolve.append( subpostsolve, colmapping, rowmapping );
+
+      const ImplicationStore& subimplications = subresults[g].implications;
+      if( !subimplications.empty() )
+      {
+         int shift = 2 * coloffset;
+         Vec<std::pair<int, int>> shifted( subimplications.getImplications() );
+         for( std::pair<int, int>& implication : shifted )
+         {
+            implication.first += shift;
+            implication.second += shift;
+         }
+         implications.addImplications( shifted );
+
+         Vec<int> literals( subimplications.getCliqueLiterals() );
+         for( int& literal : literals )
+            literal += shift;
+         implications.addCliques( subimplications.getCliqueStart(), literals );
+      }
+
+      coloffset += subproblems[g].getNCols();
+   }
+
+   result.postsolve.origcol_mapping = std::move( origcol_mapping );
+   result.postsolve.origrow_mapping = std::move( origrow_mapping );
+   problem = join_problems( problem, subproblems );
+   result.implications = std::move( implications );
+
+   logStatus( probUpdate, result.postsolve );
+   result.status = PresolveStatus::kReduced;
+
+   return true;
+}
+
+template <typename REAL>
+Problem<REAL>
+Presolve<REAL>::extract_subproblem( const Problem<REAL>& problem,
+                                    const Vec<int>& cols, const Vec<int>& rows,
+                                    const Vec<int>& col2local )
+{
+   const int ncols = static_cast<int>( cols.size() );
+   const int nrows = static_cast<int>( rows.size() );
+   const ConstraintMatrix<REAL>& consMatrix = problem.getConstraintMatrix();
+   const Vec<String>& colnames = problem.getVariableNames();
+   const Vec<String>& rownames = problem.getConstraintNames();
+
+   Vec<REAL> obj( ncols );
+   Vec<REAL> lbs( ncols );
+   Vec<REAL> ubs( ncols );
+   Vec<ColFlags> cflags( ncols );
+   Vec<String> subcolnames;
+
+   for( int j = 0; j != ncols; ++j )
+   {
+      obj[j] = problem.getObjective().coefficients[cols[j]];
+      lbs[j] = problem.getLowerBounds()[cols[j]];
+      ubs[j] = problem.getUpperBounds()[cols[j]];
+      cflags[j] = problem.getColFlags()[cols[j]];
+      if( !colnames.empty() )
+         subcolnames.push_back( colnames[cols[j]] );
+   }
+
+   Vec<REAL> lhs( nrows );
+   Vec<REAL> rhs( nrows );
+   Vec<RowFlags> rflags( nrows );
+   Vec<String> subrownames;
+   Vec<Triplet<REAL>> entries;
+
+   for( int i = 0; i != nrows; ++i )
+   {
+      lhs[i] = consMatrix.getLeftHandSides()[rows[i]];
+      rhs[i] = consMatrix.getRightHandSides()[rows[i]];
+      rflags[i] = consMatrix.getRowFlags()[rows[i]];
+      if( !rownames.empty() )
+         subrownames.push_back( rownames[rows[i]] );
+
+      auto rowvec = consMatrix.getRowCoefficients( rows[i] );
+      for( int k = 0; k != rowvec.getLength(); ++k )
+         entries.emplace_back( i, col2local[rowvec.getIndices()[k]],
+                               rowvec.getValues()[k] );
+   }
+
+   Problem<REAL> subproblem;
+   subproblem.setName( problem.getName() );
+   subproblem.setObjective( std::move( obj ) );
+   subproblem.setVariableDomains( std::move( lbs ), std::move( ubs ),
+                                  std::move( cflags ) );
+   subproblem.setConstraintMatrix(
+       SparseStorage<REAL>( std::move( entries ), nrows, ncols ),
+       std::move( lhs ), std::move( rhs ), std::move( rflags ) );
+   subproblem.setVariableNames( std::move( subcolnames ) );
+   subproblem.setConstraintNames( std::move( subrownames ) );
+
+   for( ProblemFlag flag : { ProblemFlag::kMixedInteger, ProblemFlag::kInteger,
+                             ProblemFlag::kLinear, ProblemFlag::kBinary } )
+   {
+      if( problem.test_problem_type( flag ) )
+         subproblem.set_problem_type( flag );
+   }
+
+   return subproblem;
+}
+
+/// concatenates the columns and rows of the subproblems, the name, the
+/// objective offset and the type are taken from the problem
+template <typename REAL>
+Problem<REAL>
+Presolve<REAL>::join_problems( const Problem<REAL>& problem,
+                               const Vec<Problem<REAL>>& subproblems )
+{
+   Vec<REAL> obj;
+   Vec<REAL> lbs;
+   Vec<REAL> ubs;
+   Vec<ColFlags> cflags;
+   Vec<String> colnames;
+   Vec<REAL> lhs;
+   Vec<REAL> rhs;
+   Vec<RowFlags> rflags;
+   Vec<String> rownames;
+   Vec<Triplet<REAL>> entries;
+   REAL offset = problem.getObjective().offset;
+   SymmetryStorage symmetries;
+
+   for( const Problem<REAL>& subproblem : subproblems )
+   {
+      const int coloffset = static_cast<int>( obj.size() );
+      const int rowoffset = static_cast<int>( lhs.size() );
+      const ConstraintMatrix<REAL>& consMatrix =
+          subproblem.getConstraintMatrix();
+
+      auto append = []( auto& target, const auto& source ) {
+         target.insert( target.end(), source.begin(), source.end() );
+      };
+
+      append( obj, subproblem.getObjective().coefficients );
+      append( lbs, subproblem.getLowerBounds() );
+      append( ubs, subproblem.getUpperBounds() );
+      append( cflags, subproblem.getColFlags() );
+      append( colnames, subproblem.getVariableNames() );
+      append( lhs, consMatrix.getLeftHandSides() );
+      append( rhs, consMatrix.getRightHandSides() );
+      append( rflags, consMatrix.getRowFlags() );
+      append( rownames, subproblem.getConstraintNames() );
+      offset += subproblem.getObjective().offset;
+
+      for( int i = 0; i != subproblem.getNRows(); ++i )
+      {
+         auto rowvec = consMatrix.getRowCoefficients( i );
+         for( int k = 0; k != rowvec.getLength(); ++k )
+            entries.emplace_back( rowoffset + i,
+                                  coloffset + rowvec.getIndices()[k],
+                                  rowvec.getValues()[k] );
+      }
+
+      for( const Symmetry& symmetry : subproblem.getSymmetries().symmetries )
+         symmetries.addSymmetry( coloffset + symmetry.getDominatingCol(),
+                                 coloffset + symmetry.getDominatedCol(),
+                                 symmetry.getSymmetryType() );
+   }
+
+   const int ncols = static_cast<int>( obj.size() );
+   const int nrows = static_cast<int>( lhs.size() );
+
+   Problem<REAL> joined;
+   joined.setName( problem.getName() );
+   joined.setObjective( std::move( obj ), offset );
+   joined.setVariableDomains( std::move( lbs ), std::move( ubs ),
+                              std::move( cflags ) );
+   joined.setConstraintMatrix(
+       SparseStorage<REAL>( std::move( entries ), nrows, ncols ),
+       std::move( lhs ), std::move( rhs ), std::move( rflags ) );
+   if( (int) colnames.size() == ncols )
+      joined.setVariableNames( std::move( colnames ) );
+   if( (int) rownames.size() == nrows )
+      joined.setConstraintNames( std::move( rownames ) );
+   joined.getSymmetries() = std::move( symmetries );
+
+   for( ProblemFlag flag : { ProblemFlag::kMixedInteger, ProblemFlag::kInteger,
+                             ProblemFlag::kLinear, ProblemFlag::kBinary } )
+   {
+      if( problem.test_problem_type( flag ) )
+         joined.set_problem_type( flag );
+   }
+
+   joined.recomputeLocks();
+   joined.recomputeAllActivities();
+
+   return joined;
+}
+
 } // namespace papilo
 
 #endif
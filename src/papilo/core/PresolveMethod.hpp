@@ -40,6 +40,7 @@
 #endif
 
 #include "papilo/verification/ArgumentType.hpp"
+#include <algorithm>
 #include <bitset>
 
 
@@ -101,6 +102,8 @@ class PresolveMethod
       enabled = true;
       skip = 0;
       nconsecutiveUnsuccessCall = 0;
+      previous_call_epoch = -1;
+      current_call_epoch = -1;
    }
 
    virtual ~PresolveMethod() = default;
@@ -158,10 +161,16 @@ class PresolveMethod
 
       ++ncalls;
 
+      previous_call_epoch = current_call_epoch;
+      current_call_epoch = problemUpdate.getChangeEpoch();
+
 #ifdef PAPILO_TBB
       auto start = tbb::tick_count::now();
 #else
       auto start = std::chrono::steady_clock::now();
+#endif
+#ifdef PAPILO_USE_ARENA_ALLOCATOR
+      ArenaScope arenaScope( name );
 #endif
       PresolveStatus result =
           execute( problem, problemUpdate, num, reductions, timer, cause );
@@ -249,6 +258,24 @@ class PresolveMethod
       return ncalls;
    }
 
+   /// implications between binary columns (see ImplicationStore) that were
+   /// found in the last call, they are added to the implication store of the
+   /// ProblemUpdate when the reductions are applied
+   Vec<std::pair<int, int>>&
+   getFoundImplications()
+   {
+      return found_implications;
+   }
+
+   /// forget the previous calls, so that the next call considers all rows
+   /// and columns; needed before presolving another problem
+   void
+   resetChangeTracking()
+   {
+      previous_call_epoch = -1;
+      current_call_epoch = -1;
+   }
+
    void
    setDelayed( bool value )
    {
@@ -312,6 +339,8 @@ class PresolveMethod
 
 
  protected:
+   Vec<std::pair<int, int>> found_implications;
+
    /// execute member function for a presolve method gets the constant problem
    /// and can communicate reductions via the given reductions object
    virtual PresolveStatus
@@ -416,6 +445,38 @@ class PresolveMethod
       return true;
    }
 
+   /// stores the rows that changed since the previous call of this presolver
+   /// in increasing order; returns false if there was no previous call, then
+   /// all rows need to be considered
+   bool
+   getChangedRows( const ProblemUpdate<REAL>& problemUpdate,
+                   Vec<int>& rows ) const
+   {
+      if( previous_call_epoch < 0 )
+         return false;
+
+      rows.clear();
+      problemUpdate.getChangedRowsSince( previous_call_epoch, rows );
+      std::sort( rows.begin(), rows.end() );
+      return true;
+   }
+
+   /// stores the columns that changed or have an entry in a row that changed
+   /// since the previous call of this presolver in increasing order; returns
+   /// false if there was no previous call, then all columns need to be
+   /// considered
+   bool
+   getAffectedCols( const ProblemUpdate<REAL>& problemUpdate,
+                    Vec<int>& cols ) const
+   {
+      if( previous_call_epoch < 0 )
+         return false;
+
+      cols.clear();
+      problemUpdate.getAffectedColsSince( previous_call_epoch, cols );
+      return true;
+   }
+
    void
    skipRounds( unsigned int nrounds )
    {
@@ -454,6 +515,10 @@ class PresolveMethod
    unsigned int nsuccessCall;
    unsigned int nconsecutiveUnsuccessCall;
    unsigned int skip;
+   /// change epochs of the ProblemUpdate at the start of the previous and of
+   /// the current call, -1 if there was no such call
+   int previous_call_epoch;
+   int current_call_epoch;
    };
 
 } // namespace papilo
@@ -33,6 +33,8 @@ struct PresolveOptions
 {
    bool apply_results_immediately_if_run_sequentially = true;
 
+   bool async_exhaustive_rounds = false;
+
    bool boundrelax = false;
 
    bool calculate_basis_for_dual = true;
@@ -58,8 +60,12 @@ struct PresolveOptions
    bool validation_after_every_postsolving_step = false;
 
 
+   int activityupdates = 100;
+
    int componentsmaxint = 0;
 
+   int componentsminnnz = -1;
+
    int detectlindep = 1;
 
    int dualreds = 2;
@@ -76,6 +82,8 @@ struct PresolveOptions
 
    int veripb_propagation_option = 0;
 
+   int veripb_compression = 0;
+
    unsigned int randomseed = 0;
 
 
@@ -148,6 +156,12 @@ struct PresolveOptions
           "maximum number of integral variables for trying to solve "
           "disconnected components of the problem in presolving (-1: disabled)",
           componentsmaxint, -1 );
+      paramSet.addParameter(
+          "presolve.componentsminnnz",
+          "presolve disconnected components as separate problems in parallel, "
+          "smaller components are grouped until they have this many nonzeros "
+          "(-1: disabled)",
+          componentsminnnz, -1 );
       paramSet.addParameter( "presolve.compressfac",
                              "compress the problem if fewer than compressfac "
                              "times the number of rows or columns are active",
@@ -167,6 +181,11 @@ struct PresolveOptions
                              "absolute bound value that is considered too huge "
                              "for activitity based calculations",
                              hugeval, 0.0 );
+      paramSet.addParameter( "numerics.activityupdates",
+                             "number of incremental updates of a row activity "
+                             "after which it is computed from the row again "
+                             "(0: never)",
+                             activityupdates, 0 );
       paramSet.addParameter(
           "presolve.weakenlpvarbounds",
           "weaken bounds obtained by constraint propagation by this factor of "
@@ -184,6 +203,12 @@ struct PresolveOptions
           "# if only one thread (presolve.threads = 1) is used, apply the "
           "reductions immediately afterwards",
           apply_results_immediately_if_run_sequentially );
+      paramSet.addParameter(
+          "presolve.async_exhaustive_rounds",
+          "# run the exhaustive presolvers as tasks and apply their reductions "
+          "as soon as they finish while resubmitting the fast presolvers "
+          "(requires TBB, the result depends on the timing of the threads)",
+          async_exhaustive_rounds );
       paramSet.addParameter(
           "propagation.parallel",
           "#execute loop over rows in constraintpropagation in parallel",
@@ -236,6 +261,10 @@ struct PresolveOptions
           "veripb.verify_propagation",
           "how to log the proof of verification? 0: reverse unit propagation, 1: Addition in polish notation",
           veripb_propagation_option, 0.0, 1.0 );
+      paramSet.addParameter(
+          "veripb.compression",
+          "compression of the VeriPB proof file? 0: none, 1: gzip (.pbp.gz), 2: zstd (.pbp.zst)",
+          veripb_compression, 0.0, 2.0 );
    }
 
    bool
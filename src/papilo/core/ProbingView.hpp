@@ -23,9 +23,12 @@
 #ifndef _PAPILO_CORE_PROBING_VIEW_HPP_
 #define _PAPILO_CORE_PROBING_VIEW_HPP_
 
+#include "papilo/core/ImplicationStore.hpp"
 #include "papilo/core/Problem.hpp"
 #include "papilo/core/SingleRow.hpp"
 #include "papilo/io/Message.hpp"
+#include "papilo/misc/Hash.hpp"
+#include <deque>
 #include <memory>
 #include "papilo/misc/MultiPrecision.hpp"
 #include "papilo/misc/Vec.hpp"
@@ -66,6 +69,63 @@ struct ProbingSubstitution
    }
 };
 
+/// values of a vector of the problem as seen by a ProbingView, only the
+/// values that are changed during probing are stored and all other values are
+/// read from the problem. The changed values are kept in a deque so that
+/// references to them stay valid when further values are changed.
+template <typename T>
+class ProbingOverlay
+{
+ public:
+   explicit ProbingOverlay( const Vec<T>& base_ ) : base( &base_ ) {}
+
+   const T&
+   operator[]( int i ) const
+   {
+      auto it = positions.find( i );
+      return it == positions.end() ? ( *base )[i] : changed[it->second];
+   }
+
+   bool
+   isChanged( int i ) const
+   {
+      return positions.find( i ) != positions.end();
+   }
+
+   /// returns the value for changing it, it is copied from the problem when
+   /// it is changed for the first time
+   T&
+   modify( int i )
+   {
+      auto insres = positions.emplace( i, static_cast<int>( changed.size() ) );
+      if( insres.second )
+         changed.push_back( ( *base )[i] );
+      return changed[insres.first->second];
+   }
+
+   int
+   getNChanged() const
+   {
+      return static_cast<int>( changed.size() );
+   }
+
+   /// forgets all changes so that the values of the problem are seen again
+   void
+   clear()
+   {
+      positions.clear();
+      changed.clear();
+   }
+
+ private:
+   const Vec<T>* base;
+   HashMap<int, int> positions;
+   std::deque<T> changed;
+};
+
+/// view of the domains and row activities of a problem for probing, only the
+/// domains and activities changed by the propagation of the probed value are
+/// stored so that the memory does not depend on the size of the problem
 template <typename REAL>
 class ProbingView
 {
@@ -110,6 +170,16 @@ class ProbingView
    void
    changeUb( int col, REAL newub );
 
+   /// fixes the binary columns that are forced by the probed value according
+   /// to the implication store, must be called before propagateDomains()
+   void
+   applyStoredImplications( const ImplicationStore& implications );
+
+   /// remembers the binary columns fixed by propagating the probed value as
+   /// implications of the probed value
+   void
+   storeBinaryImplications();
+
    void
    storeImplications();
 
@@ -156,25 +226,31 @@ class ProbingView
       return substitutions;
    }
 
+   const Vec<std::pair<int, int>>&
+   getProbingImplications() const
+   {
+      return binaryImplications;
+   }
+
    int64_t
    getAmountOfWork() const
    {
       return amountofwork;
    }
 
-   const Vec<REAL>&
+   const ProbingOverlay<REAL>&
    getProbingLowerBounds() const
    {
       return probing_lower_bounds;
    }
 
-   const Vec<REAL>&
+   const ProbingOverlay<REAL>&
    getProbingUpperBounds() const
    {
       return probing_upper_bounds;
    }
 
-   const Vec<ColFlags>&
+   const ProbingOverlay<ColFlags>&
    getProbingDomainFlags() const
    {
       return probing_domain_flags;
@@ -186,6 +262,7 @@ class ProbingView
       amountofwork = 0;
       boundChanges.clear();
       substitutions.clear();
+      binaryImplications.clear();
    }
 
  private:
@@ -199,10 +276,10 @@ class ProbingView
    Vec<int> changed_lbs;
    Vec<int> changed_ubs;
    Vec<int> changed_activities;
-   Vec<REAL> probing_lower_bounds;
-   Vec<REAL> probing_upper_bounds;
-   Vec<ColFlags> probing_domain_flags;
-   Vec<RowActivity<REAL>> probing_activities;
+   ProbingOverlay<REAL> probing_lower_bounds;
+   ProbingOverlay<REAL> probing_upper_bounds;
+   ProbingOverlay<ColFlags> probing_domain_flags;
+   ProbingOverlay<RowActivity<REAL>> probing_activities;
 
    Vec<int> prop_activities;
    Vec<int> next_prop_activities;
@@ -219,8 +296,15 @@ class ProbingView
    // results of probing and statistics
    Vec<ProbingBoundChg<REAL>> boundChanges;
    Vec<ProbingSubstitution<REAL>> substitutions;
+   /// implications between literals of binary columns, see ImplicationStore
+   Vec<std::pair<int, int>> binaryImplications;
 
    int64_t amountofwork;
+
+   template <typename ACTIVITYCHANGE>
+   void
+   updateActivities( int col, BoundChange type, REAL oldbound, REAL newbound,
+                     bool oldbound_inf, ACTIVITYCHANGE&& activityChange );
 };
 
 #ifdef PAPILO_USE_EXTERN_TEMPLATES
@@ -254,64 +338,22 @@ ProbingView<REAL>::reset()
 {
    const Vec<int>& rowsize = problem.getConstraintMatrix().getRowSizes();
 
-   const auto& orig_lbs = problem.getLowerBounds();
-   for( int i : changed_lbs )
-   {
-      if( i < 0 )
-      {
-         int c = -i - 1;
-         assert( !probing_domain_flags[c].test( ColFlag::kLbUseless ) &&
-                 problem.getColFlags()[c].test( ColFlag::kLbUseless ) );
-         probing_domain_flags[c].set( ColFlag::kLbUseless );
-#ifndef NDEBUG
-         probing_lower_bounds[c] = orig_lbs[c];
-#endif
-      }
-      else
-         probing_lower_bounds[i] = orig_lbs[i];
-   }
-   changed_lbs.clear();
+   assert( (int) changed_lbs.size() == probing_lower_bounds.getNChanged() );
+   assert( (int) changed_ubs.size() == probing_upper_bounds.getNChanged() );
+   assert( (int) changed_activities.size() ==
+           probing_activities.getNChanged() );
 
-   const auto& orig_ubs = problem.getUpperBounds();
-   for( int i : changed_ubs )
-   {
-      if( i < 0 )
-      {
-         int c = -i - 1;
-         assert( !probing_domain_flags[c].test( ColFlag::kUbUseless ) &&
-                 problem.getColFlags()[c].test( ColFlag::kUbUseless ) );
-         probing_domain_flags[c].set( ColFlag::kUbUseless );
-#ifndef NDEBUG
-         probing_upper_bounds[c] = orig_ubs[c];
-#endif
-      }
-      else
-         probing_upper_bounds[i] = orig_ubs[i];
-   }
+   probing_lower_bounds.clear();
+   probing_upper_bounds.clear();
+   probing_domain_flags.clear();
+   changed_lbs.clear();
    changed_ubs.clear();
 
-   const auto& orig_activities = problem.getRowActivities();
    for( int i : changed_activities )
-   {
       amountofwork += rowsize[i];
-      probing_activities[i] = orig_activities[i];
-   }
+   probing_activities.clear();
    changed_activities.clear();
 
-   // reset should result in original domains and activities
-   assert( std::equal( orig_lbs.begin(), orig_lbs.end(),
-                       probing_lower_bounds.begin() ) );
-   assert( std::equal( orig_ubs.begin(), orig_ubs.end(),
-                       probing_upper_bounds.begin() ) );
-   assert( std::equal(
-       orig_activities.begin(), orig_activities.end(),
-       probing_activities.begin(),
-       []( const RowActivity<REAL>& a, const RowActivity<REAL>& b ) {
-          return a.ninfmax == b.ninfmax && a.ninfmin == b.ninfmin &&
-                 a.min == b.min && a.max == b.max &&
-                 a.lastchange == b.lastchange;
-       } ) );
-
    round = -2;
    prop_activities.clear();
    next_prop_activities.clear();
@@ -403,10 +445,6 @@ template <typename REAL>
 void
 ProbingView<REAL>::changeLb( int col, REAL newlb )
 {
-   const auto& consMatrix = problem.getConstraintMatrix();
-   auto colvec = consMatrix.getColumnCoefficients( col );
-   const auto& orig_lbs = problem.getLowerBounds();
-
    // bound must be tighter than current domains
    bool lbinf = probing_domain_flags[col].test( ColFlag::kLbUseless );
    assert( lbinf || probing_lower_bounds[col] != newlb );
@@ -418,37 +456,28 @@ ProbingView<REAL>::changeLb( int col, REAL newlb )
    {
       // bound was not altered yet, store the negative (index + 1) to
       // indicate that the infinity flag was altered
-      probing_domain_flags[col].unset( ColFlag::kLbUseless );
+      probing_domain_flags.modify( col ).unset( ColFlag::kLbUseless );
       changed_lbs.push_back( -col - 1 );
    }
-   else if( probing_lower_bounds[col] == orig_lbs[col] &&
-            !problem.getColFlags()[col].test( ColFlag::kLbUseless ) )
+   else if( !probing_lower_bounds.isChanged( col ) )
       // if bound was not altered yet remember it in the index vector
       changed_lbs.push_back( col );
 
-   // change the bound in the domain vector
+   // change the bound in the domain overlay
    REAL oldlb = probing_lower_bounds[col];
-   probing_lower_bounds[col] = newlb;
-
-   // update the probing activities by using the column view
-   update_activities_after_boundchange(
-       colvec.getValues(), colvec.getIndices(), colvec.getLength(),
-       BoundChange::kLower, oldlb, newlb, lbinf, probing_activities,
-       [this]( ActivityChange actChange, int rowid,
-               RowActivity<REAL>& activity ) {
-          activityChanged( actChange, rowid, activity );
-       },
-       true );
+   probing_lower_bounds.modify( col ) = newlb;
+
+   updateActivities( col, BoundChange::kLower, oldlb, newlb, lbinf,
+                     [this]( ActivityChange actChange, int rowid,
+                             RowActivity<REAL>& activity ) {
+                        activityChanged( actChange, rowid, activity );
+                     } );
 }
 
 template <typename REAL>
 void
 ProbingView<REAL>::changeUb( int col, REAL newub )
 {
-   const auto& consMatrix = problem.getConstraintMatrix();
-   auto colvec = consMatrix.getColumnCoefficients( col );
-   const auto& orig_ubs = problem.getUpperBounds();
-
    // bound must be tighter than current domains
    bool ubinf = probing_domain_flags[col].test( ColFlag::kUbUseless );
    assert( ubinf || probing_upper_bounds[col] != newub );
@@ -460,27 +489,113 @@ ProbingView<REAL>::changeUb( int col, REAL newub )
    {
       // bound was not altered yet, store the negative (index + 1) to
       // indicate that the infinity flag was altered
-      probing_domain_flags[col].unset( ColFlag::kUbUseless );
+      probing_domain_flags.modify( col ).unset( ColFlag::kUbUseless );
       changed_ubs.push_back( -col - 1 );
    }
-   else if( probing_upper_bounds[col] == orig_ubs[col] &&
-            !problem.getColFlags()[col].test( ColFlag::kUbUseless ) )
+   else if( !probing_upper_bounds.isChanged( col ) )
       // if bound was not altered yet remember it in the index vector
       changed_ubs.push_back( col );
 
-   // change the bound in the domain vector
+   // change the bound in the domain overlay
    REAL oldub = probing_upper_bounds[col];
-   probing_upper_bounds[col] = newub;
-
-   // update the probing activities by using the column view
-   update_activities_after_boundchange(
-       colvec.getValues(), colvec.getIndices(), colvec.getLength(),
-       BoundChange::kUpper, oldub, newub, ubinf, probing_activities,
-       [this]( ActivityChange actChange, int rowid,
-               RowActivity<REAL>& activity ) {
-          activityChanged( actChange, rowid, activity );
-       },
-       true );
+   probing_upper_bounds.modify( col ) = newub;
+
+   updateActivities( col, BoundChange::kUpper, oldub, newub, ubinf,
+                     [this]( ActivityChange actChange, int rowid,
+                             RowActivity<REAL>& activity ) {
+                        activityChanged( actChange, rowid, activity );
+                     } );
+}
+
+/// same as update_activities_after_boundchange() for the activities of the
+/// overlay, every activity of the column is reported as changed
+template <typename REAL>
+template <typename ACTIVITYCHANGE>
+void
+ProbingView<REAL>::updateActivities( int col, BoundChange type,
+                                     REAL oldbound, REAL newbound,
+                                     bool oldbound_inf,
+                                     ACTIVITYCHANGE&& activityChange )
+{
+   auto colvec = problem.getConstraintMatrix().getColumnCoefficients( col );
+   const REAL* colvals = colvec.getValues();
+   const int* colrows = colvec.getIndices();
+   const int collen = colvec.getLength();
+
+   for( int i = 0; i < collen; ++i )
+   {
+      RowActivity<REAL>& activity = probing_activities.modify( colrows[i] );
+
+      ActivityChange actChange = update_activity_after_boundchange(
+          colvals[i], type, oldbound, newbound, oldbound_inf, activity );
+
+      activityChange( actChange, colrows[i], activity );
+   }
+}
+
+template <typename REAL>
+void
+ProbingView<REAL>::applyStoredImplications(
+    const ImplicationStore& implications )
+{
+   const VariableDomains<REAL>& domains = problem.getVariableDomains();
+
+   assert( implications.getNCols() == problem.getNCols() );
+   assert( probingCol != -1 );
+
+   amountofwork += implications.forEachImplied(
+       ImplicationStore::literal( probingCol, probingValue ),
+       [&]( int lit ) {
+          int col = ImplicationStore::getCol( lit );
+          if( infeasible || !domains.isBinary( col ) )
+             return;
+
+          if( ImplicationStore::getValue( lit ) )
+          {
+             if( probing_upper_bounds[col] == 0 )
+                infeasible = true;
+             else if( probing_lower_bounds[col] == 0 )
+                changeLb( col, 1.0 );
+          }
+          else
+          {
+             if( probing_lower_bounds[col] == 1 )
+                infeasible = true;
+             else if( probing_upper_bounds[col] == 1 )
+                changeUb( col, 0.0 );
+          }
+       } );
+}
+
+template <typename REAL>
+void
+ProbingView<REAL>::storeBinaryImplications()
+{
+   if( infeasible )
+      return;
+
+   const VariableDomains<REAL>& domains = problem.getVariableDomains();
+   const int lit = ImplicationStore::literal( probingCol, probingValue );
+
+   for( int c : changed_lbs )
+   {
+      int col = c < 0 ? -c - 1 : c;
+
+      if( col != probingCol && domains.isBinary( col ) &&
+          probing_lower_bounds[col] == 1 )
+         binaryImplications.emplace_back(
+             lit, ImplicationStore::literal( col, true ) );
+   }
+
+   for( int c : changed_ubs )
+   {
+      int col = c < 0 ? -c - 1 : c;
+
+      if( col != probingCol && domains.isBinary( col ) &&
+          probing_upper_bounds[col] == 0 )
+         binaryImplications.emplace_back(
+             lit, ImplicationStore::literal( col, false ) );
+   }
 }
 
 template <typename REAL>
@@ -569,6 +569,12 @@ class Problem
       this->inputTolerance = std::move( inputTolerance_ );
    }
 
+   const REAL&
+   getInputTolerance() const
+   {
+      return inputTolerance;
+   }
+
    void
    recomputeAllActivities()
    {
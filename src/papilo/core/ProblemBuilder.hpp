@@ -277,7 +277,7 @@ class ProblemBuilder
    addEntry( int row, int col, const REAL& val )
    {
       assert( val != 0 );
-      matrix_buffer.addEntry( row, col, val );
+      matrix_buffer.appendEntry( row, col, val );
    }
 
    /// add all given entries given in tripel: (row,col,val)
@@ -296,7 +296,7 @@ class ProblemBuilder
       for( int i = 0; i != len; ++i )
       {
          assert( vals[i] != 0 );
-         matrix_buffer.addEntry( row, cols[i], REAL{ vals[i] } );
+         matrix_buffer.appendEntry( row, cols[i], REAL{ vals[i] } );
       }
    }
 
@@ -347,7 +347,7 @@ class ProblemBuilder
       for( int i = 0; i != len; ++i )
       {
          assert( vals[i] != 0 );
-         matrix_buffer.addEntry( rows[i], col, REAL{ vals[i] } );
+         matrix_buffer.appendEntry( rows[i], col, REAL{ vals[i] } );
       }
    }
 
@@ -24,6 +24,7 @@
 #define _PAPILO_CORE_PROBLEM_UPDATE_HPP_
 
 #include "boost/random.hpp"
+#include "papilo/core/ImplicationStore.hpp"
 #include "papilo/core/MatrixBuffer.hpp"
 #include "papilo/core/PresolveMethod.hpp"
 #include "papilo/core/PresolveOptions.hpp"
@@ -33,6 +34,7 @@
 #include "papilo/core/Statistics.hpp"
 #include "papilo/core/SymmetryStorage.hpp"
 #include "papilo/core/postsolve/PostsolveStorage.hpp"
+#include "papilo/misc/ChangeLog.hpp"
 #include "papilo/misc/Flags.hpp"
 #include "papilo/misc/MultiPrecision.hpp"
 #include "papilo/misc/Num.hpp"
@@ -70,6 +72,9 @@ class ProblemUpdate
    const Message& msg;
 
    bool postponeSubstitutions;
+   /// change epoch since which modified rows and columns cannot be locked,
+   /// -1 if only the states since the last clearStates() are checked
+   int conflictEpoch;
    Vec<int> dirty_row_states;
    Vec<int> dirty_col_states;
 
@@ -104,6 +109,14 @@ class ProblemUpdate
 
    Vec<Flags<State>> row_state;
    Vec<Flags<State>> col_state;
+
+   /// rows and columns modified in each epoch, a new epoch starts in
+   /// clearStates()
+   ChangeLog row_changes;
+   ChangeLog col_changes;
+
+   /// implications between binary columns found by the presolvers
+   ImplicationStore implications;
    std::unique_ptr<CertificateInterface<REAL>> certificate_interface;
 
  public:
@@ -124,6 +137,8 @@ class ProblemUpdate
       if( col_state[col].equal( State::kUnmodified ) )
          dirty_col_states.push_back( col );
 
+      col_changes.mark( col );
+
       col_state[col].set( flags... );
    }
 
@@ -150,6 +165,8 @@ class ProblemUpdate
       if( row_state[row].equal( State::kUnmodified ) )
          dirty_row_states.push_back( row );
 
+      row_changes.mark( row );
+
       row_state[row].set( flags... );
    }
 
@@ -169,6 +186,33 @@ class ProblemUpdate
       this->postponeSubstitutions = value;
    }
 
+   /// transactions that lock a row or column modified in the given or a
+   /// later change epoch are rejected, e.g. if they were found on a copy of
+   /// the problem taken at that epoch; -1 resets to the default of checking
+   /// only the modifications since the last clearStates()
+   void
+   setConflictEpoch( int epoch )
+   {
+      this->conflictEpoch = epoch;
+   }
+
+   /// takes over the change logs, the implications and the random
+   /// permutations of the ProblemUpdate of the problem that was copied into
+   /// the problem of this one, so that presolvers run on the copy as on the
+   /// original problem
+   void
+   copyTrackingOf( const ProblemUpdate<REAL>& other )
+   {
+      assert( problem.getNRows() == other.problem.getNRows() );
+      assert( problem.getNCols() == other.problem.getNCols() );
+
+      row_changes = other.row_changes;
+      col_changes = other.col_changes;
+      implications = other.implications;
+      random_col_perm = other.random_col_perm;
+      random_row_perm = other.random_row_perm;
+   }
+
 
    void
    update_activity( ActivityChange actChange, int rowid,
@@ -323,6 +367,42 @@ class ProblemUpdate
       return changed_activities;
    }
 
+   /// epoch of the change logs, rows and columns that are modified from now
+   /// on are returned by getChangedRowsSince() and getChangedColsSince()
+   int
+   getChangeEpoch() const
+   {
+      return row_changes.getEpoch();
+   }
+
+   /// appends the rows that are not redundant and whose coefficients, sides,
+   /// flags or activity changed in the given or a later epoch
+   void
+   getChangedRowsSince( int epoch, Vec<int>& rows ) const;
+
+   /// appends the active columns whose bounds, coefficients or flags changed
+   /// in the given or a later epoch
+   void
+   getChangedColsSince( int epoch, Vec<int>& cols ) const;
+
+   /// appends the active columns that changed in the given or a later epoch
+   /// or that have an entry in a row that changed since then, sorted
+   /// increasingly
+   void
+   getAffectedColsSince( int epoch, Vec<int>& cols ) const;
+
+   const ImplicationStore&
+   getImplications() const
+   {
+      return implications;
+   }
+
+   ImplicationStore&
+   getImplications()
+   {
+      return implications;
+   }
+
    const Vec<int>&
    getSingletonCols() const
    {
@@ -439,6 +519,12 @@ class ProblemUpdate
 
    void
    shuffle( std::ranlux24& random_generator, Vec<int>& array );
+
+ private:
+   /// logs the columns of redundant rows and the rows of deleted columns as
+   /// changed before they are removed from the matrix
+   void
+   logDeletedRowsAndCols();
 };
 
 #ifdef PAPILO_USE_EXTERN_TEMPLATES
@@ -457,7 +543,13 @@ ProblemUpdate<REAL>::ProblemUpdate(
 {
    row_state.resize( _problem.getNRows() );
    col_state.resize( _problem.getNCols() );
+   row_changes = ChangeLog( _problem.getNRows() );
+   col_changes = ChangeLog( _problem.getNCols() );
+   implications = ImplicationStore(
+       _problem.getNCols(), 2 * int64_t( _problem.getConstraintMatrix().getNnz() ) +
+                                _problem.getNCols() );
    postponeSubstitutions = true;
+   conflictEpoch = -1;
    firstNewSingletonCol = 0;
    certificate_interface =
        std::unique_ptr<CertificateInterface<REAL>>(
@@ -490,7 +582,13 @@ ProblemUpdate<REAL>::ProblemUpdate(
 {
    row_state.resize( _problem.getNRows() );
    col_state.resize( _problem.getNCols() );
+   row_changes = ChangeLog( _problem.getNRows() );
+   col_changes = ChangeLog( _problem.getNCols() );
+   implications = ImplicationStore(
+       _problem.getNCols(), 2 * int64_t( _problem.getConstraintMatrix().getNnz() ) +
+                                _problem.getNCols() );
    postponeSubstitutions = true;
+   conflictEpoch = -1;
    firstNewSingletonCol = 0;
    certificate_interface = std::move(_certificate_interface);
 
@@ -541,12 +639,16 @@ void
 ProblemUpdate<REAL>::update_activity( ActivityChange actChange, int rowid,
                                       RowActivity<REAL>& activity )
 {
-   if( activity.lastchange == stats.nrounds ||
-       ( actChange == ActivityChange::kMin && activity.ninfmin > 1 ) ||
+   if( ( actChange == ActivityChange::kMin && activity.ninfmin > 1 ) ||
        ( actChange == ActivityChange::kMax && activity.ninfmax > 1 ) ||
        problem.getConstraintMatrix().isRowRedundant( rowid ) )
       return;
 
+   row_changes.mark( rowid );
+
+   if( activity.lastchange == stats.nrounds )
+      return;
+
    activity.lastchange = stats.nrounds;
 
    changed_activities.push_back( rowid );
@@ -905,6 +1007,10 @@ ProblemUpdate<REAL>::compress( bool full )
 
 #ifdef PAPILO_TBB
    tbb::parallel_invoke(
+       [this, &mappings, full]() {
+          row_changes.compress( mappings.first, full );
+          col_changes.compress( mappings.second, full );
+       },
        [this, &mappings, full]() {
           compress_index_vector( mappings.first, random_row_perm );
           if( full )
@@ -952,12 +1058,18 @@ ProblemUpdate<REAL>::compress( bool full )
        [this, &mappings]() {
           for( PresolveMethod<REAL>* observer : compress_observers )
              observer->compress( mappings.first, mappings.second );
+       },
+       [this, &mappings, full]() {
+          implications.compress( mappings.second, full );
        } );
 #else
+   row_changes.compress( mappings.first, full );
+   col_changes.compress( mappings.second, full );
    compress_index_vector( mappings.first, random_row_perm );
    compress_index_vector( mappings.second, random_col_perm );
    postsolve.compress( mappings.first, mappings.second, full );
    certificate_interface->compress( mappings.first, mappings.second, full );
+   implications.compress( mappings.second, full );
    compress_index_vector( mappings.first, changed_activities );
    compress_index_vector( mappings.first, singletonRows );
    compress_index_vector( mappings.second, emptyColumns );
@@ -995,14 +1107,29 @@ ProblemUpdate<REAL>::checkChangedActivities()
    const Vec<REAL>& lhs = consmatrix.getLeftHandSides();
    const Vec<REAL>& rhs = consmatrix.getRightHandSides();
 
+   Vec<RowActivity<REAL>>& activities = problem.getRowActivities();
+   const int maxupdates = presolveOptions.activityupdates;
+
    PresolveStatus status = PresolveStatus::kUnchanged;
    for( int r : changed_activities )
    {
       if( rflags[r].test( RowFlag::kRedundant ) )
          continue;
 
-      RowStatus st = problem.getRowActivities()[r].checkStatus(
-          num, rflags[r], lhs[r], rhs[r] );
+      // the rounding errors of many incremental updates are removed by
+      // computing the activity from the row again
+      if( num_traits<REAL>::is_floating_point && maxupdates != 0 &&
+          activities[r].nupdates >= maxupdates )
+      {
+         auto rowvec = consmatrix.getRowCoefficients( r );
+         activities[r] = compute_row_activity(
+             rowvec.getValues(), rowvec.getIndices(), rowvec.getLength(),
+             problem.getLowerBounds(), problem.getUpperBounds(),
+             problem.getColFlags(), activities[r].lastchange );
+      }
+
+      RowStatus st =
+          activities[r].checkStatus( num, rflags[r], lhs[r], rhs[r] );
 
       switch( st )
       {
@@ -1062,6 +1189,8 @@ ProblemUpdate<REAL>::flushChangedCoeffs()
          // TODO: update up/down-locks -> so that i.e. DualFix can use it
       };
 
+      matrix_buffer.sortOrLink();
+
       problem.getConstraintMatrix().changeCoefficients(
           matrix_buffer, singletonRows, singletonColumns, emptyColumns,
           activities, coeffChanged );
@@ -1119,6 +1248,7 @@ ProblemUpdate<REAL>::flush( bool reset_changed_activities )
 
    // delete fixed columns and redundant rows form the matrix
    // TODO update locks in delete rows and cols function
+   logDeletedRowsAndCols();
    consMatrix.deleteRowsAndCols( redundant_rows, deleted_cols, activities,
                                  singletonRows, singletonColumns,
                                  emptyColumns );
@@ -1192,6 +1322,93 @@ ProblemUpdate<REAL>::clearStates()
        std::all_of( col_state.begin(), col_state.end(), []( Flags<State> s ) {
           return s.equal( State::kUnmodified );
        } ) );
+
+   row_changes.nextEpoch();
+   col_changes.nextEpoch();
+}
+
+template <typename REAL>
+void
+ProblemUpdate<REAL>::logDeletedRowsAndCols()
+{
+   const ConstraintMatrix<REAL>& consMatrix = problem.getConstraintMatrix();
+
+   for( int row : redundant_rows )
+   {
+      auto rowvec = consMatrix.getRowCoefficients( row );
+      const int* rowcols = rowvec.getIndices();
+      for( int j = 0; j != rowvec.getLength(); ++j )
+         col_changes.mark( rowcols[j] );
+   }
+
+   for( int col : deleted_cols )
+   {
+      auto colvec = consMatrix.getColumnCoefficients( col );
+      const int* colrows = colvec.getIndices();
+      for( int j = 0; j != colvec.getLength(); ++j )
+         row_changes.mark( colrows[j] );
+   }
+}
+
+template <typename REAL>
+void
+ProblemUpdate<REAL>::getChangedRowsSince( int epoch, Vec<int>& rows ) const
+{
+   const Vec<RowFlags>& rflags = problem.getRowFlags();
+   std::size_t first = rows.size();
+
+   row_changes.getChangedSince( epoch, rows );
+
+   rows.erase( std::remove_if( rows.begin() + first, rows.end(),
+                               [&rflags]( int row ) {
+                                  return rflags[row].test(
+                                      RowFlag::kRedundant );
+                               } ),
+               rows.end() );
+}
+
+template <typename REAL>
+void
+ProblemUpdate<REAL>::getChangedColsSince( int epoch, Vec<int>& cols ) const
+{
+   const Vec<ColFlags>& cflags = problem.getColFlags();
+   std::size_t first = cols.size();
+
+   col_changes.getChangedSince( epoch, cols );
+
+   cols.erase( std::remove_if( cols.begin() + first, cols.end(),
+                               [&cflags]( int col ) {
+                                  return cflags[col].test(
+                                      ColFlag::kInactive );
+                               } ),
+               cols.end() );
+}
+
+template <typename REAL>
+void
+ProblemUpdate<REAL>::getAffectedColsSince( int epoch, Vec<int>& cols ) const
+{
+   const ConstraintMatrix<REAL>& consMatrix = problem.getConstraintMatrix();
+   const Vec<ColFlags>& cflags = problem.getColFlags();
+   std::size_t first = cols.size();
+
+   getChangedColsSince( epoch, cols );
+
+   Vec<int> rows;
+   getChangedRowsSince( epoch, rows );
+   for( int row : rows )
+   {
+      auto rowvec = consMatrix.getRowCoefficients( row );
+      const int* rowcols = rowvec.getIndices();
+      for( int j = 0; j != rowvec.getLength(); ++j )
+      {
+         if( !cflags[rowcols[j]].test( ColFlag::kInactive ) )
+            cols.push_back( rowcols[j] );
+      }
+   }
+
+   std::sort( cols.begin() + first, cols.end() );
+   cols.erase( std::unique( cols.begin() + first, cols.end() ), cols.end() );
 }
 
 template <typename REAL>
@@ -1616,6 +1833,7 @@ ProblemUpdate<REAL>::trivialPresolve()
 
    removeFixedCols();
 
+   logDeletedRowsAndCols();
    problem.getConstraintMatrix().deleteRowsAndCols(
        redundant_rows, deleted_cols, problem.getRowActivities(), singletonRows,
        singletonColumns, emptyColumns );
@@ -1809,7 +2027,7 @@ ProblemUpdate<REAL>::cleanupSmallCoefficients( int row )
 
       if( absval < presolveOptions.minabscoeff )
       {
-         matrix_buffer.addEntry( row, col, 0 );
+         matrix_buffer.appendEntry( row, col, 0 );
 
          Message::debug( this, "removed tiny coefficient with value {}\n",
                          double( values[i] ) );
@@ -1823,7 +2041,7 @@ ProblemUpdate<REAL>::cleanupSmallCoefficients( int row )
          REAL temp_total_mod = total_mod + absval * ( ubs[col] - lbs[col] );
          if( temp_total_mod <= 0.1 * num.getFeasTol() )
          {
-            matrix_buffer.addEntry( row, col, 0 );
+            matrix_buffer.appendEntry( row, col, 0 );
 
             Message::debug( this, "removed small coefficient with value {}\n",
                             double( values[i] ) );
@@ -1994,14 +2212,18 @@ ProblemUpdate<REAL>::checkTransactionConflicts( const Reduction<REAL>* first,
          case ColReduction::LOCKED:
             // if the transaction wants to lock the column it must not be
             // modifed yet
-            if( col_state[reduction.col].test( State::kModified ) )
+            if( col_state[reduction.col].test( State::kModified ) ||
+                ( conflictEpoch != -1 &&
+                  col_changes.isChangedSince( reduction.col, conflictEpoch ) ) )
             {
                msg.detailed( "CONFLICT lock col {}\n", reduction.col );
                return ConflictType::kConflict;
             }
             break;
          case ColReduction::BOUNDS_LOCKED:
-            if( col_state[reduction.col].test( State::kBoundsModified ) )
+            if( col_state[reduction.col].test( State::kBoundsModified ) ||
+                ( conflictEpoch != -1 &&
+                  col_changes.isChangedSince( reduction.col, conflictEpoch ) ) )
             {
                msg.detailed( "CONFLICT bounds lock col {}\n", reduction.col );
                return ConflictType::kConflict;
@@ -2030,7 +2252,9 @@ ProblemUpdate<REAL>::checkTransactionConflicts( const Reduction<REAL>* first,
             // if the transaction wants to lock the row it must not be
             // modified yet
             if( row_state[reduction.row].test( State::kModified,
-                                               State::kBoundsModified ) )
+                                               State::kBoundsModified ) ||
+                ( conflictEpoch != -1 &&
+                  row_changes.isChangedSince( reduction.row, conflictEpoch ) ) )
             {
                msg.detailed( "CONFLICT row lock row {}\n", reduction.row );
                return ConflictType::kConflict;
@@ -2105,7 +2329,7 @@ ProblemUpdate<REAL>::applyTransaction( const Reduction<REAL>* first,
 
          postsolve.storeCoefficientChange( reduction.row, reduction.col,
                                            reduction.newval );
-         matrix_buffer.addEntry( reduction.row, reduction.col,
+         matrix_buffer.appendEntry( reduction.row, reduction.col,
                                  reduction.newval );
 
          auto& next_reduction = *(iter+1);
@@ -2185,6 +2409,12 @@ ProblemUpdate<REAL>::applyTransaction( const Reduction<REAL>* first,
             if( !cflags[reduction.col].test( ColFlag::kInactive ) )
             {
                cflags[reduction.col].set( ColFlag::kImplInt );
+               col_changes.mark( reduction.col );
+
+               // the integrality of the other columns in these rows changed
+               auto colvec = constraintMatrix.getColumnCoefficients( reduction.col );
+               for( int j = 0; j != colvec.getLength(); ++j )
+                  row_changes.mark( colvec.getIndices()[j] );
                if( !cflags[reduction.col].test( ColFlag::kLbInf ) )
                {
                   if( changeLB( reduction.col, lbs[reduction.col] ) ==
@@ -27,8 +27,12 @@
 #include "papilo/core/VariableDomains.hpp"
 #include "papilo/misc/Flags.hpp"
 #include "papilo/misc/Num.hpp"
+#include "papilo/misc/StableSum.hpp"
 #include "papilo/misc/Vec.hpp"
 #include <tuple>
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#endif
 
 namespace papilo
 {
@@ -74,6 +78,10 @@ struct RowActivity
    /// last presolving round where this activity changed
    int lastchange;
 
+   /// number of incremental updates since the activity was computed from the
+   /// row, their rounding errors add up in the minimal and maximal activity
+   int nupdates;
+
    bool
    repropagate( ActivityChange actChange, RowFlags rflags )
    {
@@ -138,6 +146,7 @@ struct RowActivity
 
       ar& ninfmax;
       ar& lastchange;
+      ar& nupdates;
    }
 
    RowActivity() = default;
@@ -168,21 +177,14 @@ count_locks( const REAL& val, RowFlags rflags, int& ndownlocks, int& nuplocks )
    }
 }
 
-template <typename REAL>
-RowActivity<REAL>
-compute_row_activity( const REAL* rowvals, const int* colindices, int rowlen,
-                      const Vec<REAL>& lower_bounds,
-                      const Vec<REAL>& upper_bounds, const Vec<ColFlags>& flags,
-                      int presolveround = -1 )
+/// adds the contributions of the entries of a row to its activity, the bounds
+/// and flags can be given by any container that is indexed by the column
+template <typename REAL, typename BOUNDS, typename FLAGS>
+void
+add_row_activity( const REAL* rowvals, const int* colindices, int rowlen,
+                  const BOUNDS& lower_bounds, const BOUNDS& upper_bounds,
+                  const FLAGS& flags, RowActivity<REAL>& activity )
 {
-   RowActivity<REAL> activity;
-
-   activity.min = 0.0;
-   activity.max = 0.0;
-   activity.ninfmin = 0;
-   activity.ninfmax = 0;
-   activity.lastchange = presolveround;
-
    for( int j = 0; j < rowlen; ++j )
    {
       int col = colindices[j];
@@ -218,6 +220,157 @@ compute_row_activity( const REAL* rowvals, const int* colindices, int rowlen,
             ++activity.ninfmin;
       }
    }
+}
+
+#if defined( __AVX2__ )
+/// adds x to the four sums with compensations c in the same way as StableSum
+inline void
+add_stable_sum4( __m256d& sum, __m256d& c, __m256d x )
+{
+   __m256d t = _mm256_add_pd( sum, x );
+   __m256d z = _mm256_sub_pd( t, sum );
+   __m256d y = _mm256_add_pd( _mm256_sub_pd( sum, _mm256_sub_pd( t, z ) ),
+                              _mm256_sub_pd( x, z ) );
+   c = _mm256_add_pd( c, y );
+   sum = t;
+}
+
+/// all bits set in the lanes of the four columns that have the flag
+inline __m256d
+col_flag_mask4( const Vec<ColFlags>& flags, const int* cols, ColFlag flag )
+{
+   return _mm256_castsi256_pd( _mm256_set_epi64x(
+       -int64_t( flags[cols[3]].test( flag ) ),
+       -int64_t( flags[cols[2]].test( flag ) ),
+       -int64_t( flags[cols[1]].test( flag ) ),
+       -int64_t( flags[cols[0]].test( flag ) ) ) );
+}
+
+/// activity of a double row with the bounds in vectors if compiled with AVX2,
+/// four entries are handled at once and their bounds are gathered by the
+/// column indices. The minimal and maximal activity are summed with
+/// compensation.
+inline void
+add_row_activity( const double* rowvals, const int* colindices, int rowlen,
+                  const Vec<double>& lower_bounds,
+                  const Vec<double>& upper_bounds, const Vec<ColFlags>& flags,
+                  RowActivity<double>& activity )
+{
+   StableSum<double> min( activity.min );
+   StableSum<double> max( activity.max );
+   int j = 0;
+
+   const __m256d zero = _mm256_setzero_pd();
+   __m256d minsum = zero;
+   __m256d minc = zero;
+   __m256d maxsum = zero;
+   __m256d maxc = zero;
+
+   for( ; j + 4 <= rowlen; j += 4 )
+   {
+      const __m128i cols = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>( colindices + j ) );
+      const __m256d vals = _mm256_loadu_pd( rowvals + j );
+      const __m256d lbs =
+          _mm256_i32gather_pd( lower_bounds.data(), cols, sizeof( double ) );
+      const __m256d ubs =
+          _mm256_i32gather_pd( upper_bounds.data(), cols, sizeof( double ) );
+      const __m256d lbuseless =
+          col_flag_mask4( flags, colindices + j, ColFlag::kLbUseless );
+      const __m256d ubuseless =
+          col_flag_mask4( flags, colindices + j, ColFlag::kUbUseless );
+
+      // negative coefficients take the minimal activity from the upper bound
+      const __m256d negative = _mm256_cmp_pd( vals, zero, _CMP_LT_OQ );
+      const __m256d minbound = _mm256_blendv_pd( lbs, ubs, negative );
+      const __m256d maxbound = _mm256_blendv_pd( ubs, lbs, negative );
+      const __m256d mininf = _mm256_blendv_pd( lbuseless, ubuseless, negative );
+      const __m256d maxinf = _mm256_blendv_pd( ubuseless, lbuseless, negative );
+
+      add_stable_sum4( minsum, minc,
+                       _mm256_andnot_pd( mininf,
+                                         _mm256_mul_pd( vals, minbound ) ) );
+      add_stable_sum4( maxsum, maxc,
+                       _mm256_andnot_pd( maxinf,
+                                         _mm256_mul_pd( vals, maxbound ) ) );
+
+      const int mininfmask = _mm256_movemask_pd( mininf );
+      const int maxinfmask = _mm256_movemask_pd( maxinf );
+      for( int k = 0; k != 4; ++k )
+      {
+         activity.ninfmin += ( mininfmask >> k ) & 1;
+         activity.ninfmax += ( maxinfmask >> k ) & 1;
+      }
+   }
+
+   alignas( 32 ) double lanes[4][4];
+   _mm256_store_pd( lanes[0], minsum );
+   _mm256_store_pd( lanes[1], minc );
+   _mm256_store_pd( lanes[2], maxsum );
+   _mm256_store_pd( lanes[3], maxc );
+   for( int k = 0; k != 4; ++k )
+   {
+      min.add( lanes[0][k] );
+      min.add( lanes[1][k] );
+      max.add( lanes[2][k] );
+      max.add( lanes[3][k] );
+   }
+
+   for( ; j < rowlen; ++j )
+   {
+      int col = colindices[j];
+      const double val = rowvals[j];
+
+      if( !flags[col].test( ColFlag::kUbUseless ) )
+      {
+         if( val < 0 )
+            min.add( val * upper_bounds[col] );
+         else
+            max.add( val * upper_bounds[col] );
+      }
+      else if( val < 0 )
+         ++activity.ninfmin;
+      else
+         ++activity.ninfmax;
+
+      if( !flags[col].test( ColFlag::kLbUseless ) )
+      {
+         if( val < 0 )
+            max.add( val * lower_bounds[col] );
+         else
+            min.add( val * lower_bounds[col] );
+      }
+      else if( val < 0 )
+         ++activity.ninfmax;
+      else
+         ++activity.ninfmin;
+   }
+
+   activity.min = min.get();
+   activity.max = max.get();
+}
+#endif
+
+/// computes the activity of a row, the bounds and flags can be given by any
+/// container that is indexed by the column
+template <typename REAL, typename BOUNDS = Vec<REAL>,
+          typename FLAGS = Vec<ColFlags>>
+RowActivity<REAL>
+compute_row_activity( const REAL* rowvals, const int* colindices, int rowlen,
+                      const BOUNDS& lower_bounds, const BOUNDS& upper_bounds,
+                      const FLAGS& flags, int presolveround = -1 )
+{
+   RowActivity<REAL> activity;
+
+   activity.min = 0.0;
+   activity.max = 0.0;
+   activity.ninfmin = 0;
+   activity.ninfmax = 0;
+   activity.lastchange = presolveround;
+   activity.nupdates = 0;
+
+   add_row_activity( rowvals, colindices, rowlen, lower_bounds, upper_bounds,
+                     flags, activity );
 
    return activity;
 }
@@ -276,6 +429,8 @@ update_activity_after_boundchange( const REAL& colval, BoundChange type,
            ( type == BoundChange::kLower && newbound != oldbound ) ||
            ( type == BoundChange::kUpper && newbound != oldbound ) );
 
+   ++activity.nupdates;
+
    if( type == BoundChange::kLower )
    {
       if( colval < REAL{ 0.0 } )
@@ -363,6 +518,7 @@ update_activities_remove_finite_bound( const int* colinds, const REAL* colvals,
       {
          const REAL& colval = colvals[i];
          RowActivity<REAL>& activity = activities[colinds[i]];
+         ++activity.nupdates;
 
          if( colval < REAL{ 0.0 } )
          {
@@ -382,6 +538,7 @@ update_activities_remove_finite_bound( const int* colinds, const REAL* colvals,
       {
          const REAL& colval = colvals[i];
          RowActivity<REAL>& activity = activities[colinds[i]];
+         ++activity.nupdates;
 
          if( colval < REAL{ 0.0 } )
          {
@@ -466,6 +623,8 @@ update_activity_after_coeffchange( REAL collb, REAL colub, ColFlags cflags,
 {
    assert( oldcolcoef != newcolcoef );
 
+   ++activity.nupdates;
+
    if( oldcolcoef * newcolcoef <= 0.0 )
    { // the sign of the coefficient flipped, so the column bounds now contribute
      // to the opposite activity bound
@@ -617,13 +776,15 @@ update_activity_after_coeffchange( REAL collb, REAL colub, ColFlags cflags,
 
 /// propagate domains of variables using the given a row and its activity. The
 /// last argument must be callable with arguments (BoundChange, colid, newbound, row)
-/// and is called to inform about column bounds that changed.
-template <typename REAL, typename BOUNDCHANGE>
+/// and is called to inform about column bounds that changed. The bounds and
+/// flags can be given by any container that is indexed by the column.
+template <typename REAL, typename BOUNDCHANGE, typename BOUNDS = Vec<REAL>,
+          typename FLAGS = Vec<ColFlags>>
 void
 propagate_row( const Num<REAL>& num, int row, const REAL* rowvals, const int* colindices, int rowlen,
                const RowActivity<REAL>& activity, REAL lhs, REAL rhs,
-               RowFlags rflags, const Vec<REAL>& lower_bounds,
-               const Vec<REAL>& upper_bounds, const Vec<ColFlags>& domainFlags,
+               RowFlags rflags, const BOUNDS& lower_bounds,
+               const BOUNDS& upper_bounds, const FLAGS& domainFlags,
                BOUNDCHANGE&& boundchange )
 {
 
@@ -82,6 +82,10 @@ class SparseStorage
                   int minInterRowSpace = DEFAULT_MIN_INTER_ROW_SPACE );
    SparseStorage( int nRows_in, int nCols_in, int nnz_in, double spareRatio,
                   int minInterRowSpace );
+   /// takes over storage arrays that were laid out by another SparseStorage
+   SparseStorage( Vec<REAL> values_in, Vec<IndexRange> rowranges_in,
+                  Vec<int> columns_in, int nRows_in, int nCols_in, int nnz_in,
+                  double spareRatio_in, int minInterRowSpace_in );
 
    SparseStorage<REAL>
    getTranspose() const;
@@ -118,6 +122,18 @@ class SparseStorage
       return nnz;
    }
 
+   double
+   getSpareRatio() const
+   {
+      return spareRatio;
+   }
+
+   int
+   getMinInterRowSpace() const
+   {
+      return minInterRowSpace;
+   }
+
    int
    getNAlloc() const
    {
@@ -523,6 +539,22 @@ SparseStorage<REAL>::SparseStorage( int nRows_in, int nCols_in, int nnz_in,
    rowranges[nRows].end = nAlloc;
 }
 
+template <typename REAL>
+SparseStorage<REAL>::SparseStorage( Vec<REAL> values_in,
+                                    Vec<IndexRange> rowranges_in,
+                                    Vec<int> columns_in, int nRows_in,
+                                    int nCols_in, int nnz_in,
+                                    double spareRatio_in,
+                                    int minInterRowSpace_in )
+    : values( std::move( values_in ) ), rowranges( std::move( rowranges_in ) ),
+      columns( std::move( columns_in ) ), nRows( nRows_in ), nCols( nCols_in ),
+      nnz( nnz_in ), nAlloc( static_cast<int>( values.size() ) ),
+      spareRatio( spareRatio_in ), minInterRowSpace( minInterRowSpace_in )
+{
+   assert( values.size() == columns.size() );
+   assert( rowranges.size() == std::size_t( nRows + 1 ) );
+}
+
 template <typename REAL>
 SparseStorage<REAL>::SparseStorage( REAL* values_in, int* rowstart_in,
                                     int* columns_in, int nRows_in, int nCols_in,
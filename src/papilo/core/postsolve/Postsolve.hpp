@@ -78,7 +78,37 @@ class Postsolve
          Solution<REAL>& originalSolution,
          const PostsolveStorage<REAL>& postsolveStorage, bool is_optimal = true ) const;
 
+   /// postsolves several solutions of the same reduced problem in parallel.
+   /// The levels of the primal postsolve are computed once for all primal
+   /// solutions. Returns kFailed if the postsolve of one solution failed.
+   PostsolveStatus
+   undo( const Vec<Solution<REAL>>& reducedSolutions,
+         Vec<Solution<REAL>>& originalSolutions,
+         const PostsolveStorage<REAL>& postsolveStorage,
+         bool is_optimal = true ) const;
+
  private:
+   bool
+   compute_primal_levels( const PostsolveStorage<REAL>& postsolveStorage,
+                          Vec<int>& level_reductions,
+                          Vec<int>& level_start ) const;
+
+   PostsolveStatus
+   undo_primal_by_levels( const Solution<REAL>& reducedSolution,
+                          Solution<REAL>& originalSolution,
+                          const PostsolveStorage<REAL>& postsolveStorage,
+                          const Vec<int>& level_reductions,
+                          const Vec<int>& level_start ) const;
+
+   PostsolveStatus
+   verify_original_solution( Solution<REAL>& originalSolution,
+                             const Problem<REAL>& problem ) const;
+
+   void
+   apply_primal_substitution_to_original_solution(
+       Solution<REAL>& originalSolution, const Vec<int>& indices,
+       const Vec<REAL>& values, int first, int last ) const;
+
    REAL
    calculate_row_value_for_fixed_infinity_variable(
        REAL lhs, REAL rhs, int rowLength, int column, const int* row_indices,
@@ -102,8 +132,8 @@ class Postsolve
 
    int
    apply_fix_infinity_variable_in_original_solution(
-       Solution<REAL>& originalSolution, Vec<int>& indices, Vec<REAL>& values,
-       int first, const Problem<REAL>& problem,
+       Solution<REAL>& originalSolution, const Vec<int>& indices,
+       const Vec<REAL>& values, int first, const Problem<REAL>& problem,
        BoundStorage<REAL>& stored_bounds ) const;
 
    void
@@ -178,19 +208,34 @@ Postsolve<REAL>::undo( const Solution<REAL>& reducedSolution,
                        Solution<REAL>& originalSolution,
                        const PostsolveStorage<REAL>& postsolveStorage, bool is_optimal ) const
 {
+   // primal solutions are postsolved level by level, see
+   // compute_primal_levels()
+   if( reducedSolution.type == SolutionType::kPrimal &&
+       originalSolution.type == SolutionType::kPrimal &&
+       !postsolveStorage.presolveOptions
+            .validation_after_every_postsolving_step )
+   {
+      Vec<int> level_reductions;
+      Vec<int> level_start;
+      if( compute_primal_levels( postsolveStorage, level_reductions,
+                                 level_start ) )
+         return undo_primal_by_levels( reducedSolution, originalSolution,
+                                       postsolveStorage, level_reductions,
+                                       level_start );
+   }
 
+#ifndef NDEBUG
    PrimalDualSolValidation<REAL> validation{message, num};
+#endif
 
    copy_from_reduced_to_original( reducedSolution, originalSolution,
                                   postsolveStorage );
 
-   auto types = postsolveStorage.types;
-   auto start = postsolveStorage.start;
-   auto indices = postsolveStorage.indices;
-   auto values = postsolveStorage.values;
-   auto origcol_mapping = postsolveStorage.origcol_mapping;
-   auto origrow_mapping = postsolveStorage.origrow_mapping;
-   auto problem = postsolveStorage.problem;
+   const Vec<ReductionType>& types = postsolveStorage.types;
+   const Vec<int>& start = postsolveStorage.start;
+   const Vec<int>& indices = postsolveStorage.indices;
+   const Vec<REAL>& values = postsolveStorage.values;
+   const Problem<REAL>& problem = postsolveStorage.problem;
 
    // Will be used during dual postsolve for fast access to bound values.
    // TODO: rows bounds are currently not updated during
@@ -256,24 +301,9 @@ Postsolve<REAL>::undo( const Solution<REAL>& reducedSolution,
          break;
       }
       case ReductionType::kSubstitutedCol:
-      {
-         int col = indices[first];
-         REAL side = values[first];
-         REAL colCoef = 0.0;
-         StableSum<REAL> sumcols;
-         for( int j = first + 1; j < last; ++j )
-         {
-            if( indices[j] == col )
-               colCoef = values[j];
-            else
-               sumcols.add( originalSolution.primal[indices[j]] * values[j] );
-         }
-         sumcols.add( -side );
-
-         assert( colCoef != 0.0 );
-         originalSolution.primal[col] = ( -sumcols.get() ) / colCoef;
+         apply_primal_substitution_to_original_solution(
+             originalSolution, indices, values, first, last );
          break;
-      }
       case ReductionType::kSubstitutedColWithDual:
          apply_substituted_column_to_original_solution(
              originalSolution, indices, values, first, last, stored_bounds, is_optimal );
@@ -410,13 +440,263 @@ Postsolve<REAL>::undo( const Solution<REAL>& reducedSolution,
 #endif
    }
 
-   PostsolveStatus status =
-       validation.verifySolutionAndUpdateSlack( originalSolution, problem );
-
    assert( !( !postsolveStorage.types.empty() &&
               types[postsolveStorage.types.size() - 1] ==
                   ReductionType::kReducedBoundsCost ) ||
            stored_bounds.check_bounds( problem ) );
+
+   return verify_original_solution( originalSolution, problem );
+}
+
+template <typename REAL>
+PostsolveStatus
+Postsolve<REAL>::undo( const Vec<Solution<REAL>>& reducedSolutions,
+                       Vec<Solution<REAL>>& originalSolutions,
+                       const PostsolveStorage<REAL>& postsolveStorage,
+                       bool is_optimal ) const
+{
+   int nsolutions = (int) reducedSolutions.size();
+   originalSolutions.resize( nsolutions );
+
+   Vec<int> level_reductions;
+   Vec<int> level_start;
+   bool by_levels = !postsolveStorage.presolveOptions
+                         .validation_after_every_postsolving_step &&
+                    compute_primal_levels( postsolveStorage, level_reductions,
+                                           level_start );
+
+   Vec<uint8_t> failed( nsolutions, false );
+
+   auto undo_solution = [&]( int i ) {
+      PostsolveStatus status;
+      if( by_levels && reducedSolutions[i].type == SolutionType::kPrimal &&
+          originalSolutions[i].type == SolutionType::kPrimal )
+         status = undo_primal_by_levels( reducedSolutions[i],
+                                         originalSolutions[i], postsolveStorage,
+                                         level_reductions, level_start );
+      else
+         status = undo( reducedSolutions[i], originalSolutions[i],
+                        postsolveStorage, is_optimal );
+      failed[i] = status == PostsolveStatus::kFailed;
+   };
+
+#ifdef PAPILO_TBB
+   tbb::parallel_for( tbb::blocked_range<int>( 0, nsolutions ),
+                      [&]( const tbb::blocked_range<int>& r ) {
+                         for( int i = r.begin(); i != r.end(); ++i )
+                            undo_solution( i );
+                      } );
+#else
+   for( int i = 0; i != nsolutions; ++i )
+      undo_solution( i );
+#endif
+
+   for( int i = 0; i != nsolutions; ++i )
+   {
+      if( failed[i] )
+         return PostsolveStatus::kFailed;
+   }
+
+   return PostsolveStatus::kOk;
+}
+
+/// The primal postsolve of a reduction writes the values of some columns and
+/// reads the values of others. Walking the stack backwards, a reduction gets
+/// the level after the highest level of a reduction that reads or writes a
+/// column it writes, or writes a column it reads. The reductions of one
+/// level are independent of each other and are undone in parallel, which
+/// gives the same values as undoing the stack one by one. Returns false if
+/// the stack contains a reduction that is not supported in the primal
+/// postsolve.
+template <typename REAL>
+bool
+Postsolve<REAL>::compute_primal_levels(
+    const PostsolveStorage<REAL>& postsolveStorage, Vec<int>& level_reductions,
+    Vec<int>& level_start ) const
+{
+   const Vec<ReductionType>& types = postsolveStorage.types;
+   const Vec<int>& start = postsolveStorage.start;
+   const Vec<int>& indices = postsolveStorage.indices;
+   const Vec<REAL>& values = postsolveStorage.values;
+
+   int nreductions = (int) types.size();
+   Vec<int> level( nreductions, 0 );
+   Vec<int> level_of_write( postsolveStorage.nColsOriginal, 0 );
+   Vec<int> level_of_read( postsolveStorage.nColsOriginal, 0 );
+   Vec<int> writes;
+   Vec<int> reads;
+   int nlevels = 0;
+
+   for( int i = nreductions - 1; i >= 0; --i )
+   {
+      int first = start[i];
+      int last = start[i + 1];
+      writes.clear();
+      reads.clear();
+
+      switch( types[i] )
+      {
+      case ReductionType::kFixedCol:
+         writes.push_back( indices[first] );
+         break;
+      case ReductionType::kFixedInfCol:
+      {
+         writes.push_back( indices[first] );
+         int number_rows = indices[first + 1];
+         int current_counter = first + 2;
+         for( int k = 0; k < number_rows; ++k )
+         {
+            int length = (int) values[current_counter];
+            for( int j = current_counter + 3;
+                 j < current_counter + 3 + length; ++j )
+               reads.push_back( indices[j] );
+            current_counter += 3 + length;
+         }
+         break;
+      }
+      case ReductionType::kSubstitutedCol:
+         writes.push_back( indices[first] );
+         for( int j = first + 1; j < last; ++j )
+            reads.push_back( indices[j] );
+         break;
+      case ReductionType::kSubstitutedColWithDual:
+      {
+         int row_length = (int) values[first];
+         writes.push_back( indices[first + 3 + row_length] );
+         for( int j = first + 3; j < first + 3 + row_length; ++j )
+            reads.push_back( indices[j] );
+         break;
+      }
+      case ReductionType::kParallelCol:
+         writes.push_back( indices[first] );
+         writes.push_back( indices[first + 2] );
+         break;
+      case ReductionType::kCoefficientChange:
+         // no effect on the primal solution
+         continue;
+      default:
+         return false;
+      }
+
+      int l = 0;
+      for( int col : writes )
+         l = std::max( { l, level_of_write[col], level_of_read[col] } );
+      for( int col : reads )
+         l = std::max( l, level_of_write[col] );
+      ++l;
+
+      for( int col : writes )
+         level_of_write[col] = l;
+      for( int col : reads )
+         level_of_read[col] = std::max( level_of_read[col], l );
+
+      level[i] = l;
+      nlevels = std::max( nlevels, l );
+   }
+
+   // sort the reductions by level, within a level they keep the order in
+   // which they are undone
+   level_start.assign( nlevels + 2, 0 );
+   for( int i = 0; i != nreductions; ++i )
+   {
+      if( level[i] != 0 )
+         ++level_start[level[i] + 1];
+   }
+   for( int l = 1; l <= nlevels + 1; ++l )
+      level_start[l] += level_start[l - 1];
+
+   level_reductions.resize( level_start[nlevels + 1] );
+   Vec<int> pos( level_start.begin(), level_start.end() - 1 );
+   for( int i = nreductions - 1; i >= 0; --i )
+   {
+      if( level[i] != 0 )
+         level_reductions[pos[level[i]]++] = i;
+   }
+
+   return true;
+}
+
+template <typename REAL>
+PostsolveStatus
+Postsolve<REAL>::undo_primal_by_levels(
+    const Solution<REAL>& reducedSolution, Solution<REAL>& originalSolution,
+    const PostsolveStorage<REAL>& postsolveStorage,
+    const Vec<int>& level_reductions, const Vec<int>& level_start ) const
+{
+   copy_from_reduced_to_original( reducedSolution, originalSolution,
+                                  postsolveStorage );
+
+   const Vec<ReductionType>& types = postsolveStorage.types;
+   const Vec<int>& start = postsolveStorage.start;
+   const Vec<int>& indices = postsolveStorage.indices;
+   const Vec<REAL>& values = postsolveStorage.values;
+
+   // the bounds are only stored for the dual postsolve
+   BoundStorage<REAL> stored_bounds{ num, 0, 0, false };
+
+   auto undo_reduction = [&]( int i ) {
+      int first = start[i];
+      int last = start[i + 1];
+
+      switch( types[i] )
+      {
+      case ReductionType::kFixedCol:
+         apply_fix_var_in_original_solution( originalSolution, indices, values,
+                                             first );
+         break;
+      case ReductionType::kFixedInfCol:
+         apply_fix_infinity_variable_in_original_solution(
+             originalSolution, indices, values, first, postsolveStorage.problem,
+             stored_bounds );
+         break;
+      case ReductionType::kSubstitutedCol:
+         apply_primal_substitution_to_original_solution(
+             originalSolution, indices, values, first, last );
+         break;
+      case ReductionType::kSubstitutedColWithDual:
+         apply_substituted_column_to_original_solution(
+             originalSolution, indices, values, first, last, stored_bounds,
+             true );
+         break;
+      case ReductionType::kParallelCol:
+         apply_parallel_col_to_original_solution(
+             originalSolution, indices, values, first, last, stored_bounds );
+         break;
+      default:
+         assert( false );
+      }
+   };
+
+   for( int l = 1; l < (int) level_start.size() - 1; ++l )
+   {
+#ifdef PAPILO_TBB
+      // small levels are undone by the calling thread
+      tbb::parallel_for(
+          tbb::blocked_range<int>( level_start[l], level_start[l + 1], 256 ),
+          [&]( const tbb::blocked_range<int>& r ) {
+             for( int k = r.begin(); k != r.end(); ++k )
+                undo_reduction( level_reductions[k] );
+          } );
+#else
+      for( int k = level_start[l]; k != level_start[l + 1]; ++k )
+         undo_reduction( level_reductions[k] );
+#endif
+   }
+
+   return verify_original_solution( originalSolution,
+                                    postsolveStorage.problem );
+}
+
+template <typename REAL>
+PostsolveStatus
+Postsolve<REAL>::verify_original_solution(
+    Solution<REAL>& originalSolution, const Problem<REAL>& problem ) const
+{
+   PrimalDualSolValidation<REAL> validation{ message, num };
+
+   PostsolveStatus status =
+       validation.verifySolutionAndUpdateSlack( originalSolution, problem );
+
    if( status == PostsolveStatus::kFailed )
       message.error( "Postsolving solution failed. Please use debug mode to "
                      "obtain more information." );
@@ -424,6 +704,29 @@ Postsolve<REAL>::undo( const Solution<REAL>& reducedSolution,
    return status;
 }
 
+template <typename REAL>
+void
+Postsolve<REAL>::apply_primal_substitution_to_original_solution(
+    Solution<REAL>& originalSolution, const Vec<int>& indices,
+    const Vec<REAL>& values, int first, int last ) const
+{
+   int col = indices[first];
+   REAL side = values[first];
+   REAL colCoef = 0.0;
+   StableSum<REAL> sumcols;
+   for( int j = first + 1; j < last; ++j )
+   {
+      if( indices[j] == col )
+         colCoef = values[j];
+      else
+         sumcols.add( originalSolution.primal[indices[j]] * values[j] );
+   }
+   sumcols.add( -side );
+
+   assert( colCoef != 0.0 );
+   originalSolution.primal[col] = ( -sumcols.get() ) / colCoef;
+}
+
 template <typename REAL>
 bool
 Postsolve<REAL>::skip_if_row_bound_belongs_to_substitution(
@@ -552,8 +855,8 @@ Postsolve<REAL>::apply_fix_var_in_original_solution(
 template <typename REAL>
 int
 Postsolve<REAL>::apply_fix_infinity_variable_in_original_solution(
-    Solution<REAL>& originalSolution, Vec<int>& indices, Vec<REAL>& values,
-    int first, const Problem<REAL>& problem,
+    Solution<REAL>& originalSolution, const Vec<int>& indices,
+    const Vec<REAL>& values, int first, const Problem<REAL>& problem,
     BoundStorage<REAL>& stored_bounds ) const
 {
    // calculate the feasible (minimal) value for the infinity variable
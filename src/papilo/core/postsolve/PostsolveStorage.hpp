@@ -192,6 +192,14 @@ class PostsolveStorage
                        REAL& col2lb, bool col2ubinf, REAL& col2ub,
                        REAL& col2scale );
 
+   /// appends the reductions of the primal postsolve storage of a subproblem.
+   /// The columns and rows of the original subproblem are mapped to the
+   /// columns and rows of the original problem of this storage by colmapping
+   /// and rowmapping
+   void
+   append( const PostsolveStorage<REAL>& other, const Vec<int>& colmapping,
+           const Vec<int>& rowmapping );
+
    void
    compress( const Vec<int>& rowmapping, const Vec<int>& colmapping,
              bool full = false )
@@ -659,6 +667,72 @@ PostsolveStorage<REAL>::storeParallelCols( int col1, bool col1integral,
    finishStorage();
 }
 
+template <typename REAL>
+void
+PostsolveStorage<REAL>::append( const PostsolveStorage<REAL>& other,
+                                const Vec<int>& colmapping,
+                                const Vec<int>& rowmapping )
+{
+   assert( other.postsolveType == PostsolveType::kPrimal );
+   assert( colmapping.size() == other.nColsOriginal );
+   assert( rowmapping.size() == other.nRowsOriginal );
+
+   const int offset = static_cast<int>( indices.size() );
+   indices.insert( indices.end(), other.indices.begin(), other.indices.end() );
+   values.insert( values.end(), other.values.begin(), other.values.end() );
+
+   // maps a row stored by push_back_row() and returns the position after it
+   auto mapRow = [&]( int pos ) {
+      int length = (int) values[pos];
+      indices[pos] = rowmapping[indices[pos]];
+      for( int j = pos + 3; j < pos + 3 + length; ++j )
+         indices[j] = colmapping[indices[j]];
+      return pos + 3 + length;
+   };
+
+   for( int i = 0; i < (int) other.types.size(); ++i )
+   {
+      int first = other.start[i] + offset;
+      int last = other.start[i + 1] + offset;
+
+      switch( other.types[i] )
+      {
+      case ReductionType::kFixedCol:
+         indices[first] = colmapping[indices[first]];
+         break;
+      case ReductionType::kFixedInfCol:
+      {
+         indices[first] = colmapping[indices[first]];
+         int number_rows = indices[first + 1];
+         int current_counter = first + 2;
+         for( int k = 0; k < number_rows; ++k )
+            current_counter = mapRow( current_counter );
+         break;
+      }
+      case ReductionType::kSubstitutedCol:
+         for( int j = first; j < last; ++j )
+            indices[j] = colmapping[indices[j]];
+         break;
+      case ReductionType::kSubstitutedColWithDual:
+      {
+         int pos = mapRow( first );
+         indices[pos] = colmapping[indices[pos]];
+         break;
+      }
+      case ReductionType::kParallelCol:
+         indices[first] = colmapping[indices[first]];
+         indices[first + 2] = colmapping[indices[first + 2]];
+         break;
+      default:
+         // the other reductions are only stored for the dual postsolve
+         assert( false );
+      }
+
+      types.push_back( other.types[i] );
+      start.push_back( last );
+   }
+}
+
 template <typename REAL>
 void
 PostsolveStorage<REAL>::storeReducedBoundsAndCost(
@@ -0,0 +1,337 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _PAPILO_IO_ASYNC_FILE_WRITER_HPP_
+#define _PAPILO_IO_ASYNC_FILE_WRITER_HPP_
+
+#include "papilo/Config.hpp"
+#include "papilo/misc/Vec.hpp"
+#include <algorithm>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+#include <boost/iostreams/filter/gzip.hpp>
+#endif
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZSTD
+#include <boost/iostreams/filter/zstd.hpp>
+#endif
+
+namespace papilo
+{
+
+/// Stream buffer that collects the output of its stream in large blocks and
+/// hands every full block to a background thread, which compresses it if
+/// requested and writes it to the file. The writing thread never waits for
+/// the disk: blocks that are not yet written queue up and written blocks are
+/// reused. Only the destructor and finish() wait until the file is complete.
+class AsyncFileWriter : public std::streambuf
+{
+ public:
+   enum class Compression
+   {
+      kNone = 0,
+      kGzip = 1,
+      kZstd = 2,
+   };
+
+   /// size of the blocks handed to the background thread
+   static constexpr std::size_t kBlockSize = std::size_t{ 1 } << 20;
+
+   explicit AsyncFileWriter( std::size_t _blockSize = kBlockSize )
+       : blockSize( _blockSize )
+   {
+      assert( blockSize > 0 );
+   }
+
+   AsyncFileWriter( const AsyncFileWriter& ) = delete;
+   AsyncFileWriter&
+   operator=( const AsyncFileWriter& ) = delete;
+
+   ~AsyncFileWriter() override { finish(); }
+
+   /// returns whether the given compression is available in this build
+   static bool
+   isAvailable( Compression compression )
+   {
+      switch( compression )
+      {
+      case Compression::kNone:
+         return true;
+      case Compression::kGzip:
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+         return true;
+#else
+         return false;
+#endif
+      case Compression::kZstd:
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZSTD
+         return true;
+#else
+         return false;
+#endif
+      }
+      return false;
+   }
+
+   /// returns the extension appended to files written with the compression
+   static const char*
+   getExtension( Compression compression )
+   {
+      switch( compression )
+      {
+      case Compression::kNone:
+         break;
+      case Compression::kGzip:
+         return ".gz";
+      case Compression::kZstd:
+         return ".zst";
+      }
+      return "";
+   }
+
+   /// opens the file and starts the background thread; returns false if the
+   /// file could not be opened or the compression is not available
+   bool
+   open( const std::string& filename,
+         Compression compression = Compression::kNone )
+   {
+      finish();
+
+      if( !isAvailable( compression ) )
+         return false;
+
+      file.open( filename, std::ofstream::out | std::ofstream::binary |
+                               std::ofstream::trunc );
+      if( !file )
+         return false;
+
+      out.reset();
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+      if( compression == Compression::kGzip )
+         out.push( boost::iostreams::gzip_compressor() );
+#endif
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZSTD
+      if( compression == Compression::kZstd )
+         out.push( boost::iostreams::zstd_compressor() );
+#endif
+      out.push( file );
+
+      failed = false;
+      stopped = false;
+      writer = std::thread( [this]() { writeBlocks(); } );
+      takeBlock();
+      return true;
+   }
+
+   bool
+   isOpen() const
+   {
+      return writer.joinable();
+   }
+
+   /// hands the buffered output to the background thread, waits until all of
+   /// it is written and closes the file; returns false if writing failed
+   bool
+   finish()
+   {
+      if( !writer.joinable() )
+         return !failed;
+
+      handOver();
+      {
+         std::lock_guard<std::mutex> lock( mutex );
+         stopped = true;
+      }
+      queued.notify_one();
+      writer.join();
+
+      setp( nullptr, nullptr );
+      current.clear();
+      free.clear();
+      return !failed;
+   }
+
+ protected:
+   int_type
+   overflow( int_type ch ) override
+   {
+      if( !writer.joinable() )
+         return traits_type::eof();
+
+      handOver();
+      takeBlock();
+
+      if( !traits_type::eq_int_type( ch, traits_type::eof() ) )
+      {
+         *pptr() = traits_type::to_char_type( ch );
+         pbump( 1 );
+      }
+      return traits_type::not_eof( ch );
+   }
+
+   std::streamsize
+   xsputn( const char* s, std::streamsize count ) override
+   {
+      std::streamsize written = 0;
+      while( written < count )
+      {
+         std::streamsize space = epptr() - pptr();
+         if( space == 0 )
+         {
+            if( traits_type::eq_int_type( overflow( traits_type::eof() ),
+                                          traits_type::eof() ) )
+               break;
+            continue;
+         }
+         std::streamsize len = std::min( space, count - written );
+         std::memcpy( pptr(), s + written, len );
+         pbump( static_cast<int>( len ) );
+         written += len;
+      }
+      return written;
+   }
+
+   /// hands the buffered output to the background thread without waiting
+   /// for it to be written
+   int
+   sync() override
+   {
+      if( !writer.joinable() )
+         return 0;
+
+      handOver();
+      takeBlock();
+      return 0;
+   }
+
+ private:
+   std::size_t blockSize;
+   std::ofstream file;
+   boost::iostreams::filtering_ostream out;
+   std::thread writer;
+
+   std::mutex mutex;
+   std::condition_variable queued;
+   /// full blocks in the order they are written, accessed under the mutex
+   std::deque<std::string> blocks;
+   /// written blocks that are reused, accessed under the mutex
+   Vec<std::string> free;
+   bool stopped = false;
+   bool failed = false;
+
+   /// block that is currently filled through the put area
+   std::string current;
+
+   /// moves the filled part of the current block to the queue
+   void
+   handOver()
+   {
+      std::size_t size = pptr() - pbase();
+      if( size == 0 )
+         return;
+
+      current.resize( size );
+      {
+         std::lock_guard<std::mutex> lock( mutex );
+         blocks.push_back( std::move( current ) );
+      }
+      queued.notify_one();
+      current = std::string();
+      setp( nullptr, nullptr );
+   }
+
+   /// makes a reused or new block the put area
+   void
+   takeBlock()
+   {
+      if( pbase() != nullptr )
+         return;
+
+      {
+         std::lock_guard<std::mutex> lock( mutex );
+         if( !free.empty() )
+         {
+            current = std::move( free.back() );
+            free.pop_back();
+         }
+      }
+      current.resize( blockSize );
+      setp( &current[0], &current[0] + blockSize );
+   }
+
+   /// runs on the background thread until the writer is stopped and all
+   /// queued blocks are written
+   void
+   writeBlocks()
+   {
+      std::unique_lock<std::mutex> lock( mutex );
+      while( true )
+      {
+         queued.wait( lock, [this]() { return stopped || !blocks.empty(); } );
+         if( blocks.empty() )
+            break;
+
+         std::string block = std::move( blocks.front() );
+         blocks.pop_front();
+         lock.unlock();
+
+         bool success = true;
+         try
+         {
+            out.write( block.data(), block.size() );
+            success = out.good();
+         }
+         catch( const std::exception& )
+         {
+            success = false;
+         }
+
+         lock.lock();
+         failed = failed || !success;
+         free.push_back( std::move( block ) );
+      }
+      lock.unlock();
+
+      try
+      {
+         out.reset();
+      }
+      catch( const std::exception& )
+      {
+         failed = true;
+      }
+      file.close();
+      failed = failed || file.fail();
+   }
+};
+
+} // namespace papilo
+
+#endif
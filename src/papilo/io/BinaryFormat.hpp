@@ -0,0 +1,133 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _PAPILO_IO_BINARY_FORMAT_HPP_
+#define _PAPILO_IO_BINARY_FORMAT_HPP_
+
+#include "papilo/Config.hpp"
+#include "papilo/misc/MultiPrecision.hpp"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace papilo
+{
+
+/// Layout of the binary problem format (.pbin): a fixed size header followed
+/// by sections. Every section is a plain array aligned to kAlignment
+/// bytes, so a memory mapped file can be copied into the problem storage
+/// without any parsing. All values are stored in native byte order.
+namespace binary
+{
+
+constexpr char kMagic[8] = { 'P', 'A', 'P', 'I', 'L', 'O', 'B', '\0' };
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr std::size_t kAlignment = 16;
+
+/// type of the stored coefficients and bounds
+enum class ValueType : uint32_t
+{
+   kDouble = 1,
+   kQuad = 2,
+};
+
+enum Section : uint32_t
+{
+   /// objective offset and input tolerance
+   kScalars,
+   kObjective,
+   kLowerBounds,
+   kUpperBounds,
+   kColFlags,
+   kLhs,
+   kRhs,
+   kRowFlags,
+   /// nnz and minInterRowSpace of the row and column storage as int64_t
+   kStorageSizes,
+   /// spareRatio of the row and column storage
+   kStorageSpareRatios,
+   kRowValues,
+   kRowRanges,
+   kRowColumns,
+   kColValues,
+   kColRanges,
+   kColRows,
+   /// offsets of the names into kVariableNames, nCols + 1 uint64_t values
+   kVariableNameStarts,
+   kVariableNames,
+   kConstraintNameStarts,
+   kConstraintNames,
+   kProblemName,
+   kNumSections
+};
+
+struct SectionEntry
+{
+   uint64_t offset;
+   uint64_t size;
+};
+
+struct Header
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t byteOrderMark;
+   uint32_t valueType;
+   uint32_t valueSize;
+   int64_t nCols;
+   int64_t nRows;
+   uint32_t problemFlags;
+   uint32_t nSections;
+   SectionEntry sections[kNumSections];
+};
+
+/// values are stored in the precision of REAL if it can be copied bytewise
+/// and as double otherwise, the BinaryWriter only writes types that are
+/// stored without rounding
+template <typename REAL>
+struct StoredValue
+{
+   static constexpr bool kIsQuad = std::is_same<REAL, Quad>::value &&
+                                   std::is_trivially_copyable<Quad>::value;
+
+   using type = typename std::conditional<kIsQuad, Quad, double>::type;
+
+   static constexpr ValueType kType =
+       kIsQuad ? ValueType::kQuad : ValueType::kDouble;
+
+   /// whether values of type REAL are stored without rounding
+   static constexpr bool kLossless =
+       kIsQuad || std::is_same<REAL, double>::value;
+};
+
+inline uint64_t
+alignedOffset( uint64_t offset )
+{
+   return ( offset + kAlignment - 1 ) / kAlignment * kAlignment;
+}
+
+} // namespace binary
+
+} // namespace papilo
+
+#endif
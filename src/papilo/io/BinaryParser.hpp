@@ -0,0 +1,338 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _PAPILO_IO_BINARY_PARSER_HPP_
+#define _PAPILO_IO_BINARY_PARSER_HPP_
+
+#include "papilo/Config.hpp"
+#include "papilo/core/ConstraintMatrix.hpp"
+#include "papilo/core/Problem.hpp"
+#include "papilo/core/SparseStorage.hpp"
+#include "papilo/io/BinaryFormat.hpp"
+#include "papilo/misc/Vec.hpp"
+#include <boost/optional.hpp>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_MAPPED_FILE
+#include <boost/iostreams/device/mapped_file.hpp>
+#endif
+
+namespace papilo
+{
+
+/// Parser for problems in the binary format written by the BinaryWriter. The
+/// file is memory mapped and its sections are copied into the problem
+/// storage, including the transposed matrix and the spare space of the rows.
+template <typename REAL>
+class BinaryParser
+{
+ public:
+   static boost::optional<Problem<REAL>>
+   loadProblem( const std::string& filename )
+   {
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_MAPPED_FILE
+      boost::iostreams::mapped_file_source mapped;
+      try
+      {
+         mapped.open( filename );
+      }
+      catch( const std::exception& )
+      {
+         return boost::none;
+      }
+      if( !mapped.is_open() )
+         return boost::none;
+
+      return loadProblem( mapped.data(), mapped.size() );
+#else
+      std::ifstream file( filename, std::ifstream::in | std::ifstream::binary );
+      if( !file )
+         return boost::none;
+      std::string content( ( std::istreambuf_iterator<char>( file ) ),
+                           std::istreambuf_iterator<char>() );
+
+      return loadProblem( content.data(), content.size() );
+#endif
+   }
+
+   /// loads a problem from a buffer holding the binary format, e.g. a
+   /// problem embedded into a postsolve archive
+   static boost::optional<Problem<REAL>>
+   loadProblem( const char* data, std::size_t size )
+   {
+      BinaryParser<REAL> parser( data, size );
+      return parser.buildProblem();
+   }
+
+ private:
+   const char* data;
+   std::size_t size;
+   binary::Header header;
+
+   BinaryParser( const char* data_, std::size_t size_ )
+       : data( data_ ), size( size_ )
+   {
+   }
+
+   bool
+   readHeader()
+   {
+      if( size < sizeof( binary::Header ) )
+         return false;
+
+      std::memcpy( &header, data, sizeof( binary::Header ) );
+
+      if( std::memcmp( header.magic, binary::kMagic, sizeof( header.magic ) ) !=
+              0 ||
+          header.version != binary::kVersion ||
+          header.byteOrderMark != binary::kByteOrderMark ||
+          header.nSections != binary::kNumSections || header.nCols < 0 ||
+          header.nRows < 0 )
+         return false;
+
+      switch( static_cast<binary::ValueType>( header.valueType ) )
+      {
+      case binary::ValueType::kDouble:
+         if( header.valueSize != sizeof( double ) )
+            return false;
+         break;
+      case binary::ValueType::kQuad:
+         if( !binary::StoredValue<Quad>::kIsQuad ||
+             header.valueSize != sizeof( Quad ) )
+            return false;
+         break;
+      default:
+         return false;
+      }
+
+      for( const binary::SectionEntry& section : header.sections )
+      {
+         if( section.offset > size || section.size > size - section.offset )
+            return false;
+      }
+
+      return true;
+   }
+
+   template <typename T>
+   bool
+   readArray( binary::Section section, std::size_t expected, Vec<T>& array )
+   {
+      static_assert( std::is_trivially_copyable<T>::value,
+                     "binary sections must be trivially copyable" );
+      const binary::SectionEntry& entry = header.sections[section];
+      if( entry.size != expected * sizeof( T ) )
+         return false;
+
+      array.resize( expected );
+      if( expected != 0 )
+         std::memcpy( array.data(), data + entry.offset, entry.size );
+      return true;
+   }
+
+   static REAL
+   toReal( const REAL& value )
+   {
+      return value;
+   }
+
+   template <typename T>
+   static REAL
+   toReal( const T& value )
+   {
+      return REAL( double( value ) );
+   }
+
+   template <typename T>
+   bool
+   readValues( binary::Section section, std::size_t expected,
+               Vec<REAL>& values )
+   {
+      const binary::SectionEntry& entry = header.sections[section];
+      if( entry.size != expected * sizeof( T ) )
+         return false;
+
+      values.resize( expected );
+      const char* it = data + entry.offset;
+      for( std::size_t i = 0; i < expected; ++i, it += sizeof( T ) )
+      {
+         T value;
+         std::memcpy( &value, it, sizeof( T ) );
+         values[i] = toReal( value );
+      }
+      return true;
+   }
+
+   bool
+   readValues( binary::Section section, std::size_t expected,
+               Vec<REAL>& values )
+   {
+      if( static_cast<binary::ValueType>( header.valueType ) ==
+          binary::ValueType::kQuad )
+         return readValues<typename binary::StoredValue<Quad>::type>(
+             section, expected, values );
+
+      return readValues<double>( section, expected, values );
+   }
+
+   bool
+   readNames( binary::Section startSection, binary::Section nameSection,
+              std::size_t expected, Vec<String>& names )
+   {
+      Vec<uint64_t> starts;
+      if( !readArray( startSection, expected + 1, starts ) )
+         return false;
+
+      const binary::SectionEntry& entry = header.sections[nameSection];
+      const char* blob = data + entry.offset;
+
+      names.clear();
+      names.reserve( expected );
+      for( std::size_t i = 0; i < expected; ++i )
+      {
+         if( starts[i] > starts[i + 1] || starts[i + 1] > entry.size )
+            return false;
+         names.emplace_back( blob + starts[i], starts[i + 1] - starts[i] );
+      }
+      return true;
+   }
+
+   bool
+   readStorage( binary::Section valueSection, binary::Section rangeSection,
+                binary::Section indexSection, int nRows, int nCols,
+                int64_t nnz, int64_t minInterRowSpace, double spareRatio,
+                SparseStorage<REAL>& storage )
+   {
+      std::size_t nAlloc = header.sections[indexSection].size / sizeof( int );
+
+      Vec<REAL> values;
+      Vec<IndexRange> ranges;
+      Vec<int> indices;
+      if( !readValues( valueSection, nAlloc, values ) ||
+          !readArray( rangeSection, nRows + 1, ranges ) ||
+          !readArray( indexSection, nAlloc, indices ) )
+         return false;
+
+      for( const IndexRange& range : ranges )
+      {
+         if( range.start < 0 || range.start > range.end ||
+             range.end > static_cast<int>( nAlloc ) )
+            return false;
+      }
+
+      // the entries of a row of the row storage index columns and vice versa
+      for( int i = 0; i < nRows; ++i )
+      {
+         for( int k = ranges[i].start; k < ranges[i].end; ++k )
+         {
+            if( indices[k] < 0 || indices[k] >= nCols )
+               return false;
+         }
+      }
+
+      storage = SparseStorage<REAL>( std::move( values ), std::move( ranges ),
+                                     std::move( indices ), nRows, nCols,
+                                     static_cast<int>( nnz ), spareRatio,
+                                     static_cast<int>( minInterRowSpace ) );
+      return true;
+   }
+
+   boost::optional<Problem<REAL>>
+   buildProblem()
+   {
+      if( !readHeader() )
+         return boost::none;
+
+      const int nCols = static_cast<int>( header.nCols );
+      const int nRows = static_cast<int>( header.nRows );
+
+      Vec<REAL> scalars;
+      Vec<REAL> objective;
+      Vec<REAL> lower_bounds;
+      Vec<REAL> upper_bounds;
+      Vec<ColFlags> col_flags;
+      Vec<REAL> lhs;
+      Vec<REAL> rhs;
+      Vec<RowFlags> row_flags;
+      Vec<int64_t> sizes;
+      Vec<double> spareRatios;
+      Vec<String> varnames;
+      Vec<String> consnames;
+
+      if( !readValues( binary::kScalars, 2, scalars ) ||
+          !readValues( binary::kObjective, nCols, objective ) ||
+          !readValues( binary::kLowerBounds, nCols, lower_bounds ) ||
+          !readValues( binary::kUpperBounds, nCols, upper_bounds ) ||
+          !readArray( binary::kColFlags, nCols, col_flags ) ||
+          !readValues( binary::kLhs, nRows, lhs ) ||
+          !readValues( binary::kRhs, nRows, rhs ) ||
+          !readArray( binary::kRowFlags, nRows, row_flags ) ||
+          !readArray( binary::kStorageSizes, 4, sizes ) ||
+          !readArray( binary::kStorageSpareRatios, 2, spareRatios ) ||
+          !readNames( binary::kVariableNameStarts, binary::kVariableNames,
+                      nCols, varnames ) ||
+          !readNames( binary::kConstraintNameStarts, binary::kConstraintNames,
+                      nRows, consnames ) )
+         return boost::none;
+
+      SparseStorage<REAL> rows;
+      SparseStorage<REAL> cols;
+      if( !readStorage( binary::kRowValues, binary::kRowRanges,
+                        binary::kRowColumns, nRows, nCols, sizes[0], sizes[1],
+                        spareRatios[0], rows ) ||
+          !readStorage( binary::kColValues, binary::kColRanges,
+                        binary::kColRows, nCols, nRows, sizes[2], sizes[3],
+                        spareRatios[1], cols ) )
+         return boost::none;
+
+      const binary::SectionEntry& name = header.sections[binary::kProblemName];
+
+      Problem<REAL> problem;
+      problem.setObjective( std::move( objective ), scalars[0] );
+      problem.setConstraintMatrix( ConstraintMatrix<REAL>{
+          std::move( rows ), std::move( cols ), std::move( lhs ),
+          std::move( rhs ), std::move( row_flags ) } );
+      problem.setVariableDomains( std::move( lower_bounds ),
+                                  std::move( upper_bounds ),
+                                  std::move( col_flags ) );
+      problem.setVariableNames( std::move( varnames ) );
+      problem.setConstraintNames( std::move( consnames ) );
+      problem.setName( String( data + name.offset, name.size ) );
+
+      for( ProblemFlag flag : { ProblemFlag::kMixedInteger, ProblemFlag::kInteger,
+                                ProblemFlag::kLinear, ProblemFlag::kBinary } )
+      {
+         if( header.problemFlags & static_cast<uint32_t>( flag ) )
+            problem.set_problem_type( flag );
+      }
+
+      problem.setInputTolerance( scalars[1] );
+
+      return problem;
+   }
+};
+
+} // namespace papilo
+
+#endif
@@ -0,0 +1,211 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _PAPILO_IO_BINARY_WRITER_HPP_
+#define _PAPILO_IO_BINARY_WRITER_HPP_
+
+#include "papilo/Config.hpp"
+#include "papilo/core/Problem.hpp"
+#include "papilo/io/BinaryFormat.hpp"
+#include "papilo/misc/Vec.hpp"
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+namespace papilo
+{
+
+/// Writer to write problem structures into the binary problem format that is
+/// loaded by the BinaryParser
+template <typename REAL>
+struct BinaryWriter
+{
+   using Stored = typename binary::StoredValue<REAL>::type;
+
+   /// writes the problem, the names are taken at the given mapping of rows and
+   /// columns like in the MpsWriter; returns false if writing failed or if
+   /// values of type REAL cannot be stored without rounding
+   static bool
+   writeProb( const std::string& filename, const Problem<REAL>& prob,
+              const Vec<int>& row_mapping, const Vec<int>& col_mapping )
+   {
+      std::ofstream out( filename, std::ofstream::out | std::ofstream::binary |
+                                       std::ofstream::trunc );
+      if( !out )
+         return false;
+
+      return writeProb( out, prob, row_mapping, col_mapping );
+   }
+
+   /// writes the problem at the current position of the stream, which should
+   /// be aligned to binary::kAlignment bytes since section offsets are
+   /// relative to it
+   static bool
+   writeProb( std::ostream& out, const Problem<REAL>& prob,
+              const Vec<int>& row_mapping, const Vec<int>& col_mapping )
+   {
+      // reading the file back must give the same problem, hence types that
+      // would be rounded are not written
+      return writeProb(
+          out, prob, row_mapping, col_mapping,
+          std::integral_constant<bool,
+                                 binary::StoredValue<REAL>::kLossless>() );
+   }
+
+ private:
+   struct Sink
+   {
+      std::ostream& out;
+      /// position of the header, section offsets are relative to it
+      uint64_t base;
+      binary::Header header;
+   };
+
+   static bool
+   writeProb( std::ostream&, const Problem<REAL>&, const Vec<int>&,
+              const Vec<int>&, std::false_type )
+   {
+      return false;
+   }
+
+   static bool
+   writeProb( std::ostream& out, const Problem<REAL>& prob,
+              const Vec<int>& row_mapping, const Vec<int>& col_mapping,
+              std::true_type )
+   {
+      Sink sink{ out, static_cast<uint64_t>( out.tellp() ), {} };
+      binary::Header& header = sink.header;
+
+      const ConstraintMatrix<REAL>& consmatrix = prob.getConstraintMatrix();
+      const SparseStorage<REAL>& rows = consmatrix.getConstraintMatrix();
+      const SparseStorage<REAL>& cols = consmatrix.getMatrixTranspose();
+
+      std::memset( &header, 0, sizeof( header ) );
+      std::memcpy( header.magic, binary::kMagic, sizeof( header.magic ) );
+      header.version = binary::kVersion;
+      header.byteOrderMark = binary::kByteOrderMark;
+      header.valueType =
+          static_cast<uint32_t>( binary::StoredValue<REAL>::kType );
+      header.valueSize = sizeof( Stored );
+      header.nCols = prob.getNCols();
+      header.nRows = prob.getNRows();
+      header.nSections = binary::kNumSections;
+
+      for( ProblemFlag flag : { ProblemFlag::kMixedInteger, ProblemFlag::kInteger,
+                                ProblemFlag::kLinear, ProblemFlag::kBinary } )
+      {
+         if( prob.test_problem_type( flag ) )
+            header.problemFlags |= static_cast<uint32_t>( flag );
+      }
+
+      // the header is written again once the sections are known
+      out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+      Vec<REAL> scalars{ prob.getObjective().offset,
+                         prob.getInputTolerance() };
+      writeArray( sink, binary::kScalars, scalars );
+      writeArray( sink, binary::kObjective, prob.getObjective().coefficients );
+      writeArray( sink, binary::kLowerBounds, prob.getLowerBounds() );
+      writeArray( sink, binary::kUpperBounds, prob.getUpperBounds() );
+      writeArray( sink, binary::kColFlags, prob.getColFlags() );
+      writeArray( sink, binary::kLhs, consmatrix.getLeftHandSides() );
+      writeArray( sink, binary::kRhs, consmatrix.getRightHandSides() );
+      writeArray( sink, binary::kRowFlags, prob.getRowFlags() );
+
+      Vec<int64_t> sizes{ rows.getNnz(), rows.getMinInterRowSpace(),
+                          cols.getNnz(), cols.getMinInterRowSpace() };
+      Vec<double> spareRatios{ rows.getSpareRatio(), cols.getSpareRatio() };
+      writeArray( sink, binary::kStorageSizes, sizes );
+      writeArray( sink, binary::kStorageSpareRatios, spareRatios );
+
+      writeArray( sink, binary::kRowValues, rows.getValuesVec() );
+      writeArray( sink, binary::kRowRanges, rows.getRowRangesVec() );
+      writeArray( sink, binary::kRowColumns, rows.getColumnsVec() );
+      writeArray( sink, binary::kColValues, cols.getValuesVec() );
+      writeArray( sink, binary::kColRanges, cols.getRowRangesVec() );
+      writeArray( sink, binary::kColRows, cols.getColumnsVec() );
+
+      writeNames( sink, binary::kVariableNameStarts, binary::kVariableNames,
+                  prob.getVariableNames(), col_mapping );
+      writeNames( sink, binary::kConstraintNameStarts,
+                  binary::kConstraintNames, prob.getConstraintNames(),
+                  row_mapping );
+      writeSection( sink, binary::kProblemName, prob.getName().data(),
+                    prob.getName().size() );
+
+      std::streampos end = out.tellp();
+      out.seekp( sink.base );
+      out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+      out.seekp( end );
+
+      return static_cast<bool>( out );
+   }
+
+   static void
+   writeSection( Sink& sink, binary::Section section, const void* data,
+                 std::size_t size )
+   {
+      uint64_t offset = static_cast<uint64_t>( sink.out.tellp() ) - sink.base;
+      uint64_t aligned = binary::alignedOffset( offset );
+      const char padding[binary::kAlignment] = {};
+      sink.out.write( padding, aligned - offset );
+      if( size != 0 )
+         sink.out.write( static_cast<const char*>( data ), size );
+
+      sink.header.sections[section].offset = aligned;
+      sink.header.sections[section].size = size;
+   }
+
+   template <typename T>
+   static void
+   writeArray( Sink& sink, binary::Section section, const Vec<T>& array )
+   {
+      static_assert( std::is_trivially_copyable<T>::value,
+                     "binary sections must be trivially copyable" );
+      writeSection( sink, section, array.data(), array.size() * sizeof( T ) );
+   }
+
+   static void
+   writeNames( Sink& sink, binary::Section startSection,
+               binary::Section nameSection,
+               const Vec<String>& names, const Vec<int>& mapping )
+   {
+      Vec<uint64_t> starts;
+      starts.reserve( mapping.size() + 1 );
+      starts.push_back( 0 );
+
+      String blob;
+      for( int index : mapping )
+      {
+         if( index >= 0 && index < static_cast<int>( names.size() ) )
+            blob += names[index];
+         starts.push_back( blob.size() );
+      }
+
+      writeArray( sink, startSection, starts );
+      writeSection( sink, nameSection, blob.data(), blob.size() );
+   }
+};
+
+} // namespace papilo
+
+#endif
@@ -32,6 +32,7 @@
 #include "papilo/external/pdqsort/pdqsort.h"
 #include "papilo/io/BoundType.hpp"
 #include "papilo/io/ParseKey.hpp"
+#include "papilo/io/PipelinedDecompressor.hpp"
 #include "papilo/misc/Flags.hpp"
 #include "papilo/misc/Hash.hpp"
 #include "papilo/misc/Num.hpp"
@@ -42,6 +43,7 @@
 #include <boost/optional.hpp>
 #include <boost/spirit/include/qi.hpp>
 #include <boost/utility/string_ref.hpp>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
@@ -56,6 +58,13 @@
 #ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
 #include <boost/iostreams/filter/gzip.hpp>
 #endif
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_MAPPED_FILE
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#endif
+#ifdef PAPILO_TBB
+#include "papilo/misc/tbb.hpp"
+#endif
 
 namespace papilo
 {
@@ -81,13 +90,21 @@ class MpsParser
        "the parse type must be a floating point type" );
 
  public:
+   /// default size in bytes of the chunks of the COLUMNS section that are
+   /// parsed in parallel if the file is memory mapped, a chunk size of 0
+   /// parses the file as a stream instead
+   static constexpr std::size_t kDefaultChunkSize = std::size_t{ 1 } << 22;
+
    static boost::optional<Problem<REAL>>
-   loadProblem( const std::string& filename )
+   loadProblem( const std::string& filename,
+                std::size_t chunkSize = kDefaultChunkSize )
    {
       MpsParser<REAL> parser;
 
       Problem<REAL> problem;
 
+      parser.chunkSize = chunkSize;
+
       if( !parser.parseFile( filename ) )
          return boost::none;
 
@@ -138,6 +155,53 @@ class MpsParser
    bool
    parse( boost::iostreams::filtering_istream& file );
 
+   /// parses the sections starting with the given keyword until the end of
+   /// the file or, if stopAtColumns is set, until the COLUMNS section starts
+   ParseKey
+   parseSections( boost::iostreams::filtering_istream& file, ParseKey keyword,
+                  ParseKey& keyword_old, bool stopAtColumns );
+
+   bool
+   finishParse( ParseKey keyword, ParseKey keyword_old );
+
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_MAPPED_FILE
+   /// columns and coefficients found in one chunk of the COLUMNS section
+   struct ColumnChunk
+   {
+      /// names of the columns starting in this chunk; the first one might
+      /// continue the last column of the previous chunk
+      Vec<std::string> names;
+      /// start of the entries of each column (names.size() + 1 values)
+      Vec<int> start;
+      /// number of integrality markers in this chunk before each column
+      Vec<int> markersBefore;
+      /// integrality markers in order: 1 for INTORG and 0 for INTEND
+      Vec<uint8_t> markers;
+      /// pairs of row index and coefficient sorted by row within a column
+      Vec<std::pair<int, REAL>> entries;
+      /// pairs of local column index and objective coefficient
+      Vec<std::pair<int, REAL>> objective;
+      /// keyword of the section that ended the COLUMNS section in this chunk
+      ParseKey key = ParseKey::kNone;
+      /// first character after the line containing the section keyword
+      const char* rest = nullptr;
+      bool failed = false;
+   };
+
+   /// memory maps uncompressed files and parses the COLUMNS section in
+   /// parallel chunks
+   bool
+   parseMappedFile( const std::string& filename );
+
+   void
+   parseColumnChunk( const char* begin, const char* end,
+                     ColumnChunk& chunk ) const;
+
+   ParseKey
+   parseColumnsParallel( const char* begin, const char* end,
+                         const char*& rest );
+#endif
+
    void
    printErrorMessage( ParseKey keyword )
    {
@@ -188,6 +252,8 @@ class MpsParser
    int nRows = 0;
    int nnz = -1;
 
+   std::size_t chunkSize = kDefaultChunkSize;
+
    /// checks first word of strline and wraps it by it_begin and it_end
    ParseKey
    checkFirstWord( std::string& strline, std::string::iterator& it,
@@ -823,6 +889,27 @@ template <typename REAL>
 bool
 MpsParser<REAL>::parseFile( const std::string& filename )
 {
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_MAPPED_FILE
+   // uncompressed files are memory mapped and parsed in parallel
+   if( chunkSize != 0 && !boost::algorithm::ends_with( filename, ".gz" ) &&
+       !boost::algorithm::ends_with( filename, ".bz2" ) )
+      return parseMappedFile( filename );
+#endif
+
+   if( boost::algorithm::ends_with( filename, ".gz" ) ||
+       boost::algorithm::ends_with( filename, ".bz2" ) )
+   {
+      // decompress on a background thread while parsing
+      PipelinedDecompressor decompressor;
+      if( decompressor.start( filename ) )
+      {
+         boost::iostreams::filtering_istream in;
+         in.push( decompressor.source() );
+         // a corrupt or truncated file ends the stream early
+         return parse( in ) && !decompressor.failed();
+      }
+   }
+
    std::ifstream file( filename, std::ifstream::in );
    boost::iostreams::filtering_istream in;
 
@@ -849,13 +936,26 @@ bool
 MpsParser<REAL>::parse( boost::iostreams::filtering_istream& file )
 {
    nnz = 0;
-   ParseKey keyword = ParseKey::kNone;
    ParseKey keyword_old = ParseKey::kNone;
+   ParseKey keyword =
+       parseSections( file, ParseKey::kNone, keyword_old, false );
 
+   return finishParse( keyword, keyword_old );
+}
+
+template <typename REAL>
+ParseKey
+MpsParser<REAL>::parseSections( boost::iostreams::filtering_istream& file,
+                                ParseKey keyword, ParseKey& keyword_old,
+                                bool stopAtColumns )
+{
    // parsing loop
    while( keyword != ParseKey::kFail && keyword != ParseKey::kEnd &&
           !file.eof() && file.good() )
    {
+      if( stopAtColumns && keyword == ParseKey::kCols )
+         break;
+
       keyword_old = keyword;
       switch( keyword )
       {
@@ -882,6 +982,13 @@ MpsParser<REAL>::parse( boost::iostreams::filtering_istream& file )
       }
    }
 
+   return keyword;
+}
+
+template <typename REAL>
+bool
+MpsParser<REAL>::finishParse( ParseKey keyword, ParseKey keyword_old )
+{
    if( keyword == ParseKey::kFail || keyword != ParseKey::kEnd )
    {
       printErrorMessage( keyword_old );
@@ -896,6 +1003,425 @@ MpsParser<REAL>::parse( boost::iostreams::filtering_istream& file )
    return true;
 }
 
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_MAPPED_FILE
+
+namespace mps
+{
+
+inline bool
+isSpace( char c )
+{
+   return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' ||
+          c == '\f';
+}
+
+/// splits the line [begin,end) into at most maxtokens whitespace separated
+/// tokens and returns their number
+inline int
+tokenize( const char* begin, const char* end, boost::string_ref* tokens,
+          int maxtokens )
+{
+   int ntokens = 0;
+   const char* it = begin;
+   while( ntokens < maxtokens )
+   {
+      while( it != end && isSpace( *it ) )
+         ++it;
+      if( it == end )
+         break;
+      const char* tokstart = it;
+      while( it != end && !isSpace( *it ) )
+         ++it;
+      tokens[ntokens++] = boost::string_ref( tokstart, it - tokstart );
+   }
+   return ntokens;
+}
+
+/// returns the end of the line starting at begin (excluding the newline)
+inline const char*
+lineEnd( const char* begin, const char* end )
+{
+   const void* newline = std::memchr( begin, '\n', end - begin );
+   return newline == nullptr ? end : static_cast<const char*>( newline );
+}
+
+inline ParseKey
+sectionKey( boost::string_ref word )
+{
+   if( word.empty() )
+      return ParseKey::kNone;
+   if( word.front() == 'R' )
+   {
+      if( word == "ROWS" )
+         return ParseKey::kRows;
+      else if( word == "RHS" )
+         return ParseKey::kRhs;
+      else if( word == "RANGES" )
+         return ParseKey::kRanges;
+      return ParseKey::kNone;
+   }
+   else if( word == "COLUMNS" )
+      return ParseKey::kCols;
+   else if( word == "BOUNDS" )
+      return ParseKey::kBounds;
+   else if( word == "ENDATA" )
+      return ParseKey::kEnd;
+   return ParseKey::kNone;
+}
+
+} // namespace mps
+
+template <typename REAL>
+bool
+MpsParser<REAL>::parseMappedFile( const std::string& filename )
+{
+   boost::iostreams::mapped_file_source mapped;
+
+   try
+   {
+      mapped.open( filename );
+   }
+   catch( const std::exception& )
+   {
+      return false;
+   }
+
+   if( !mapped.is_open() )
+      return false;
+
+   const char* data = mapped.data();
+   const char* dataend = data + mapped.size();
+
+   // everything up to the COLUMNS section is parsed by the streaming parser
+   const char* colsbegin = nullptr;
+   for( const char* line = data; line < dataend; )
+   {
+      const char* lineend = mps::lineEnd( line, dataend );
+      boost::string_ref word;
+      if( mps::tokenize( line, lineend, &word, 1 ) == 1 &&
+          mps::sectionKey( word ) == ParseKey::kCols )
+      {
+         colsbegin = lineend == dataend ? dataend : lineend + 1;
+         break;
+      }
+      line = lineend + 1;
+   }
+
+   nnz = 0;
+   ParseKey keyword_old = ParseKey::kNone;
+
+   if( colsbegin == nullptr )
+   {
+      boost::iostreams::filtering_istream in;
+      in.push( boost::iostreams::array_source( data, dataend ) );
+      ParseKey keyword =
+          parseSections( in, ParseKey::kNone, keyword_old, false );
+      return finishParse( keyword, keyword_old );
+   }
+
+   ParseKey keyword;
+   {
+      boost::iostreams::filtering_istream head;
+      head.push( boost::iostreams::array_source( data, colsbegin ) );
+      keyword = parseSections( head, ParseKey::kNone, keyword_old, true );
+   }
+
+   if( keyword != ParseKey::kCols )
+      return finishParse( keyword, keyword_old );
+
+   keyword_old = ParseKey::kCols;
+   const char* rest = dataend;
+   keyword = parseColumnsParallel( colsbegin, dataend, rest );
+
+   if( keyword == ParseKey::kFail || keyword == ParseKey::kEnd ||
+       rest == dataend )
+      return finishParse( keyword, keyword_old );
+
+   boost::iostreams::filtering_istream tail;
+   tail.push( boost::iostreams::array_source( rest, dataend ) );
+   keyword = parseSections( tail, keyword, keyword_old, false );
+
+   return finishParse( keyword, keyword_old );
+}
+
+template <typename REAL>
+void
+MpsParser<REAL>::parseColumnChunk( const char* begin, const char* end,
+                                   ColumnChunk& chunk ) const
+{
+   using namespace boost::spirit;
+   using RealType = typename RealParseType<REAL>::type;
+
+   boost::string_ref tokens[3];
+   boost::string_ref current;
+   std::string rowname;
+
+   auto finishColumn = [&chunk]() {
+      if( chunk.names.empty() )
+         return;
+      pdqsort( chunk.entries.begin() + chunk.start.back(),
+               chunk.entries.end(),
+               []( const std::pair<int, REAL>& a,
+                   const std::pair<int, REAL>& b ) {
+                  return a.first < b.first;
+               } );
+   };
+
+   for( const char* line = begin; line < end; )
+   {
+      const char* lineend = mps::lineEnd( line, end );
+      const char* next = lineend == end ? end : lineend + 1;
+      int ntokens = mps::tokenize( line, lineend, tokens, 3 );
+
+      if( ntokens == 0 )
+      {
+         line = next;
+         continue;
+      }
+
+      ParseKey key = mps::sectionKey( tokens[0] );
+      if( key != ParseKey::kNone )
+      {
+         chunk.key = key;
+         chunk.rest = next;
+         break;
+      }
+
+      // integrality marker
+      if( ntokens >= 2 && tokens[1] == "'MARKER'" )
+      {
+         if( ntokens < 3 ||
+             ( tokens[2] != "'INTORG'" && tokens[2] != "'INTEND'" ) )
+         {
+            chunk.failed = true;
+            return;
+         }
+         chunk.markers.push_back( tokens[2] == "'INTORG'" ? 1 : 0 );
+         line = next;
+         continue;
+      }
+
+      // new column?
+      if( chunk.names.empty() || tokens[0] != current )
+      {
+         finishColumn();
+         current = tokens[0];
+         chunk.names.emplace_back( current.data(), current.size() );
+         chunk.start.push_back( static_cast<int>( chunk.entries.size() ) );
+         chunk.markersBefore.push_back(
+             static_cast<int>( chunk.markers.size() ) );
+      }
+
+      int localcol = static_cast<int>( chunk.names.size() ) - 1;
+      int npairs = 0;
+      const char* it = tokens[0].data() + tokens[0].size();
+
+      while( true )
+      {
+         boost::string_ref pair[2];
+         if( mps::tokenize( it, lineend, pair, 2 ) != 2 )
+            break;
+         it = pair[1].data() + pair[1].size();
+
+         rowname.assign( pair[0].data(), pair[0].size() );
+         auto mit = rowname2idx.find( rowname );
+         if( mit == rowname2idx.end() )
+            break;
+
+         RealType val;
+         const char* numit = pair[1].data();
+         const char* numend = numit + pair[1].size();
+         if( !qi::parse( numit, numend, qi::real_parser<RealType>(), val ) ||
+             numit != numend )
+            break;
+
+         if( mit->second >= 0 )
+            chunk.entries.emplace_back( mit->second, REAL{ val } );
+         else
+            chunk.objective.emplace_back( localcol, REAL{ val } );
+         ++npairs;
+      }
+
+      if( npairs == 0 )
+      {
+         chunk.failed = true;
+         return;
+      }
+
+      line = next;
+   }
+
+   finishColumn();
+   chunk.start.push_back( static_cast<int>( chunk.entries.size() ) );
+}
+
+template <typename REAL>
+ParseKey
+MpsParser<REAL>::parseColumnsParallel( const char* begin, const char* end,
+                                       const char*& rest )
+{
+   // split the section into chunks at line boundaries
+   std::size_t length = end - begin;
+   std::size_t nchunks = length / chunkSize + 1;
+   Vec<const char*> bounds;
+   bounds.reserve( nchunks + 1 );
+   bounds.push_back( begin );
+   for( std::size_t i = 1; i < nchunks; ++i )
+   {
+      const char* b = std::max( begin + i * chunkSize, bounds.back() );
+      if( b >= end )
+         break;
+      b = mps::lineEnd( b, end );
+      if( b != end )
+         ++b;
+      if( b != bounds.back() && b < end )
+         bounds.push_back( b );
+   }
+   bounds.push_back( end );
+   nchunks = bounds.size() - 1;
+
+   Vec<ColumnChunk> chunks( nchunks );
+
+#ifdef PAPILO_TBB
+   tbb::parallel_for( tbb::blocked_range<std::size_t>( 0, nchunks, 1 ),
+                      [&]( const tbb::blocked_range<std::size_t>& r ) {
+                         for( std::size_t i = r.begin(); i != r.end(); ++i )
+                            parseColumnChunk( bounds[i], bounds[i + 1],
+                                              chunks[i] );
+                      } );
+#else
+   for( std::size_t i = 0; i < nchunks; ++i )
+      parseColumnChunk( bounds[i], bounds[i + 1], chunks[i] );
+#endif
+
+   // the COLUMNS section ends in the first chunk that found a new section,
+   // all later chunks parsed lines of other sections and are ignored
+   std::size_t lastchunk = 0;
+   while( lastchunk < nchunks && chunks[lastchunk].key == ParseKey::kNone &&
+          !chunks[lastchunk].failed )
+      ++lastchunk;
+
+   if( lastchunk == nchunks || chunks[lastchunk].failed )
+      return ParseKey::kFail;
+
+   // merge the chunks into the triplet list
+   Vec<int> entryoffset( lastchunk + 2 );
+   Vec<int> coloffset( lastchunk + 1 );
+   Vec<uint8_t> continued( lastchunk + 1, 0 );
+   entryoffset[0] = static_cast<int>( entries.size() );
+   bool integral_cols = false;
+
+   auto applyMarker = [&integral_cols]( uint8_t intorg ) {
+      if( ( integral_cols && intorg != 0 ) || ( !integral_cols && intorg != 1 ) )
+      {
+         std::cerr << "integrality marker error " << std::endl;
+         return false;
+      }
+      integral_cols = !integral_cols;
+      return true;
+   };
+
+   for( std::size_t c = 0; c <= lastchunk; ++c )
+   {
+      const ColumnChunk& chunk = chunks[c];
+      entryoffset[c + 1] =
+          entryoffset[c] + static_cast<int>( chunk.entries.size() );
+
+      // the first column might continue the last column of the previous chunk
+      continued[c] = !chunk.names.empty() && !colnames.empty() &&
+                     chunk.names[0] == colnames.back();
+      coloffset[c] = static_cast<int>( colnames.size() ) - continued[c];
+
+      std::size_t nmarkers = 0;
+      for( std::size_t j = 0; j < chunk.names.size(); ++j )
+      {
+         for( ; nmarkers < std::size_t( chunk.markersBefore[j] ); ++nmarkers )
+            if( !applyMarker( chunk.markers[nmarkers] ) )
+               return ParseKey::kFail;
+
+         if( j == 0 && continued[c] )
+            continue;
+
+         auto ret = colname2idx.emplace( chunk.names[j],
+                                         static_cast<int>( colnames.size() ) );
+         colnames.push_back( chunk.names[j] );
+
+         if( !ret.second )
+         {
+            std::cerr << "duplicate column " << std::endl;
+            return ParseKey::kFail;
+         }
+
+         col_flags.emplace_back( integral_cols ? ColFlag::kIntegral
+                                               : ColFlag::kNone );
+
+         // initialize with default bounds
+         lb4cols.push_back( REAL{ 0.0 } );
+         if( integral_cols )
+            ub4cols.push_back( REAL{ 1.0 } );
+         else
+         {
+            ub4cols.push_back( REAL{ 0.0 } );
+            col_flags.back().set( ColFlag::kUbInf );
+         }
+      }
+
+      for( ; nmarkers < chunk.markers.size(); ++nmarkers )
+         if( !applyMarker( chunk.markers[nmarkers] ) )
+            return ParseKey::kFail;
+
+      for( const auto& obj : chunk.objective )
+         coeffobj.emplace_back( coloffset[c] + obj.first, obj.second );
+   }
+
+   entries.resize( entryoffset[lastchunk + 1] );
+
+   auto fillChunk = [&]( std::size_t c ) {
+      const ColumnChunk& chunk = chunks[c];
+      for( std::size_t j = 0; j < chunk.names.size(); ++j )
+      {
+         int col = coloffset[c] + static_cast<int>( j );
+         for( int k = chunk.start[j]; k < chunk.start[j + 1]; ++k )
+            entries[entryoffset[c] + k] = std::make_tuple(
+                col, chunk.entries[k].first, chunk.entries[k].second );
+      }
+   };
+
+#ifdef PAPILO_TBB
+   tbb::parallel_for( tbb::blocked_range<std::size_t>( 0, lastchunk + 1, 1 ),
+                      [&]( const tbb::blocked_range<std::size_t>& r ) {
+                         for( std::size_t c = r.begin(); c != r.end(); ++c )
+                            fillChunk( c );
+                      } );
+#else
+   for( std::size_t c = 0; c <= lastchunk; ++c )
+      fillChunk( c );
+#endif
+
+   // columns split between two chunks need to be sorted again
+   for( std::size_t c = 1; c <= lastchunk; ++c )
+   {
+      if( !continued[c] )
+         continue;
+
+      auto first = entries.begin() + entryoffset[c];
+      while( first != entries.begin() &&
+             std::get<0>( *( first - 1 ) ) == coloffset[c] )
+         --first;
+      pdqsort( first, entries.begin() + entryoffset[c] + chunks[c].start[1],
+               []( const Triplet<REAL>& a, const Triplet<REAL>& b ) {
+                  return std::get<1>( a ) < std::get<1>( b );
+               } );
+   }
+
+   nnz += entryoffset[lastchunk + 1] - entryoffset[0];
+   rest = chunks[lastchunk].rest;
+
+   return chunks[lastchunk].key;
+}
+
+#endif
+
 } // namespace papilo
 
 #endif /* _PARSING_MPS_PARSER_HPP_ */
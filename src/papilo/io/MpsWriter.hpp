@@ -28,10 +28,12 @@
 #include "papilo/misc/Vec.hpp"
 #include "papilo/misc/fmt.hpp"
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <string>
 
 #ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_BZIP2
 #include <boost/iostreams/filter/bzip2.hpp>
@@ -39,17 +41,30 @@
 #ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
 #include <boost/iostreams/filter/gzip.hpp>
 #endif
+#ifdef PAPILO_TBB
+#include "papilo/misc/tbb.hpp"
+#endif
 
 namespace papilo
 {
 
-/// Writer to write problem structures into an mps file
+/// Writer to write problem structures into an mps file. The sections are
+/// split into blocks of lines that are formatted into memory buffers in
+/// parallel and written in order. For gzip output every block is compressed
+/// in parallel into a gzip member of its own, which gzip readers concatenate.
 template <typename REAL>
 struct MpsWriter
 {
+   /// number of lines formatted into one block
+   static constexpr int kLinesPerBlock = 8192;
+
+   /// number of blocks formatted in parallel before they are written
+   static constexpr std::size_t kBlocksPerBatch = 64;
+
    static void
    writeProb( const std::string& filename, const Problem<REAL>& prob,
-              const Vec<int>& row_mapping, const Vec<int>& col_mapping )
+              const Vec<int>& row_mapping, const Vec<int>& col_mapping,
+              int linesPerBlock = kLinesPerBlock )
    {
       const ConstraintMatrix<REAL>& consmatrix = prob.getConstraintMatrix();
       const Vec<std::string>& consnames = prob.getConstraintNames();
@@ -59,64 +74,97 @@ struct MpsWriter
       const Objective<REAL>& obj = prob.getObjective();
       const Vec<ColFlags>& col_flags = prob.getColFlags();
       const Vec<RowFlags>& row_flags = prob.getRowFlags();
+      const int nrows = consmatrix.getNRows();
+      const int ncols = consmatrix.getNCols();
+
+      assert( linesPerBlock > 0 );
+
+      BlockWriter out( filename );
+
+      // the names padded to the field width are looked up once per row and
+      // column instead of once per nonzero
+      Vec<std::string> rownames( nrows );
+      Vec<std::string> colnames( ncols );
+      forEachBlock( nrows, linesPerBlock, [&]( int begin, int end ) {
+         for( int i = begin; i < end; ++i )
+            rownames[i] = fmt::format( "{: <9}", consnames[row_mapping[i]] );
+      } );
+      forEachBlock( ncols, linesPerBlock, [&]( int begin, int end ) {
+         for( int i = begin; i < end; ++i )
+         {
+            if( !col_flags[i].test( ColFlag::kInactive ) )
+               colnames[i] =
+                   fmt::format( "{: <9}", varnames[col_mapping[i]] );
+         }
+      } );
 
-      std::ofstream file( filename, std::ofstream::out );
-      boost::iostreams::filtering_ostream out;
-
-#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
-      if( boost::algorithm::ends_with( filename, ".gz" ) )
-         out.push( boost::iostreams::gzip_compressor() );
-#endif
-
-#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_BZIP2
-      if( boost::algorithm::ends_with( filename, ".bz2" ) )
-         out.push( boost::iostreams::bzip2_compressor() );
-#endif
-
-      out.push( file );
-
-      fmt::print( out, "*ROWS:         {}\n", consmatrix.getNRows() );
-      fmt::print( out, "*COLUMNS:      {}\n", consmatrix.getNCols() );
-      fmt::print( out, "*INTEGER:      {}\n", prob.getNumIntegralCols() );
-      fmt::print( out, "*NONZERO:      {}\n*\n*\n", consmatrix.getNnz() );
-
-      fmt::print( out, "NAME          {}\n", prob.getName() );
-      fmt::print( out, "ROWS\n" );
-      fmt::print( out, " N  OBJ\n" );
       bool hasRangedRow = false;
-      for( int i = 0; i < consmatrix.getNRows(); ++i )
+      for( int i = 0; i < nrows; ++i )
       {
          assert( !consmatrix.isRowRedundant( i ) );
-         char type;
-
-         if( row_flags[i].test( RowFlag::kLhsInf ) &&
-             row_flags[i].test( RowFlag::kRhsInf ) )
-            type = 'N';
-         else if( row_flags[i].test( RowFlag::kRhsInf ) )
-            type = 'G';
-         else if( row_flags[i].test( RowFlag::kLhsInf ) )
-            type = 'L';
-         else
-         {
-            if( !row_flags[i].test( RowFlag::kEquation ) )
-               hasRangedRow = true;
-            type = 'E';
-         }
-
-         fmt::print( out, " {}  {}\n", type, consnames[row_mapping[i]] );
+         if( !row_flags[i].test( RowFlag::kLhsInf, RowFlag::kRhsInf,
+                                 RowFlag::kEquation ) )
+            hasRangedRow = true;
       }
 
-      fmt::print( out, "COLUMNS\n" );
+      out.write( [&]( fmt::memory_buffer& buffer ) {
+         fmt::format_to( buffer, "*ROWS:         {}\n", nrows );
+         fmt::format_to( buffer, "*COLUMNS:      {}\n", ncols );
+         fmt::format_to( buffer, "*INTEGER:      {}\n",
+                         prob.getNumIntegralCols() );
+         fmt::format_to( buffer, "*NONZERO:      {}\n*\n*\n",
+                         consmatrix.getNnz() );
+
+         fmt::format_to( buffer, "NAME          {}\n", prob.getName() );
+         fmt::format_to( buffer, "ROWS\n" );
+         fmt::format_to( buffer, " N  OBJ\n" );
+      } );
+
+      out.writeBlocks(
+          blockStarts( nrows, linesPerBlock ),
+          [&]( fmt::memory_buffer& buffer, int begin, int end ) {
+             for( int i = begin; i < end; ++i )
+             {
+                char type;
+
+                if( row_flags[i].test( RowFlag::kLhsInf ) &&
+                    row_flags[i].test( RowFlag::kRhsInf ) )
+                   type = 'N';
+                else if( row_flags[i].test( RowFlag::kRhsInf ) )
+                   type = 'G';
+                else if( row_flags[i].test( RowFlag::kLhsInf ) )
+                   type = 'L';
+                else
+                   type = 'E';
+
+                fmt::format_to( buffer, " {}  {}\n", type,
+                                consnames[row_mapping[i]] );
+             }
+          } );
+
+      out.write( []( fmt::memory_buffer& buffer ) {
+         fmt::format_to( buffer, "COLUMNS\n" );
+      } );
 
       int hasintegral = prob.getNumIntegralCols() != 0;
+      Vec<int> cols;
+      Vec<int> starts;
 
       for( int integral = 0; integral <= hasintegral; ++integral )
       {
          if( integral )
-            fmt::print( out,
-                        "    MARK0000  'MARKER'                 'INTORG'\n" );
-
-         for( int i = 0; i < consmatrix.getNCols(); ++i )
+            out.write( []( fmt::memory_buffer& buffer ) {
+               fmt::format_to(
+                   buffer,
+                   "    MARK0000  'MARKER'                 'INTORG'\n" );
+            } );
+
+         // collect the columns of this pass and split them into blocks of
+         // about linesPerBlock objective and matrix entries
+         cols.clear();
+         starts.clear();
+         int lines = 0;
+         for( int i = 0; i < ncols; ++i )
          {
             if( col_flags[i].test( ColFlag::kInactive ) )
                continue;
@@ -128,133 +176,333 @@ struct MpsWriter
             assert(
                 !col_flags[i].test( ColFlag::kFixed, ColFlag::kSubstituted ) );
 
-            if( obj.coefficients[i] != 0.0 )
+            if( cols.empty() || lines >= linesPerBlock )
             {
-               fmt::print( out, "    {: <9} OBJ       {:.15}\n",
-                           varnames[col_mapping[i]],
-                           double( obj.coefficients[i] ) );
+               starts.push_back( static_cast<int>( cols.size() ) );
+               lines = 0;
             }
+            cols.push_back( i );
+            lines += 1 + consmatrix.getColSizes()[i];
+         }
+         starts.push_back( static_cast<int>( cols.size() ) );
 
-            SparseVectorView<REAL> column =
-                consmatrix.getColumnCoefficients( i );
+         out.writeBlocks( starts, [&]( fmt::memory_buffer& buffer, int begin,
+                                       int end ) {
+            for( int k = begin; k < end; ++k )
+            {
+               int i = cols[k];
+               const std::string& colname = colnames[i];
 
-            const int* rowinds = column.getIndices();
-            const REAL* colvals = column.getValues();
-            int len = column.getLength();
+               bool declared = obj.coefficients[i] != 0.0;
 
-            for( int j = 0; j < len; ++j )
-            {
-               int r = rowinds[j];
+               if( declared )
+               {
+                  fmt::format_to( buffer, "    {} OBJ       {:.15}\n",
+                                  colname, double( obj.coefficients[i] ) );
+               }
 
-               // discard redundant rows when writing problem
-               if( consmatrix.isRowRedundant( r ) )
-                  continue;
+               SparseVectorView<REAL> column =
+                   consmatrix.getColumnCoefficients( i );
+
+               const int* rowinds = column.getIndices();
+               const REAL* colvals = column.getValues();
+               int len = column.getLength();
 
-               // normal row
-               fmt::print( out, "    {: <9} {: <9} {:.15}\n",
-                           varnames[col_mapping[i]], consnames[row_mapping[r]],
-                           double( colvals[j] ) );
+               for( int j = 0; j < len; ++j )
+               {
+                  int r = rowinds[j];
+
+                  // discard redundant rows when writing problem
+                  if( consmatrix.isRowRedundant( r ) )
+                     continue;
+
+                  // normal row
+                  fmt::format_to( buffer, "    {} {} {:.15}\n", colname,
+                                  rownames[r], double( colvals[j] ) );
+                  declared = true;
+               }
+
+               // empty columns need an entry to be known in the BOUNDS section
+               if( !declared )
+                  fmt::format_to( buffer, "    {} OBJ       0\n", colname );
             }
-         }
+         } );
 
          if( integral )
-            fmt::print( out,
-                        "    MARK0000  'MARKER'                 'INTEND'\n" );
+            out.write( []( fmt::memory_buffer& buffer ) {
+               fmt::format_to(
+                   buffer,
+                   "    MARK0000  'MARKER'                 'INTEND'\n" );
+            } );
       }
 
       const Vec<REAL>& lower_bounds = prob.getLowerBounds();
       const Vec<REAL>& upper_bounds = prob.getUpperBounds();
 
-      fmt::print( out, "RHS\n" );
+      out.write( [&]( fmt::memory_buffer& buffer ) {
+         fmt::format_to( buffer, "RHS\n" );
 
-      if( obj.offset != 0 )
+         if( obj.offset != 0 )
+         {
+            if( obj.offset != REAL{ 0.0 } )
+               fmt::format_to( buffer, "    B         {: <9} {:.15}\n", "OBJ",
+                               double( REAL( -obj.offset ) ) );
+         }
+      } );
+
+      out.writeBlocks(
+          blockStarts( nrows, linesPerBlock ),
+          [&]( fmt::memory_buffer& buffer, int begin, int end ) {
+             for( int i = begin; i < end; ++i )
+             {
+                // discard redundant rows when writing problem
+                if( consmatrix.isRowRedundant( i ) )
+                   continue;
+
+                if( row_flags[i].test( RowFlag::kLhsInf ) &&
+                    row_flags[i].test( RowFlag::kRhsInf ) )
+                   continue;
+
+                if( row_flags[i].test( RowFlag::kLhsInf ) )
+                {
+                   if( rhs[i] != REAL{ 0.0 } )
+                      fmt::format_to( buffer, "    B         {} {:.15}\n",
+                                      rownames[i], double( rhs[i] ) );
+                }
+                else
+                {
+                   if( lhs[i] != REAL{ 0.0 } )
+                      fmt::format_to( buffer, "    B         {} {:.15}\n",
+                                      rownames[i], double( lhs[i] ) );
+                }
+             }
+          } );
+
+      if( hasRangedRow )
       {
-         if( obj.offset != REAL{ 0.0 } )
-            fmt::print( out, "    B         {: <9} {:.15}\n", "OBJ",
-                        double( REAL( -obj.offset ) ) );
+         out.write( []( fmt::memory_buffer& buffer ) {
+            fmt::format_to( buffer, "RANGES\n" );
+         } );
+
+         out.writeBlocks(
+             blockStarts( nrows, linesPerBlock ),
+             [&]( fmt::memory_buffer& buffer, int begin, int end ) {
+                for( int i = begin; i < end; ++i )
+                {
+                   if( row_flags[i].test( RowFlag::kLhsInf, RowFlag::kRhsInf,
+                                          RowFlag::kEquation,
+                                          RowFlag::kRedundant ) )
+                      continue;
+
+                   double rangeval = double( REAL( rhs[i] - lhs[i] ) );
+
+                   if( rangeval != 0 )
+                   {
+                      fmt::format_to( buffer, "    B         {} {:.15}\n",
+                                      rownames[i], rangeval );
+                   }
+                }
+             } );
       }
 
-      for( int i = 0; i < consmatrix.getNRows(); ++i )
-      {
-         // discard redundant rows when writing problem
-         if( consmatrix.isRowRedundant( i ) )
-            continue;
+      out.write( []( fmt::memory_buffer& buffer ) {
+         fmt::format_to( buffer, "BOUNDS\n" );
+      } );
+
+      out.writeBlocks(
+          blockStarts( ncols, linesPerBlock ),
+          [&]( fmt::memory_buffer& buffer, int begin, int end ) {
+             for( int i = begin; i < end; ++i )
+             {
+                if( col_flags[i].test( ColFlag::kInactive ) )
+                   continue;
+
+                const std::string& colname = colnames[i];
+
+                if( !col_flags[i].test( ColFlag::kLbInf ) &&
+                    !col_flags[i].test( ColFlag::kUbInf ) &&
+                    lower_bounds[i] == upper_bounds[i] )
+                {
+                   fmt::format_to( buffer, " FX BND       {} {:.15}\n",
+                                   colname, double( lower_bounds[i] ) );
+                }
+                else
+                {
+                   if( col_flags[i].test( ColFlag::kLbInf ) ||
+                       lower_bounds[i] != 0.0 )
+                   {
+                      if( col_flags[i].test( ColFlag::kLbInf ) )
+                         fmt::format_to( buffer, " MI BND       {}\n",
+                                         varnames[col_mapping[i]] );
+                      else
+                         fmt::format_to( buffer, " LO BND       {} {:.15}\n",
+                                         colname, double( lower_bounds[i] ) );
+                   }
+
+                   if( !col_flags[i].test( ColFlag::kUbInf ) )
+                      fmt::format_to( buffer, " UP BND       {} {:.15}\n",
+                                      colname, double( upper_bounds[i] ) );
+                   else
+                      fmt::format_to( buffer, " PL BND       {}\n", colname );
+                }
+             }
+          } );
+
+      out.write( []( fmt::memory_buffer& buffer ) {
+         fmt::format_to( buffer, "ENDATA\n" );
+      } );
+      //TODO: add symmetries
+   }
 
-         if( row_flags[i].test( RowFlag::kLhsInf ) &&
-             row_flags[i].test( RowFlag::kRhsInf ) )
-            continue;
+ private:
+   /// writes blocks of formatted lines to the file, through a bzip2
+   /// compressor for .bz2 files and as separate gzip members for .gz files
+   class BlockWriter
+   {
+    public:
+      explicit BlockWriter( const std::string& filename )
+          : file( filename, std::ofstream::out )
+      {
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+         gzip = boost::algorithm::ends_with( filename, ".gz" );
+#endif
 
-         if( row_flags[i].test( RowFlag::kLhsInf ) )
-         {
-            if( rhs[i] != REAL{ 0.0 } )
-               fmt::print( out, "    B         {: <9} {:.15}\n",
-                           consnames[row_mapping[i]], double( rhs[i] ) );
-         }
-         else
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_BZIP2
+         if( boost::algorithm::ends_with( filename, ".bz2" ) )
          {
-            if( lhs[i] != REAL{ 0.0 } )
-               fmt::print( out, "    B         {: <9} {:.15}\n",
-                           consnames[row_mapping[i]], double( lhs[i] ) );
+            bzip2.push( boost::iostreams::bzip2_compressor() );
+            bzip2.push( file );
          }
+#endif
       }
 
-      if( hasRangedRow )
+      /// writes a single block that is formatted by format( buffer )
+      template <typename FORMAT>
+      void
+      write( FORMAT&& format )
       {
-         fmt::print( out, "RANGES\n" );
-         for( int i = 0; i < consmatrix.getNRows(); ++i )
-         {
-            if( row_flags[i].test( RowFlag::kLhsInf, RowFlag::kRhsInf,
-                                   RowFlag::kEquation, RowFlag::kRedundant ) )
-               continue;
+         Vec<int> starts{ 0, 1 };
+         writeBlocks( starts, [&]( fmt::memory_buffer& buffer, int, int ) {
+            format( buffer );
+         } );
+      }
 
-            double rangeval = double( REAL( rhs[i] - lhs[i] ) );
+      /// formats the blocks [starts[k], starts[k + 1]) with
+      /// format( buffer, begin, end ) in parallel batches and writes them in
+      /// order
+      template <typename FORMAT>
+      void
+      writeBlocks( const Vec<int>& starts, FORMAT&& format )
+      {
+         if( starts.size() < 2 )
+            return;
+
+         std::size_t nblocks = starts.size() - 1;
+         std::size_t batchsize = nblocks;
+         if( batchsize > kBlocksPerBatch )
+            batchsize = kBlocksPerBatch;
+         if( buffers.size() < batchsize )
+            buffers.resize( batchsize );
+         if( members.size() < batchsize )
+            members.resize( batchsize );
+
+         for( std::size_t first = 0; first < nblocks; first += batchsize )
+         {
+            std::size_t last =
+                nblocks - first < batchsize ? nblocks : first + batchsize;
+
+            auto formatBlock = [&]( std::size_t k ) {
+               fmt::memory_buffer& buffer = buffers[k - first];
+               buffer.clear();
+               format( buffer, starts[k], starts[k + 1] );
+               if( gzip )
+                  compress( buffer, members[k - first] );
+            };
+
+#ifdef PAPILO_TBB
+            tbb::parallel_for( tbb::blocked_range<std::size_t>( first, last ),
+                               [&]( const tbb::blocked_range<std::size_t>& r ) {
+                                  for( std::size_t k = r.begin(); k != r.end();
+                                       ++k )
+                                     formatBlock( k );
+                               } );
+#else
+            for( std::size_t k = first; k < last; ++k )
+               formatBlock( k );
+#endif
 
-            if( rangeval != 0 )
+            for( std::size_t k = first; k < last; ++k )
             {
-               fmt::print( out, "    B         {: <9} {:.15}\n",
-                           consnames[row_mapping[i]], rangeval );
+               const fmt::memory_buffer& buffer = buffers[k - first];
+               if( buffer.size() == 0 )
+                  continue;
+
+               if( gzip )
+                  file.write( members[k - first].data(),
+                              members[k - first].size() );
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_BZIP2
+               else if( !bzip2.empty() )
+                  bzip2.write( buffer.data(), buffer.size() );
+#endif
+               else
+                  file.write( buffer.data(), buffer.size() );
             }
          }
       }
 
-      fmt::print( out, "BOUNDS\n" );
+    private:
+      std::ofstream file;
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_BZIP2
+      boost::iostreams::filtering_ostream bzip2;
+#endif
+      bool gzip = false;
+      Vec<fmt::memory_buffer> buffers;
+      Vec<std::string> members;
 
-      for( int i = 0; i < consmatrix.getNCols(); ++i )
+      static void
+      compress( const fmt::memory_buffer& buffer, std::string& member )
       {
-         if( col_flags[i].test( ColFlag::kInactive ) )
-            continue;
-
-         if( !col_flags[i].test( ColFlag::kLbInf ) &&
-             !col_flags[i].test( ColFlag::kUbInf ) &&
-             lower_bounds[i] == upper_bounds[i] )
-         {
-            fmt::print( out, " FX BND       {: <9} {:.15}\n",
-                        varnames[col_mapping[i]], double( lower_bounds[i] ) );
-         }
-         else
-         {
-            if( col_flags[i].test( ColFlag::kLbInf ) || lower_bounds[i] != 0.0 )
-            {
-               if( col_flags[i].test( ColFlag::kLbInf ) )
-                  fmt::print( out, " MI BND       {}\n",
-                              varnames[col_mapping[i]] );
-               else
-                  fmt::print( out, " LO BND       {: <9} {:.15}\n",
-                              varnames[col_mapping[i]],
-                              double( lower_bounds[i] ) );
-            }
+         member.clear();
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+         if( buffer.size() == 0 )
+            return;
 
-            if( !col_flags[i].test( ColFlag::kUbInf ) )
-               fmt::print( out, " UP BND       {: <9} {:.15}\n",
-                           varnames[col_mapping[i]],
-                           double( upper_bounds[i] ) );
-            else
-               fmt::print( out, " PL BND       {: <9}\n",
-                           varnames[col_mapping[i]] );
-         }
+         boost::iostreams::filtering_ostream out;
+         out.push( boost::iostreams::gzip_compressor() );
+         out.push( boost::iostreams::back_inserter( member ) );
+         out.write( buffer.data(), buffer.size() );
+         out.reset();
+#else
+         (void)buffer;
+#endif
       }
-      fmt::print( out, "ENDATA\n" );
-      //TODO: add symmetries
+   };
+
+   /// returns the starts of blocks of size blocksize that cover [0, size)
+   static Vec<int>
+   blockStarts( int size, int blocksize )
+   {
+      Vec<int> starts;
+      starts.reserve( size / blocksize + 2 );
+      for( int begin = 0; begin < size; begin += blocksize )
+         starts.push_back( begin );
+      starts.push_back( size );
+      return starts;
+   }
+
+   template <typename FUNC>
+   static void
+   forEachBlock( int size, int blocksize, FUNC&& func )
+   {
+#ifdef PAPILO_TBB
+      tbb::parallel_for( tbb::blocked_range<int>( 0, size, blocksize ),
+                         [&]( const tbb::blocked_range<int>& r ) {
+                            func( r.begin(), r.end() );
+                         } );
+#else
+      (void)blocksize;
+      func( 0, size );
+#endif
    }
 };
 
@@ -23,6 +23,7 @@
 #ifndef _PAPILO_IO_PARSER_HPP_
 #define _PAPILO_IO_PARSER_HPP_
 
+#include "papilo/io/BinaryParser.hpp"
 #include "papilo/io/MpsParser.hpp"
 #include "papilo/io/OpbParser.hpp"
 
@@ -44,7 +45,9 @@ class Parser
    static boost::optional<Problem<REAL>>
    loadProblem( const std::string& filename )
    {
-      if( filename.find(".mps") != std::string::npos)
+      if( boost::algorithm::ends_with( filename, ".pbin" ) )
+         return BinaryParser<REAL>::loadProblem( filename );
+      else if( filename.find(".mps") != std::string::npos)
          return MpsParser<REAL>::loadProblem( filename );
       else if( filename.find(".opb") != std::string::npos)
          return OpbParser<REAL>::loadProblem( filename );
@@ -0,0 +1,373 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _PAPILO_IO_PIPELINED_DECOMPRESSOR_HPP_
+#define _PAPILO_IO_PIPELINED_DECOMPRESSOR_HPP_
+
+#include "papilo/Config.hpp"
+#include "papilo/misc/Vec.hpp"
+#include <algorithm>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_BZIP2
+#include <boost/iostreams/filter/bzip2.hpp>
+#endif
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+#include <boost/iostreams/filter/gzip.hpp>
+#endif
+#ifdef PAPILO_TBB
+#include "papilo/misc/tbb.hpp"
+#endif
+
+namespace papilo
+{
+
+/// Decompresses a .gz or .bz2 file on a background thread into a bounded
+/// queue of blocks that is consumed through a boost iostreams source, so that
+/// decompression overlaps with parsing. Gzip files consisting of BGZF members
+/// (as written by bgzip), whose headers store the compressed size of each
+/// member, are inflated in parallel batches of members.
+class PipelinedDecompressor
+{
+   struct State
+   {
+      std::mutex mutex;
+      std::condition_variable produced;
+      std::condition_variable consumed;
+      std::deque<std::string> blocks;
+      std::size_t maxBlocks;
+      bool finished = false;
+      bool stopped = false;
+      bool failed = false;
+
+      explicit State( std::size_t _maxBlocks ) : maxBlocks( _maxBlocks ) {}
+
+      /// returns false if the consumer is gone
+      bool
+      push( std::string&& block )
+      {
+         if( block.empty() )
+            return true;
+         std::unique_lock<std::mutex> lock( mutex );
+         consumed.wait( lock,
+                        [this]() { return stopped || blocks.size() < maxBlocks; } );
+         if( stopped )
+            return false;
+         blocks.push_back( std::move( block ) );
+         produced.notify_one();
+         return true;
+      }
+
+      void
+      finish( bool error )
+      {
+         std::lock_guard<std::mutex> lock( mutex );
+         finished = true;
+         failed = error;
+         produced.notify_one();
+      }
+   };
+
+ public:
+   /// boost iostreams source reading the decompressed blocks in order
+   class Source
+   {
+    public:
+      using char_type = char;
+      using category = boost::iostreams::source_tag;
+
+      explicit Source( std::shared_ptr<State> _state )
+          : state( std::move( _state ) )
+      {
+      }
+
+      std::streamsize
+      read( char* s, std::streamsize n )
+      {
+         if( pos == current.size() )
+         {
+            std::unique_lock<std::mutex> lock( state->mutex );
+            state->produced.wait( lock, [this]() {
+               return !state->blocks.empty() || state->finished;
+            } );
+            if( state->blocks.empty() )
+               return -1;
+            current = std::move( state->blocks.front() );
+            state->blocks.pop_front();
+            pos = 0;
+            state->consumed.notify_one();
+         }
+
+         std::streamsize len =
+             std::min( n, static_cast<std::streamsize>( current.size() - pos ) );
+         std::memcpy( s, current.data() + pos, len );
+         pos += len;
+         return len;
+      }
+
+    private:
+      std::shared_ptr<State> state;
+      std::string current;
+      std::size_t pos = 0;
+   };
+
+   /// blockSize is the number of decompressed bytes per block of the
+   /// sequential mode and maxBlocks the capacity of the queue
+   explicit PipelinedDecompressor( std::size_t _blockSize = 1 << 20,
+                                   std::size_t maxBlocks = 16 )
+       : state( std::make_shared<State>( std::max( maxBlocks,
+                                                   std::size_t{ 1 } ) ) ),
+         blockSize( std::max( _blockSize, std::size_t{ 1 } ) )
+   {
+   }
+
+   PipelinedDecompressor( const PipelinedDecompressor& ) = delete;
+
+   PipelinedDecompressor&
+   operator=( const PipelinedDecompressor& ) = delete;
+
+   ~PipelinedDecompressor()
+   {
+      {
+         std::lock_guard<std::mutex> lock( state->mutex );
+         state->stopped = true;
+         state->consumed.notify_all();
+      }
+      if( producer.joinable() )
+         producer.join();
+   }
+
+   /// starts decompressing the file in the background, returns false if the
+   /// file cannot be opened or its compression is not supported
+   bool
+   start( const std::string& filename )
+   {
+      bool gzip = boost::algorithm::ends_with( filename, ".gz" );
+      bool bzip2 = boost::algorithm::ends_with( filename, ".bz2" );
+
+#ifndef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+      if( gzip )
+         return false;
+#endif
+#ifndef PAPILO_USE_BOOST_IOSTREAMS_WITH_BZIP2
+      if( bzip2 )
+         return false;
+#endif
+
+      auto file = std::make_shared<std::ifstream>(
+          filename, std::ifstream::in | std::ifstream::binary );
+      if( !*file )
+         return false;
+
+      producer = std::thread( [this, file, gzip, bzip2]() {
+         bool ok;
+         if( gzip && isBgzfMember( *file ) )
+            ok = inflateMembers( *file );
+         else
+            ok = decompressSequential( *file, gzip, bzip2 );
+         state->finish( !ok );
+      } );
+
+      return true;
+   }
+
+   Source
+   source() const
+   {
+      return Source( state );
+   }
+
+   /// true if decompression failed, valid after the source reached its end
+   bool
+   failed() const
+   {
+      std::lock_guard<std::mutex> lock( state->mutex );
+      return state->failed;
+   }
+
+   /// number of members inflated in parallel per batch
+   static constexpr std::size_t kMembersPerBatch = 64;
+
+ private:
+   std::shared_ptr<State> state;
+   std::size_t blockSize;
+   std::thread producer;
+
+   /// reads the header of the BGZF member at the current position without
+   /// consuming it and returns its total size or 0 if it is no BGZF member
+   static std::size_t
+   bgzfMemberSize( std::istream& file )
+   {
+      unsigned char header[18];
+      std::streampos start = file.tellg();
+      file.read( reinterpret_cast<char*>( header ), sizeof( header ) );
+      bool complete = file.gcount() == sizeof( header );
+      file.clear();
+      file.seekg( start );
+
+      // magic bytes, deflate, FEXTRA flag, XLEN == 6, subfield BC of size 2
+      if( !complete || header[0] != 0x1f || header[1] != 0x8b ||
+          header[2] != 8 || ( header[3] & 4 ) == 0 || header[10] != 6 ||
+          header[11] != 0 || header[12] != 'B' || header[13] != 'C' ||
+          header[14] != 2 || header[15] != 0 )
+         return 0;
+
+      return std::size_t( header[16] ) + ( std::size_t( header[17] ) << 8 ) +
+             1;
+   }
+
+   static bool
+   isBgzfMember( std::istream& file )
+   {
+      return bgzfMemberSize( file ) != 0;
+   }
+
+   bool
+   decompressSequential( std::istream& file, bool gzip, bool bzip2 )
+   {
+      boost::iostreams::filtering_istream in;
+
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+      if( gzip )
+         in.push( boost::iostreams::gzip_decompressor() );
+#endif
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_BZIP2
+      if( bzip2 )
+         in.push( boost::iostreams::bzip2_decompressor() );
+#endif
+      (void)gzip;
+      (void)bzip2;
+
+      in.push( file );
+
+      try
+      {
+         while( true )
+         {
+            std::string block( blockSize, '\0' );
+            in.read( &block[0], blockSize );
+            block.resize( in.gcount() );
+            if( block.empty() )
+               break;
+            if( !state->push( std::move( block ) ) )
+               return true;
+         }
+      }
+      catch( const std::exception& )
+      {
+         return false;
+      }
+
+      return in.eof();
+   }
+
+   bool
+   inflateMembers( std::istream& file )
+   {
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+      Vec<std::string> compressed;
+      Vec<std::string> inflated;
+      compressed.reserve( kMembersPerBatch );
+
+      auto inflate = [&]( std::size_t i ) {
+         boost::iostreams::filtering_istream in;
+         in.push( boost::iostreams::gzip_decompressor() );
+         in.push( boost::iostreams::array_source(
+             compressed[i].data(), compressed[i].size() ) );
+         inflated[i].clear();
+         boost::iostreams::copy( in, std::back_inserter( inflated[i] ) );
+      };
+
+      while( true )
+      {
+         // read the next batch of members
+         compressed.clear();
+         std::size_t size = 0;
+         while( compressed.size() < kMembersPerBatch &&
+                ( size = bgzfMemberSize( file ) ) != 0 )
+         {
+            compressed.emplace_back( size, '\0' );
+            file.read( &compressed.back()[0], size );
+            if( static_cast<std::size_t>( file.gcount() ) != size )
+               return false;
+         }
+
+         inflated.resize( compressed.size() );
+
+         try
+         {
+#ifdef PAPILO_TBB
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>( 0, compressed.size() ),
+                [&]( const tbb::blocked_range<std::size_t>& r ) {
+                   for( std::size_t i = r.begin(); i != r.end(); ++i )
+                      inflate( i );
+                } );
+#else
+            for( std::size_t i = 0; i < compressed.size(); ++i )
+               inflate( i );
+#endif
+         }
+         catch( const std::exception& )
+         {
+            return false;
+         }
+
+         for( std::string& block : inflated )
+         {
+            if( !state->push( std::move( block ) ) )
+               return true;
+         }
+
+         if( compressed.size() < kMembersPerBatch )
+            break;
+      }
+
+      // anything after the last BGZF member is inflated sequentially
+      if( file.peek() == std::char_traits<char>::eof() )
+         return true;
+
+      file.clear();
+      return decompressSequential( file, true, false );
+#else
+      (void)file;
+      return false;
+#endif
+   }
+};
+
+} // namespace papilo
+
+#endif
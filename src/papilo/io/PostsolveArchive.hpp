@@ -0,0 +1,333 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _PAPILO_IO_POSTSOLVE_ARCHIVE_HPP_
+#define _PAPILO_IO_POSTSOLVE_ARCHIVE_HPP_
+
+#include "papilo/Config.hpp"
+#include "papilo/core/postsolve/PostsolveStorage.hpp"
+#include "papilo/io/BinaryFormat.hpp"
+#include "papilo/io/BinaryParser.hpp"
+#include "papilo/io/BinaryWriter.hpp"
+#include "papilo/misc/Vec.hpp"
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <type_traits>
+
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_MAPPED_FILE
+#include <boost/iostreams/device/mapped_file.hpp>
+#endif
+
+namespace papilo
+{
+
+namespace binary
+{
+
+constexpr char kPostsolveMagic[8] = { 'P', 'A', 'P', 'I', 'L', 'O', 'P', 'S' };
+constexpr uint32_t kPostsolveVersion = 1;
+
+enum PostsolveSection : uint32_t
+{
+   /// epsilon, feastol and hugeval of the numerics
+   kPostsolveNum,
+   kPostsolveColMapping,
+   kPostsolveRowMapping,
+   kPostsolveTypes,
+   kPostsolveIndices,
+   kPostsolveValues,
+   kPostsolveStart,
+   /// the original problem in the binary problem format
+   kPostsolveProblem,
+   kNumPostsolveSections
+};
+
+struct PostsolveHeader
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t byteOrderMark;
+   uint32_t valueType;
+   uint32_t valueSize;
+   uint32_t nColsOriginal;
+   uint32_t nRowsOriginal;
+   int32_t postsolveType;
+   uint32_t nSections;
+   SectionEntry sections[kNumPostsolveSections];
+};
+
+} // namespace binary
+
+/// Flat versioned file format for the PostsolveStorage. All vectors are
+/// stored as aligned plain arrays behind a header with a section table, so
+/// loading a memory mapped archive only copies them into the storage and the
+/// format does not depend on the boost serialization version.
+template <typename REAL>
+class PostsolveArchive
+{
+ public:
+   using Stored = typename binary::StoredValue<REAL>::type;
+
+   /// archives of types that would be rounded to double are not written in
+   /// this format
+   static constexpr bool kSupported = binary::StoredValue<REAL>::kLossless;
+
+   /// writes the storage into the file, returns false if writing failed or
+   /// if the archive is not supported for REAL
+   static bool
+   write( const std::string& filename, const PostsolveStorage<REAL>& storage )
+   {
+      return write( filename, storage,
+                    std::integral_constant<bool, kSupported>() );
+   }
+
+   /// checks whether the file starts with the header of this format, older
+   /// archives written with boost serialization do not
+   static bool
+   isArchive( const std::string& filename )
+   {
+      std::ifstream in( filename, std::ifstream::in | std::ifstream::binary );
+      char magic[8];
+      in.read( magic, sizeof( magic ) );
+      return in.gcount() == sizeof( magic ) &&
+             std::memcmp( magic, binary::kPostsolveMagic, sizeof( magic ) ) ==
+                 0;
+   }
+
+   static bool
+   read( const std::string& filename, PostsolveStorage<REAL>& storage )
+   {
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_MAPPED_FILE
+      boost::iostreams::mapped_file_source mapped;
+      try
+      {
+         mapped.open( filename );
+      }
+      catch( const std::exception& )
+      {
+         return false;
+      }
+      if( !mapped.is_open() )
+         return false;
+
+      return read( mapped.data(), mapped.size(), storage );
+#else
+      std::ifstream file( filename, std::ifstream::in | std::ifstream::binary );
+      if( !file )
+         return false;
+      std::string content( ( std::istreambuf_iterator<char>( file ) ),
+                           std::istreambuf_iterator<char>() );
+
+      return read( content.data(), content.size(), storage );
+#endif
+   }
+
+   /// reads an archive from a buffer, returns false if it is invalid or if
+   /// the archive is not supported for REAL
+   static bool
+   read( const char* data, std::size_t size, PostsolveStorage<REAL>& storage )
+   {
+      return read( data, size, storage,
+                   std::integral_constant<bool, kSupported>() );
+   }
+
+ private:
+   static bool
+   write( const std::string&, const PostsolveStorage<REAL>&, std::false_type )
+   {
+      return false;
+   }
+
+   static bool
+   write( const std::string& filename, const PostsolveStorage<REAL>& storage,
+          std::true_type )
+   {
+      std::ofstream out( filename, std::ofstream::out | std::ofstream::binary |
+                                       std::ofstream::trunc );
+      if( !out )
+         return false;
+
+      binary::PostsolveHeader header;
+      std::memset( &header, 0, sizeof( header ) );
+      std::memcpy( header.magic, binary::kPostsolveMagic,
+                   sizeof( header.magic ) );
+      header.version = binary::kPostsolveVersion;
+      header.byteOrderMark = binary::kByteOrderMark;
+      header.valueType =
+          static_cast<uint32_t>( binary::StoredValue<REAL>::kType );
+      header.valueSize = sizeof( Stored );
+      header.nColsOriginal = storage.nColsOriginal;
+      header.nRowsOriginal = storage.nRowsOriginal;
+      header.postsolveType = static_cast<int32_t>( storage.postsolveType );
+      header.nSections = binary::kNumPostsolveSections;
+
+      out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+      Vec<REAL> num{ storage.num.getEpsilon(), storage.num.getFeasTol(),
+                     storage.num.getHugeVal() };
+      writeArray( out, header, binary::kPostsolveNum, num );
+      writeArray( out, header, binary::kPostsolveColMapping,
+                  storage.origcol_mapping );
+      writeArray( out, header, binary::kPostsolveRowMapping,
+                  storage.origrow_mapping );
+      writeArray( out, header, binary::kPostsolveTypes, storage.types );
+      writeArray( out, header, binary::kPostsolveIndices, storage.indices );
+      writeArray( out, header, binary::kPostsolveValues, storage.values );
+      writeArray( out, header, binary::kPostsolveStart, storage.start );
+
+      // the original problem is embedded in the binary problem format
+      const Problem<REAL>& problem = storage.problem;
+      Vec<int> row_mapping( problem.getNRows() );
+      Vec<int> col_mapping( problem.getNCols() );
+      std::iota( row_mapping.begin(), row_mapping.end(), 0 );
+      std::iota( col_mapping.begin(), col_mapping.end(), 0 );
+
+      uint64_t offset = alignStream( out );
+      if( !BinaryWriter<REAL>::writeProb( out, problem, row_mapping,
+                                          col_mapping ) )
+         return false;
+      header.sections[binary::kPostsolveProblem].offset = offset;
+      header.sections[binary::kPostsolveProblem].size =
+          static_cast<uint64_t>( out.tellp() ) - offset;
+
+      out.seekp( 0 );
+      out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+      return static_cast<bool>( out );
+   }
+
+   static bool
+   read( const char*, std::size_t, PostsolveStorage<REAL>&, std::false_type )
+   {
+      return false;
+   }
+
+   static bool
+   read( const char* data, std::size_t size, PostsolveStorage<REAL>& storage,
+         std::true_type )
+   {
+      binary::PostsolveHeader header;
+      if( size < sizeof( header ) )
+         return false;
+
+      std::memcpy( &header, data, sizeof( header ) );
+
+      if( std::memcmp( header.magic, binary::kPostsolveMagic,
+                       sizeof( header.magic ) ) != 0 ||
+          header.version != binary::kPostsolveVersion ||
+          header.byteOrderMark != binary::kByteOrderMark ||
+          header.nSections != binary::kNumPostsolveSections ||
+          header.valueType !=
+              static_cast<uint32_t>( binary::StoredValue<REAL>::kType ) ||
+          header.valueSize != sizeof( Stored ) )
+         return false;
+
+      for( const binary::SectionEntry& section : header.sections )
+      {
+         if( section.offset > size || section.size > size - section.offset )
+            return false;
+      }
+
+      Vec<REAL> num;
+      if( !readArray( data, header, binary::kPostsolveNum, num ) ||
+          num.size() != 3 ||
+          !readArray( data, header, binary::kPostsolveColMapping,
+                      storage.origcol_mapping ) ||
+          !readArray( data, header, binary::kPostsolveRowMapping,
+                      storage.origrow_mapping ) ||
+          !readArray( data, header, binary::kPostsolveTypes, storage.types ) ||
+          !readArray( data, header, binary::kPostsolveIndices,
+                      storage.indices ) ||
+          !readArray( data, header, binary::kPostsolveValues,
+                       storage.values ) ||
+          !readArray( data, header, binary::kPostsolveStart, storage.start ) )
+         return false;
+
+      const binary::SectionEntry& problem =
+          header.sections[binary::kPostsolveProblem];
+      boost::optional<Problem<REAL>> original =
+          BinaryParser<REAL>::loadProblem( data + problem.offset,
+                                           problem.size );
+      if( !original )
+         return false;
+
+      storage.problem = std::move( original.get() );
+      storage.nColsOriginal = header.nColsOriginal;
+      storage.nRowsOriginal = header.nRowsOriginal;
+      storage.postsolveType =
+          static_cast<PostsolveType>( header.postsolveType );
+      storage.num.setEpsilon( num[0] );
+      storage.num.setFeasTol( num[1] );
+      storage.num.setHugeVal( num[2] );
+
+      return true;
+   }
+
+   static uint64_t
+   alignStream( std::ostream& out )
+   {
+      uint64_t offset = static_cast<uint64_t>( out.tellp() );
+      uint64_t aligned = binary::alignedOffset( offset );
+      const char padding[binary::kAlignment] = {};
+      out.write( padding, aligned - offset );
+      return aligned;
+   }
+
+   template <typename T>
+   static void
+   writeArray( std::ostream& out, binary::PostsolveHeader& header,
+               binary::PostsolveSection section, const Vec<T>& array )
+   {
+      static_assert( std::is_trivially_copyable<T>::value,
+                     "archive sections must be trivially copyable" );
+      uint64_t offset = alignStream( out );
+      if( !array.empty() )
+         out.write( reinterpret_cast<const char*>( array.data() ),
+                    array.size() * sizeof( T ) );
+
+      header.sections[section].offset = offset;
+      header.sections[section].size = array.size() * sizeof( T );
+   }
+
+   template <typename T>
+   static bool
+   readArray( const char* data, const binary::PostsolveHeader& header,
+              binary::PostsolveSection section, Vec<T>& array )
+   {
+      static_assert( std::is_trivially_copyable<T>::value,
+                     "archive sections must be trivially copyable" );
+      const binary::SectionEntry& entry = header.sections[section];
+      if( entry.size % sizeof( T ) != 0 )
+         return false;
+
+      array.resize( entry.size / sizeof( T ) );
+      if( entry.size != 0 )
+         std::memcpy( array.data(), data + entry.offset, entry.size );
+      return true;
+   }
+};
+
+} // namespace papilo
+
+#endif
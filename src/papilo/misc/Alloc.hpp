@@ -23,17 +23,36 @@
 #ifndef _PAPILO_MISC_ALLOC_HPP_
 #define _PAPILO_MISC_ALLOC_HPP_
 
+#include "papilo/Config.hpp"
 #include <memory>
 
+#ifdef PAPILO_USE_ARENA_ALLOCATOR
+#include "papilo/misc/ArenaAllocator.hpp"
+#endif
+
 namespace papilo
 {
 
 template <typename T, int = 0>
 struct AllocatorTraits
 {
+#ifdef PAPILO_USE_ARENA_ALLOCATOR
+   using type = ArenaAllocator<T>;
+#else
    using type = std::allocator<T>;
+#endif
 };
 
+#ifdef PAPILO_USE_ARENA_ALLOCATOR
+// strings are handed to streams and to interfaces taking std::string, so they
+// keep the standard allocator
+template <>
+struct AllocatorTraits<char>
+{
+   using type = std::allocator<char>;
+};
+#endif
+
 template <typename T>
 using Allocator = typename AllocatorTraits<T>::type;
 
@@ -0,0 +1,504 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _PAPILO_MISC_ARENA_ALLOCATOR_HPP_
+#define _PAPILO_MISC_ARENA_ALLOCATOR_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace papilo
+{
+
+/// bytes requested from the arena, per subsystem in the order of
+/// registration; the first subsystem collects the allocations made outside of
+/// any ArenaScope
+struct ArenaStatistics
+{
+   struct Subsystem
+   {
+      std::string name;
+      std::size_t allocations;
+      std::size_t bytes;
+   };
+
+   std::vector<Subsystem> subsystems;
+   /// bytes of the chunks the arena took from the system
+   std::size_t reservedbytes;
+};
+
+/// Pool allocator with one cache per thread for the containers of PaPILO.
+/// Requests of up to kMaxBlockSize bytes are rounded up to a power of two and
+/// served from the free list of that size class of the calling thread, which
+/// is refilled from 1 MiB chunks. No lock is taken on this path, so the many
+/// short-lived vectors of the presolvers running on the TBB workers do not
+/// contend for the lock of the system allocator. Larger requests are passed
+/// to operator new.
+///
+/// A freed block is put on the free list of the thread that frees it. The
+/// free lists of an exiting thread are handed to the next thread that starts
+/// and the chunks are never returned to the system, so the blocks of an arena
+/// stay valid after its thread is gone.
+class Arena
+{
+ public:
+   static constexpr std::size_t kMinBlockSize = 16;
+   static constexpr int kNumSizeClasses = 12;
+   static constexpr std::size_t kMaxBlockSize = kMinBlockSize
+                                                << ( kNumSizeClasses - 1 );
+   static constexpr std::size_t kChunkSize = std::size_t{ 1 } << 20;
+   static constexpr int kMaxSubsystems = 64;
+
+   static void*
+   allocate( std::size_t bytes )
+   {
+      ThreadCache* tc = cache();
+
+      if( tc != nullptr )
+         tc->count( bytes );
+      else
+         registry().count( bytes );
+
+      if( bytes > kMaxBlockSize )
+         return ::operator new( bytes );
+
+      int c = sizeClass( bytes );
+
+      if( tc == nullptr )
+         return registry().allocate( c );
+
+      FreeBlock* block = tc->freelist[c];
+      if( block != nullptr )
+      {
+         tc->freelist[c] = block->next;
+         return block;
+      }
+
+      return tc->carve( c );
+   }
+
+   static void
+   deallocate( void* p, std::size_t bytes ) noexcept
+   {
+      if( p == nullptr )
+         return;
+
+      if( bytes > kMaxBlockSize )
+      {
+         ::operator delete( p );
+         return;
+      }
+
+      int c = sizeClass( bytes );
+      FreeBlock* block = static_cast<FreeBlock*>( p );
+      ThreadCache* tc = cache();
+
+      if( tc == nullptr )
+      {
+         registry().deallocate( c, block );
+         return;
+      }
+
+      block->next = tc->freelist[c];
+      tc->freelist[c] = block;
+   }
+
+   /// returns the id of the subsystem with the given name and registers it if
+   /// it is new; if all ids are taken the allocations are counted as outside
+   /// of any subsystem
+   static int
+   registerSubsystem( const std::string& name )
+   {
+      Registry& reg = registry();
+      std::lock_guard<std::mutex> lock( reg.mutex );
+
+      for( std::size_t i = 0; i < reg.names.size(); ++i )
+      {
+         if( reg.names[i] == name )
+            return static_cast<int>( i );
+      }
+
+      if( reg.names.size() == kMaxSubsystems )
+         return 0;
+
+      reg.names.push_back( name );
+      return static_cast<int>( reg.names.size() ) - 1;
+   }
+
+   /// sums up the counters of the running threads and of the exited ones
+   static ArenaStatistics
+   getStatistics()
+   {
+      Registry& reg = registry();
+      std::lock_guard<std::mutex> lock( reg.mutex );
+
+      ArenaStatistics stats;
+      stats.subsystems.resize( reg.names.size() );
+      for( std::size_t i = 0; i < reg.names.size(); ++i )
+      {
+         stats.subsystems[i].name = reg.names[i];
+         stats.subsystems[i].allocations = reg.retired[i].allocations;
+         stats.subsystems[i].bytes = reg.retired[i].bytes;
+
+         for( const ThreadCache* tc : reg.caches )
+         {
+            stats.subsystems[i].allocations +=
+                tc->counters[i].allocations.load( std::memory_order_relaxed );
+            stats.subsystems[i].bytes +=
+                tc->counters[i].bytes.load( std::memory_order_relaxed );
+         }
+      }
+      stats.reservedbytes = reg.reservedbytes.load( std::memory_order_relaxed );
+
+      return stats;
+   }
+
+   /// subsystem the allocations of the calling thread are counted for
+   static int
+   getSubsystem()
+   {
+      return state().subsystem;
+   }
+
+   static void
+   setSubsystem( int subsystem )
+   {
+      assert( subsystem >= 0 && subsystem < kMaxSubsystems );
+      state().subsystem = subsystem;
+   }
+
+ private:
+   struct FreeBlock
+   {
+      FreeBlock* next;
+   };
+
+   struct Counter
+   {
+      std::atomic<std::size_t> allocations{ 0 };
+      std::atomic<std::size_t> bytes{ 0 };
+   };
+
+   struct RetiredCounter
+   {
+      std::size_t allocations = 0;
+      std::size_t bytes = 0;
+   };
+
+   struct ThreadCache;
+
+   /// trivially destructible part of the thread local state that can still
+   /// be accessed while the thread local objects are destroyed
+   struct ThreadState
+   {
+      ThreadCache* cache;
+      bool exited;
+      int subsystem;
+   };
+
+   static ThreadState&
+   state()
+   {
+      static thread_local ThreadState s = { nullptr, false, 0 };
+      return s;
+   }
+
+   struct Registry
+   {
+      std::mutex mutex;
+      std::vector<ThreadCache*> caches;
+      std::vector<std::string> names{ "other" };
+      RetiredCounter retired[kMaxSubsystems];
+      FreeBlock* orphans[kNumSizeClasses] = {};
+      std::atomic<std::size_t> reservedbytes{ 0 };
+
+      char*
+      newChunk()
+      {
+         reservedbytes.fetch_add( kChunkSize, std::memory_order_relaxed );
+         return static_cast<char*>( ::operator new( kChunkSize ) );
+      }
+
+      /// allocation of a thread whose cache is already destroyed
+      void*
+      allocate( int c )
+      {
+         std::lock_guard<std::mutex> lock( mutex );
+         FreeBlock* block = orphans[c];
+         if( block != nullptr )
+         {
+            orphans[c] = block->next;
+            return block;
+         }
+         // a whole chunk for one block, this only happens for allocations
+         // made while a thread exits
+         return newChunk();
+      }
+
+      void
+      deallocate( int c, FreeBlock* block )
+      {
+         std::lock_guard<std::mutex> lock( mutex );
+         block->next = orphans[c];
+         orphans[c] = block;
+      }
+
+      void
+      count( std::size_t bytes )
+      {
+         std::lock_guard<std::mutex> lock( mutex );
+         retired[state().subsystem].allocations += 1;
+         retired[state().subsystem].bytes += bytes;
+      }
+   };
+
+   /// never destroyed, so that blocks freed by static objects after the
+   /// thread local caches are gone can still be put on a free list
+   static Registry&
+   registry()
+   {
+      static Registry* reg = new Registry();
+      return *reg;
+   }
+
+   struct ThreadCache
+   {
+      FreeBlock* freelist[kNumSizeClasses] = {};
+      char* chunkpos = nullptr;
+      char* chunkend = nullptr;
+      Counter counters[kMaxSubsystems];
+
+      ThreadCache()
+      {
+         Registry& reg = registry();
+         std::lock_guard<std::mutex> lock( reg.mutex );
+         reg.caches.push_back( this );
+         for( int c = 0; c != kNumSizeClasses; ++c )
+         {
+            freelist[c] = reg.orphans[c];
+            reg.orphans[c] = nullptr;
+         }
+      }
+
+      ~ThreadCache()
+      {
+         Registry& reg = registry();
+         std::lock_guard<std::mutex> lock( reg.mutex );
+
+         for( std::size_t i = 0; i != reg.caches.size(); ++i )
+         {
+            if( reg.caches[i] == this )
+            {
+               reg.caches[i] = reg.caches.back();
+               reg.caches.pop_back();
+               break;
+            }
+         }
+
+         for( int i = 0; i != kMaxSubsystems; ++i )
+         {
+            reg.retired[i].allocations +=
+                counters[i].allocations.load( std::memory_order_relaxed );
+            reg.retired[i].bytes +=
+                counters[i].bytes.load( std::memory_order_relaxed );
+         }
+
+         salvage();
+         for( int c = 0; c != kNumSizeClasses; ++c )
+         {
+            while( freelist[c] != nullptr )
+            {
+               FreeBlock* block = freelist[c];
+               freelist[c] = block->next;
+               block->next = reg.orphans[c];
+               reg.orphans[c] = block;
+            }
+         }
+      }
+
+      /// only the owning thread writes the counters, the atomics are there
+      /// for getStatistics() reading them concurrently
+      void
+      count( std::size_t bytes )
+      {
+         Counter& counter = counters[state().subsystem];
+         counter.allocations.store(
+             counter.allocations.load( std::memory_order_relaxed ) + 1,
+             std::memory_order_relaxed );
+         counter.bytes.store( counter.bytes.load( std::memory_order_relaxed ) +
+                                  bytes,
+                              std::memory_order_relaxed );
+      }
+
+      void*
+      carve( int c )
+      {
+         std::size_t size = kMinBlockSize << c;
+         if( static_cast<std::size_t>( chunkend - chunkpos ) < size )
+         {
+            salvage();
+            chunkpos = registry().newChunk();
+            chunkend = chunkpos + kChunkSize;
+         }
+         void* block = chunkpos;
+         chunkpos += size;
+         return block;
+      }
+
+      /// puts the rest of the current chunk on the free lists of the largest
+      /// size classes fitting into it
+      void
+      salvage()
+      {
+         for( int c = kNumSizeClasses - 1; c >= 0; --c )
+         {
+            std::size_t size = kMinBlockSize << c;
+            while( static_cast<std::size_t>( chunkend - chunkpos ) >= size )
+            {
+               FreeBlock* block = reinterpret_cast<FreeBlock*>( chunkpos );
+               block->next = freelist[c];
+               freelist[c] = block;
+               chunkpos += size;
+            }
+         }
+      }
+   };
+
+   /// destroys the cache of a thread when the thread exits
+   struct CacheHolder
+   {
+      ThreadCache cache;
+
+      ~CacheHolder()
+      {
+         ThreadState& s = state();
+         s.cache = nullptr;
+         s.exited = true;
+      }
+   };
+
+   static ThreadCache*
+   cache()
+   {
+      ThreadState& s = state();
+      if( s.cache != nullptr || s.exited )
+         return s.cache;
+
+      static thread_local CacheHolder holder;
+      s.cache = &holder.cache;
+      return s.cache;
+   }
+
+   static int
+   sizeClass( std::size_t bytes )
+   {
+      int c = 0;
+      std::size_t size = kMinBlockSize;
+      while( size < bytes )
+      {
+         size <<= 1;
+         ++c;
+      }
+      return c;
+   }
+};
+
+/// counts the allocations of the calling thread for the given subsystem
+/// while the scope is alive; allocations in tasks spawned meanwhile are
+/// counted for the subsystem of the thread running them
+class ArenaScope
+{
+ public:
+   explicit ArenaScope( const std::string& name )
+       : previous( Arena::getSubsystem() )
+   {
+      Arena::setSubsystem( Arena::registerSubsystem( name ) );
+   }
+
+   ArenaScope( const ArenaScope& ) = delete;
+
+   ArenaScope&
+   operator=( const ArenaScope& ) = delete;
+
+   ~ArenaScope() { Arena::setSubsystem( previous ); }
+
+ private:
+   int previous;
+};
+
+/// allocator drawing from the Arena; types aligned stricter than the blocks
+/// of the arena are allocated by std::allocator
+template <typename T>
+struct ArenaAllocator
+{
+   using value_type = T;
+
+   ArenaAllocator() noexcept = default;
+
+   template <typename U>
+   ArenaAllocator( const ArenaAllocator<U>& ) noexcept
+   {
+   }
+
+   T*
+   allocate( std::size_t n )
+   {
+      if( alignof( T ) > Arena::kMinBlockSize )
+         return std::allocator<T>().allocate( n );
+      if( n > std::size_t( -1 ) / sizeof( T ) )
+         throw std::bad_alloc();
+      return static_cast<T*>( Arena::allocate( n * sizeof( T ) ) );
+   }
+
+   void
+   deallocate( T* p, std::size_t n ) noexcept
+   {
+      if( alignof( T ) > Arena::kMinBlockSize )
+         std::allocator<T>().deallocate( p, n );
+      else
+         Arena::deallocate( p, n * sizeof( T ) );
+   }
+};
+
+template <typename T, typename U>
+bool
+operator==( const ArenaAllocator<T>&, const ArenaAllocator<U>& ) noexcept
+{
+   return true;
+}
+
+template <typename T, typename U>
+bool
+operator!=( const ArenaAllocator<T>&, const ArenaAllocator<U>& ) noexcept
+{
+   return false;
+}
+
+} // namespace papilo
+
+#endif
@@ -0,0 +1,156 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+
+#ifndef _PAPILO_MISC_CHANGE_LOG_HPP_
+#define _PAPILO_MISC_CHANGE_LOG_HPP_
+
+#include "papilo/misc/Vec.hpp"
+#include "papilo/misc/compress_vector.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace papilo
+{
+
+/// Log of the indices of rows or columns that were modified. Modifications
+/// are grouped into epochs and every index is logged at most once per epoch.
+/// Only the entry of the latest epoch in which an index was modified is valid,
+/// so the indices modified since a given epoch can be enumerated without
+/// duplicates and without scanning all indices.
+class ChangeLog
+{
+ public:
+   explicit ChangeLog( int size = 0 ) : last_epoch( size, -1 ) {}
+
+   int
+   getEpoch() const
+   {
+      return epoch;
+   }
+
+   /// starts a new epoch and drops the outdated entries if they make up
+   /// most of the log
+   void
+   nextEpoch()
+   {
+      ++epoch;
+
+      if( indices.size() > 2 * last_epoch.size() + 1024 )
+         removeOutdatedEntries();
+   }
+
+   void
+   mark( int index )
+   {
+      assert( index >= 0 && index < static_cast<int>( last_epoch.size() ) );
+
+      if( last_epoch[index] == epoch )
+         return;
+
+      last_epoch[index] = epoch;
+      indices.push_back( index );
+      epochs.push_back( epoch );
+   }
+
+   /// returns true if the index was modified in the given or a later epoch
+   bool
+   isChangedSince( int index, int since ) const
+   {
+      assert( index >= 0 && index < static_cast<int>( last_epoch.size() ) );
+      assert( since >= 0 );
+
+      return last_epoch[index] >= since;
+   }
+
+   /// appends the indices that were modified in the given or a later epoch
+   void
+   getChangedSince( int since, Vec<int>& changed ) const
+   {
+      std::size_t first = static_cast<std::size_t>(
+          std::lower_bound( epochs.begin(), epochs.end(), since ) -
+          epochs.begin() );
+
+      for( std::size_t i = first; i < indices.size(); ++i )
+      {
+         if( last_epoch[indices[i]] == epochs[i] )
+            changed.push_back( indices[i] );
+      }
+   }
+
+   void
+   compress( const Vec<int>& mapping, bool full = false )
+   {
+      std::size_t newSize = 0;
+      for( std::size_t i = 0; i < indices.size(); ++i )
+      {
+         int index = indices[i];
+         if( mapping[index] == -1 || last_epoch[index] != epochs[i] )
+            continue;
+
+         indices[newSize] = mapping[index];
+         epochs[newSize] = epochs[i];
+         ++newSize;
+      }
+      indices.resize( newSize );
+      epochs.resize( newSize );
+
+      compress_vector( mapping, last_epoch );
+
+      if( full )
+      {
+         indices.shrink_to_fit();
+         epochs.shrink_to_fit();
+         last_epoch.shrink_to_fit();
+      }
+   }
+
+ private:
+   /// epoch in which an index was modified last, -1 if never
+   Vec<int> last_epoch;
+   /// logged indices and the epochs in which they were logged, the epochs are
+   /// sorted increasingly
+   Vec<int> indices;
+   Vec<int> epochs;
+   int epoch = 0;
+
+   void
+   removeOutdatedEntries()
+   {
+      std::size_t newSize = 0;
+      for( std::size_t i = 0; i < indices.size(); ++i )
+      {
+         if( last_epoch[indices[i]] != epochs[i] )
+            continue;
+
+         indices[newSize] = indices[i];
+         epochs[newSize] = epochs[i];
+         ++newSize;
+      }
+      indices.resize( newSize );
+      epochs.resize( newSize );
+   }
+};
+
+} // namespace papilo
+
+#endif
@@ -24,6 +24,7 @@
 #define _PAPILO_MISC_HASH_HPP_
 
 #include "papilo/Config.hpp"
+#include "papilo/misc/Alloc.hpp"
 
 #ifndef PAPILO_USE_STANDARD_HASHMAP
 #include "papilo/external/ska/bytell_hash_map.hpp"
@@ -24,9 +24,13 @@
 #define _PAPILO_MISC_SIGNATURE_HPP_
 
 #include "papilo/misc/Hash.hpp"
+#include <cassert>
 #include <cmath>
 #include <cstdint>
 #include <type_traits>
+#if defined( __AVX2__ ) || defined( __SSE4_1__ )
+#include <immintrin.h>
+#endif
 
 namespace papilo
 {
@@ -42,7 +46,7 @@ class Signature
    add( U elem )
    {
       state |=
-          1 << ( ( uint32_t( elem ) *
+          T{ 1 } << ( ( uint32_t( elem ) *
                    HashHelpers<uint32_t>::fibonacci_muliplier() ) >>
                  ( 32 - static_cast<int>( std::log2( 8 * sizeof( T ) ) ) ) );
    }
@@ -55,23 +59,41 @@ class Signature
    //}
 
    bool
-   isSubset( Signature other )
+   isSubset( Signature other ) const
    {
       return ( state & ~other.state ) == 0;
    }
 
    bool
-   isSuperset( Signature other )
+   isSuperset( Signature other ) const
    {
       return ( other.state & ~state ) == 0;
    }
 
+   /// at most one bit is not contained in other, if this fails the set of
+   /// other misses at least two elements of this set
+   bool
+   isSubsetUpToOne( Signature other ) const
+   {
+      T missing = state & ~other.state;
+      return ( missing & ( missing - 1 ) ) == 0;
+   }
+
    bool
-   isEqual( Signature other )
+   isEqual( Signature other ) const
    {
       return state == other.state;
    }
 
+   /// the lowest nbits bits of the signature, signatures with the same prefix
+   /// can be bucketed for subset queries
+   uint32_t
+   getPrefix( int nbits ) const
+   {
+      assert( nbits < 32 );
+      return static_cast<uint32_t>( state ) & ( ( uint32_t{ 1 } << nbits ) - 1 );
+   }
+
  private:
    T state;
 };
@@ -79,6 +101,93 @@ class Signature
 using Signature32 = Signature<uint32_t>;
 using Signature64 = Signature<uint64_t>;
 
+/// signature with NWORDS 64 bit words for elements with many entries, e.g.
+/// long columns, for which the bits of a 32 or 64 bit signature are all set.
+/// The subset tests of the 128 and 256 bit signatures use SSE4.1 and AVX2 if
+/// the code is compiled for it.
+template <int NWORDS>
+class WideSignature
+{
+   static_assert( NWORDS == 2 || NWORDS == 4,
+                  "wide signatures have 128 or 256 bits" );
+
+ public:
+   WideSignature() : state{} {}
+
+   template <typename U>
+   void
+   add( U elem )
+   {
+      const uint32_t bit =
+          ( uint32_t( elem ) * HashHelpers<uint32_t>::fibonacci_muliplier() ) >>
+          ( 32 - ( NWORDS == 2 ? 7 : 8 ) );
+      state[bit >> 6] |= uint64_t{ 1 } << ( bit & 63 );
+   }
+
+   bool
+   isSubset( const WideSignature& other ) const
+   {
+      return isSubsetOf( state, other.state );
+   }
+
+   bool
+   isSuperset( const WideSignature& other ) const
+   {
+      return isSubsetOf( other.state, state );
+   }
+
+   bool
+   isEqual( const WideSignature& other ) const
+   {
+      for( int i = 0; i != NWORDS; ++i )
+      {
+         if( state[i] != other.state[i] )
+            return false;
+      }
+      return true;
+   }
+
+   /// the lowest nbits bits of the signature, signatures with the same prefix
+   /// can be bucketed for subset queries
+   uint32_t
+   getPrefix( int nbits ) const
+   {
+      assert( nbits < 32 );
+      return static_cast<uint32_t>( state[0] ) &
+             ( ( uint32_t{ 1 } << nbits ) - 1 );
+   }
+
+ private:
+   /// checks whether the bits of a are a subset of the bits of b
+   static bool
+   isSubsetOf( const uint64_t* a, const uint64_t* b )
+   {
+#if defined( __AVX2__ )
+      if( NWORDS == 4 )
+         return _mm256_testc_si256(
+                    _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b ) ),
+                    _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>( a ) ) ) != 0;
+#endif
+#if defined( __SSE4_1__ )
+      if( NWORDS == 2 )
+         return _mm_testc_si128(
+                    _mm_loadu_si128( reinterpret_cast<const __m128i*>( b ) ),
+                    _mm_loadu_si128( reinterpret_cast<const __m128i*>( a ) ) ) !=
+                0;
+#endif
+      uint64_t notcontained = 0;
+      for( int i = 0; i != NWORDS; ++i )
+         notcontained |= a[i] & ~b[i];
+      return notcontained == 0;
+   }
+
+   uint64_t state[NWORDS];
+};
+
+using Signature128 = WideSignature<2>;
+using Signature256 = WideSignature<4>;
+
 } // namespace papilo
 
 #endif
@@ -28,6 +28,7 @@
 #include "papilo/io/Parser.hpp"
 #include "papilo/io/MpsWriter.hpp"
 #include "papilo/io/OpbWriter.hpp"
+#include "papilo/io/PostsolveArchive.hpp"
 #include "papilo/io/SolParser.hpp"
 #include "papilo/io/SolWriter.hpp"
 #include "papilo/misc/NumericalStatistics.hpp"
@@ -319,14 +320,25 @@ presolve_and_solve(
       {
 
          Timer t( writetime );
-         std::ofstream ofs( opts.postsolve_archive_file,
-                            std::ios_base::binary );
-         boost::archive::binary_oarchive oa( ofs );
-
-         // write class instance to archive
-         oa << result.postsolve;
-         fmt::print( "postsolve archive written to {} in {:.3f} seconds\n\n",
-                     opts.postsolve_archive_file, t.getTime() );
+         bool written = true;
+         if( PostsolveArchive<REAL>::kSupported )
+            written = PostsolveArchive<REAL>::write(
+                opts.postsolve_archive_file, result.postsolve );
+         else
+         {
+            std::ofstream ofs( opts.postsolve_archive_file,
+                               std::ios_base::binary );
+            boost::archive::binary_oarchive oa( ofs );
+
+            // write class instance to archive
+            oa << result.postsolve;
+         }
+         if( written )
+            fmt::print( "postsolve archive written to {} in {:.3f} seconds\n\n",
+                        opts.postsolve_archive_file, t.getTime() );
+         else
+            fmt::print( "could not write postsolve archive {}\n\n",
+                        opts.postsolve_archive_file );
       }
 
       if( opts.command == Command::kPresolve || problem.getNCols() == 0 )
@@ -598,11 +610,24 @@ void
 postsolve( const OptionsInfo& opts )
 {
    PostsolveStorage<REAL> ps;
-   std::ifstream inArchiveFile( opts.postsolve_archive_file,
-                                std::ios_base::binary );
-   boost::archive::binary_iarchive inputArchive( inArchiveFile );
-   inputArchive >> ps;
-   inArchiveFile.close();
+   if( PostsolveArchive<REAL>::isArchive( opts.postsolve_archive_file ) )
+   {
+      if( !PostsolveArchive<REAL>::read( opts.postsolve_archive_file, ps ) )
+      {
+         fmt::print( "could not read postsolve archive {}\n",
+                     opts.postsolve_archive_file );
+         return;
+      }
+   }
+   else
+   {
+      // archives of older versions were written with boost serialization
+      std::ifstream inArchiveFile( opts.postsolve_archive_file,
+                                   std::ios_base::binary );
+      boost::archive::binary_iarchive inputArchive( inArchiveFile );
+      inputArchive >> ps;
+      inArchiveFile.close();
+   }
 
    SolParser<REAL> parser;
    Vec<REAL> primal_solution;
@@ -69,6 +69,20 @@ compress_index_vector( const Vec<int>& mapping, VEC& vec )
    vec.resize( vec.size() - offset );
 }
 
+/// helper function to release the memory of a scratch vector beyond the given
+/// size, the contents are not kept
+template <typename VEC>
+void
+shrink_scratch_vector( VEC& vec, std::size_t size )
+{
+   if( vec.capacity() <= size )
+      return;
+
+   vec.clear();
+   vec.shrink_to_fit();
+   vec.reserve( size );
+}
+
 } // namespace papilo
 
 #endif
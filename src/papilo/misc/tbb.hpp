@@ -54,10 +54,13 @@
 #include "tbb/blocked_range.h"
 #include "tbb/combinable.h"
 #include "tbb/concurrent_hash_map.h"
+#include "tbb/concurrent_queue.h"
 #include "tbb/concurrent_vector.h"
 #include "tbb/parallel_for.h"
 #include "tbb/parallel_invoke.h"
+#include "tbb/parallel_sort.h"
 #include "tbb/partitioner.h"
+#include "tbb/task_group.h"
 #include "tbb/task_arena.h"
 #include "tbb/tick_count.h"
 
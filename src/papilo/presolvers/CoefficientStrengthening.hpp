@@ -76,7 +76,12 @@ CoefficientStrengthening<REAL>::execute( const Problem<REAL>& problem,
    const auto& domains = problem.getVariableDomains();
    const auto& cflags = domains.flags;
    const auto& activities = problem.getRowActivities();
-   const auto& changedActivities = problemUpdate.getChangedActivities();
+
+   // only rows that changed since the last call can be strengthened further,
+   // in the first call the rows with changed activities are considered
+   Vec<int> changedRows;
+   if( !this->getChangedRows( problemUpdate, changedRows ) )
+      changedRows = problemUpdate.getChangedActivities();
 
    const auto& constMatrix = problem.getConstraintMatrix();
    const auto& lhs_values = constMatrix.getLeftHandSides();
@@ -93,7 +98,7 @@ CoefficientStrengthening<REAL>::execute( const Problem<REAL>& problem,
       !problemUpdate.getPresolveOptions().coefficient_strengthening_parallel )
    {
       Vec<std::pair<REAL, int>> integerCoefficients;
-      for( int i : changedActivities )
+      for( int i : changedRows )
       {
          if( perform_coefficient_tightening(
                  num, domains, activities, i, constMatrix, lhs_values,
@@ -105,15 +110,15 @@ CoefficientStrengthening<REAL>::execute( const Problem<REAL>& problem,
 #ifdef PAPILO_TBB
    else
    {
-      Vec<Reductions<REAL>> stored_reductions( changedActivities.size() );
+      Vec<Reductions<REAL>> stored_reductions( changedRows.size() );
       tbb::parallel_for(
-          tbb::blocked_range<int>( 0, changedActivities.size() ),
+          tbb::blocked_range<int>( 0, changedRows.size() ),
           [&]( const tbb::blocked_range<int>& r ) {
             Vec<std::pair<REAL, int>> integerCoefficients;
              for( int j = r.begin(); j < r.end(); ++j )
              {
                 if( perform_coefficient_tightening(
-                        num, domains, activities, changedActivities[j],
+                        num, domains, activities, changedRows[j],
                         constMatrix, lhs_values, rhs_values, rflags, cflags,
                         stored_reductions[j], integerCoefficients ) == PresolveStatus::kReduced )
                    result = PresolveStatus::kReduced;
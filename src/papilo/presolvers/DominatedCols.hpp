@@ -29,9 +29,11 @@
 #include "papilo/core/SingleRow.hpp"
 #include "papilo/misc/Hash.hpp"
 #include "papilo/misc/Signature.hpp"
+#include "papilo/misc/compress_vector.hpp"
 #ifdef PAPILO_TBB
 #include "papilo/misc/tbb.hpp"
 #endif
+#include <tuple>
 
 namespace papilo
 {
@@ -39,6 +41,14 @@ namespace papilo
 template <typename REAL>
 class DominatedCols : public PresolveMethod<REAL>
 {
+   /// number of bits of the positive signature that are used to bucket the
+   /// candidate columns of a row
+   static constexpr int kPrefixBits = 8;
+   static constexpr int kNumKeys = 1 << kPrefixBits;
+
+   int64_t maxbucketwork = 1000000;
+   int signaturewidth = 0;
+
  public:
    DominatedCols() : PresolveMethod<REAL>()
    {
@@ -54,25 +64,41 @@ class DominatedCols : public PresolveMethod<REAL>
    {
       if( presolveOptions.dualreds < 2 )
          this->setEnabled( false );
-      return false;
+      return true;
+   }
+
+   void
+   compress( const Vec<int>& rowmap, const Vec<int>& colmap ) override
+   {
+      std::size_t ncols =
+          colmap.size() - std::count( colmap.begin(), colmap.end(), -1 );
+
+      shrink_scratch_vector( workspace.colsizes, ncols );
+      shrink_scratch_vector( std::get<0>( workspace.colinfo ), ncols );
+      shrink_scratch_vector( std::get<1>( workspace.colinfo ), ncols );
+      shrink_scratch_vector( std::get<2>( workspace.colinfo ), ncols );
+      shrink_scratch_vector( std::get<3>( workspace.colinfo ), ncols );
+      shrink_scratch_vector( workspace.unboundedcols, ncols );
+      shrink_scratch_vector( workspace.dominatingcols, ncols );
    }
 
    /// stores implied bound information and signatures for a column
+   template <typename SIG>
    struct ColInfo
    {
-      Signature32 pos;
-      Signature32 neg;
+      SIG pos;
+      SIG neg;
       int lbfree = 0;
       int ubfree = 0;
 
-      Signature32
+      const SIG&
       getNegSignature( int scale ) const
       {
          assert( scale == 1 || scale == -1 );
          return scale == 1 ? neg : pos;
       }
 
-      Signature32
+      const SIG&
       getPosSignature( int scale ) const
       {
          assert( scale == 1 || scale == -1 );
@@ -97,11 +123,101 @@ class DominatedCols : public PresolveMethod<REAL>
       BoundChange boundchg;
    };
 
+   /// unbounded column that can dominate the columns of its shortest row
+   struct DominatingCol
+   {
+      int col;
+      int row;
+      int scale;
+      int implrowlock;
+      REAL scaled_val;
+   };
+
+   /// column of a row with the scale, coefficient and objective it is
+   /// compared with
+   struct DomcolCandidate
+   {
+      int key;
+      int col;
+      int scale;
+      REAL val;
+      REAL obj;
+   };
+
+   void
+   addPresolverParams( ParameterSet& paramSet ) override
+   {
+      paramSet.addParameter(
+          "domcol.maxbucketwork",
+          "maximal number of candidate columns compared with the dominating "
+          "columns that share the same shortest row",
+          maxbucketwork, int64_t{ 0 } );
+      paramSet.addParameter(
+          "domcol.signaturewidth",
+          "number of bits of the column signatures, 0 chooses 32, 64, 128 or "
+          "256 bits depending on the column lengths",
+          signaturewidth, 0, 256 );
+   }
+
    PresolveStatus
    execute( const Problem<REAL>& problem,
             const ProblemUpdate<REAL>& problemUpdate, const Num<REAL>& num,
             Reductions<REAL>& reductions, const Timer& timer,
             int& reason_of_infeasibility ) override;
+
+   void
+   set_max_bucket_work( int64_t val )
+   {
+      maxbucketwork = val;
+   }
+
+   void
+   set_signature_width( int val )
+   {
+      signaturewidth = val;
+   }
+
+ private:
+   /// candidates of a bucket, kept per thread
+   struct BucketData
+   {
+      Vec<DomcolCandidate> candidates;
+      Vec<int> keystart;
+      Vec<std::pair<int, int>> dominated;
+   };
+
+   /// vectors of execute() kept between the calls, so that the rounds
+   /// allocate nothing until the problem is compressed; the column
+   /// information is kept for each signature width
+   struct Workspace
+   {
+      Vec<int> colsizes;
+      std::tuple<Vec<ColInfo<Signature32>>, Vec<ColInfo<Signature64>>,
+                 Vec<ColInfo<Signature128>>, Vec<ColInfo<Signature256>>>
+          colinfo;
+#ifdef PAPILO_TBB
+      tbb::concurrent_vector<int> unboundedcols;
+      tbb::concurrent_vector<DomcolReduction> domcolreductions;
+      tbb::combinable<BucketData> bucketData;
+#else
+      Vec<int> unboundedcols;
+      Vec<DomcolReduction> domcolreductions;
+      BucketData bucketData;
+#endif
+      Vec<DominatingCol> dominatingcols;
+      Vec<int> bucketstart;
+   };
+
+   Workspace workspace;
+
+   int
+   getSignatureWidth( const Problem<REAL>& problem );
+
+   template <typename SIG>
+   PresolveStatus
+   findDominatedCols( const Problem<REAL>& problem,
+                      const ProblemUpdate<REAL>& problemUpdate,
+                      const Num<REAL>& num, Reductions<REAL>& reductions );
 };
 
 #ifdef PAPILO_USE_EXTERN_TEMPLATES
@@ -116,6 +232,72 @@ DominatedCols<REAL>::execute( const Problem<REAL>& problem,
                               const ProblemUpdate<REAL>& problemUpdate,
                               const Num<REAL>& num, Reductions<REAL>& reductions,
                               const Timer& timer, int& reason_of_infeasibility){
+   // do not call dominated column presolver too often, since it can be
+   // expensive
+   this->skipRounds( this->getNCalls() );
+
+   switch( getSignatureWidth( problem ) )
+   {
+   case 32:
+      return findDominatedCols<Signature32>( problem, problemUpdate, num,
+                                             reductions );
+   case 64:
+      return findDominatedCols<Signature64>( problem, problemUpdate, num,
+                                             reductions );
+   case 128:
+      return findDominatedCols<Signature128>( problem, problemUpdate, num,
+                                              reductions );
+   default:
+      return findDominatedCols<Signature256>( problem, problemUpdate, num,
+                                              reductions );
+   }
+}
+
+template <typename REAL>
+int
+DominatedCols<REAL>::getSignatureWidth( const Problem<REAL>& problem )
+{
+   const int widths[] = { 32, 64, 128, 256 };
+
+   if( signaturewidth != 0 )
+   {
+      for( int width : widths )
+      {
+         if( signaturewidth <= width )
+            return width;
+      }
+      return 256;
+   }
+
+   // a signature filters subsets as long as a column sets only a fraction
+   // of its bits. Choose the smallest width that leaves at least three
+   // quarters of the bits unset for 90% of the columns.
+   const int ncols = problem.getNCols();
+   if( ncols == 0 )
+      return 32;
+
+   Vec<int>& colsizes = workspace.colsizes;
+   const Vec<int>& matrixcolsizes = problem.getConstraintMatrix().getColSizes();
+   colsizes.assign( matrixcolsizes.begin(), matrixcolsizes.end() );
+   auto quantile = colsizes.begin() + ( 9 * ( ncols - 1 ) ) / 10;
+   std::nth_element( colsizes.begin(), quantile, colsizes.end() );
+
+   for( int width : widths )
+   {
+      if( 4 * *quantile <= width )
+         return width;
+   }
+   return 256;
+}
+
+template <typename REAL>
+template <typename SIG>
+PresolveStatus
+DominatedCols<REAL>::findDominatedCols( const Problem<REAL>& problem,
+                                        const ProblemUpdate<REAL>& problemUpdate,
+                                        const Num<REAL>& num,
+                                        Reductions<REAL>& reductions )
+{
    const auto& obj = problem.getObjective().coefficients;
    const auto& consMatrix = problem.getConstraintMatrix();
    const auto& lbValues = problem.getLowerBounds();
@@ -130,16 +312,11 @@ DominatedCols<REAL>::execute( const Problem<REAL>& problem,
 
    PresolveStatus result = PresolveStatus::kUnchanged;
 
-   // do not call dominated column presolver too often, since it can be
-   // expensive
-   this->skipRounds( this->getNCalls() );
-
-   Vec<ColInfo> colinfo( ncols );
-#ifdef PAPILO_TBB
-   tbb::concurrent_vector<int> unboundedcols;
-#else
-   Vec<int> unboundedcols;
-#endif
+   Vec<ColInfo<SIG>>& colinfo =
+       std::get<Vec<ColInfo<SIG>>>( workspace.colinfo );
+   colinfo.assign( ncols, ColInfo<SIG>() );
+   auto& unboundedcols = workspace.unboundedcols;
+   unboundedcols.clear();
    unboundedcols.reserve( ncols );
 
    // compute signatures and implied bound information of all columns in
@@ -345,14 +522,13 @@ DominatedCols<REAL>::execute( const Problem<REAL>& problem,
       return true;
    };
 
-#ifdef PAPILO_TBB
-   tbb::concurrent_vector<DomcolReduction> domcolreductions;
-#else
-   Vec<DomcolReduction> domcolreductions;
-#endif
+   // determine for every unbounded column the shortest row that restricts it
+   // in the direction of its free bound. A dominated column needs a nonzero
+   // in that row, so the columns of the row are the candidates.
+   Vec<DominatingCol>& dominatingcols = workspace.dominatingcols;
+   dominatingcols.resize( unboundedcols.size() );
 
 #ifdef PAPILO_TBB
-   // scan unbounded columns if they dominate other columns
    tbb::parallel_for(
        tbb::blocked_range<int>( 0, (int) unboundedcols.size() ),
        [&]( const tbb::blocked_range<int>& r ) {
@@ -371,26 +547,25 @@ DominatedCols<REAL>::execute( const Problem<REAL>& problem,
              int collen = colvec.getLength();
              const int* colrows = colvec.getIndices();
              const REAL* colvals = colvec.getValues();
-             int scale;
-             int implrowlock;
+             DominatingCol& dominating = dominatingcols[k];
+             dominating.col = unbounded_col;
+             dominating.row = -1;
 
              // determine the scale of the dominating column depending on
              // whether the upper or lower bound is free, and remember which
              // row needs to be locked to protect the implied bound (if any)
              if( ubfree != 0 )
              {
-                scale = 1;
-                implrowlock = ubfree > 0 ? colrows[ubfree - 1] : -1;
+                dominating.scale = 1;
+                dominating.implrowlock = ubfree > 0 ? colrows[ubfree - 1] : -1;
              }
-             else if( lbfree != 0 )
+             else
              {
-                scale = -1;
-                implrowlock = lbfree > 0 ? colrows[lbfree - 1] : -1;
+                dominating.scale = -1;
+                dominating.implrowlock = lbfree > 0 ? colrows[lbfree - 1] : -1;
              }
-             else
-                continue;
 
-             int bestrow = -1;
+             int scale = dominating.scale;
              int bestrowsize = std::numeric_limits<int>::max();
 
              for( int j = 0; j < collen; ++j )
@@ -403,86 +578,190 @@ DominatedCols<REAL>::execute( const Problem<REAL>& problem,
                         scale * colvals[j] < 0 ) ) &&
                     rowsize[row] < bestrowsize )
                 {
-                   bestrow = j;
+                   dominating.row = row;
+                   dominating.scaled_val = colvals[j] * scale;
                    bestrowsize = rowsize[row];
                 }
              }
 
-             if( bestrow == -1 || bestrowsize <= 1 )
-                continue;
+             if( bestrowsize <= 1 )
+                dominating.row = -1;
+          }
+#ifdef PAPILO_TBB
+       } );
+#endif
+
+   // the unbounded columns with the same shortest row form a bucket that
+   // shares the candidate index of the row
+   dominatingcols.erase( std::remove_if( dominatingcols.begin(),
+                                         dominatingcols.end(),
+                                         []( const DominatingCol& d ) {
+                                            return d.row == -1;
+                                         } ),
+                         dominatingcols.end() );
+   pdqsort( dominatingcols.begin(), dominatingcols.end(),
+            []( const DominatingCol& a, const DominatingCol& b ) {
+               return std::make_pair( a.row, a.col ) <
+                      std::make_pair( b.row, b.col );
+            } );
+
+   Vec<int>& bucketstart = workspace.bucketstart;
+   bucketstart.clear();
+   for( int k = 0; k < (int) dominatingcols.size(); ++k )
+   {
+      if( k == 0 || dominatingcols[k].row != dominatingcols[k - 1].row )
+         bucketstart.push_back( k );
+   }
+   bucketstart.push_back( (int) dominatingcols.size() );
 
-             auto candrowvec =
-                 consMatrix.getRowCoefficients( colrows[bestrow] );
-             REAL scaled_val = colvals[bestrow] * scale;
-             REAL scaled_obj = obj[unbounded_col] * scale;
-             bestrow = colrows[bestrow];
-             int rowlen = candrowvec.getLength();
-             const int* rowcols = candrowvec.getIndices();
-             const REAL* rowvals = candrowvec.getValues();
+   auto& domcolreductions = workspace.domcolreductions;
+   domcolreductions.clear();
 
+   // scan the candidates of every bucket in an independent task
+#ifdef PAPILO_TBB
+   tbb::parallel_for(
+       tbb::blocked_range<int>( 0, (int) bucketstart.size() - 1, 1 ),
+       [&]( const tbb::blocked_range<int>& r ) {
+          BucketData& bucketData = workspace.bucketData.local();
+          Vec<DomcolCandidate>& candidates = bucketData.candidates;
+          Vec<int>& keystart = bucketData.keystart;
+          Vec<std::pair<int, int>>& dominated = bucketData.dominated;
+          for( int bucket = r.begin(); bucket != r.end(); ++bucket )
+#else
+   Vec<DomcolCandidate>& candidates = workspace.bucketData.candidates;
+   Vec<int>& keystart = workspace.bucketData.keystart;
+   Vec<std::pair<int, int>>& dominated = workspace.bucketData.dominated;
+   for( int bucket = 0; bucket < (int) bucketstart.size() - 1; ++bucket )
+#endif
+          {
+             const int row = dominatingcols[bucketstart[bucket]].row;
+             auto rowvec = consMatrix.getRowCoefficients( row );
+             int rowlen = rowvec.getLength();
+             const int* rowcols = rowvec.getIndices();
+             const REAL* rowvals = rowvec.getValues();
+             int64_t work = rowlen;
+
+             // index the columns of the row for both scales by the prefix of
+             // their positive signature. A dominated column needs a superset
+             // of the positive signature of the dominating column, so only the
+             // keys that are supersets of the prefix of the dominating column
+             // are scanned. Within a key the candidates are sorted by their
+             // scaled objective, which must not be smaller than the one of the
+             // dominating column.
+             candidates.clear();
              for( int j = 0; j != rowlen; ++j )
              {
                 int col = rowcols[j];
-                if( col == unbounded_col || ( cflags[unbounded_col].test( ColFlag::kIntegral ) &&
-                                  !cflags[col].test( ColFlag::kIntegral ) ) )
-                   continue;
-
-                bool to_lb = false;
-                bool to_ub = false;
+                if( !cflags[col].test( ColFlag::kLbInf ) )
+                   candidates.push_back( DomcolCandidate{
+                       (int) colinfo[col].getPosSignature( 1 ).getPrefix(
+                           kPrefixBits ),
+                       col, 1, rowvals[j], obj[col] } );
+                if( !cflags[col].test( ColFlag::kUbInf ) )
+                   candidates.push_back( DomcolCandidate{
+                       kNumKeys + (int) colinfo[col]
+                                      .getPosSignature( -1 )
+                                      .getPrefix( kPrefixBits ),
+                       col, -1, -rowvals[j], -obj[col] } );
+             }
 
-                if( !rflags[bestrow].test( RowFlag::kLhsInf,
-                                           RowFlag::kRhsInf ) )
-                {
-                   if( !cflags[col].test( ColFlag::kLbInf ) &&
-                       num.isEq( scaled_val, rowvals[j] ) &&
-                       num.isLE( scaled_obj, obj[col] ) &&
-                       checkDominance( unbounded_col, col, scale, 1 ) )
-                      to_lb = true;
-
-                   if( !cflags[col].test( ColFlag::kUbInf ) &&
-                       num.isEq( scaled_val, -rowvals[j] ) &&
-                       num.isLE( scaled_obj, -obj[col] ) &&
-                       checkDominance( unbounded_col, col, scale, -1 ) )
-                      to_ub = true;
-                }
-                else if( rflags[bestrow].test( RowFlag::kLhsInf ) )
-                {
-                   assert( scaled_val > 0 &&
-                           !rflags[bestrow].test( RowFlag::kRhsInf ) );
-                   if( !cflags[col].test( ColFlag::kLbInf ) &&
-                       num.isLE( scaled_val, rowvals[j] ) &&
-                       num.isLE( scaled_obj, obj[col] ) &&
-                       checkDominance( unbounded_col, col, scale, 1 ) )
-                      to_lb = true;
-
-                   if( !cflags[col].test( ColFlag::kUbInf ) &&
-                       num.isLE( scaled_val, -rowvals[j] ) &&
-                       num.isLE( scaled_obj, -obj[col] ) &&
-                       checkDominance( unbounded_col, col, scale, -1 ) )
-                      to_ub = true;
-                }
-                else
+             pdqsort( candidates.begin(), candidates.end(),
+                      []( const DomcolCandidate& a, const DomcolCandidate& b ) {
+                         return a.key < b.key ||
+                                ( a.key == b.key && a.obj > b.obj ) ||
+                                ( a.key == b.key && a.obj == b.obj &&
+                                  a.col < b.col );
+                      } );
+
+             keystart.assign( 2 * kNumKeys + 1, 0 );
+             for( const DomcolCandidate& cand : candidates )
+                ++keystart[cand.key + 1];
+             for( int key = 0; key != 2 * kNumKeys; ++key )
+                keystart[key + 1] += keystart[key];
+
+             for( int k = bucketstart[bucket];
+                  k != bucketstart[bucket + 1] && work < maxbucketwork; ++k )
+             {
+                const DominatingCol& dominating = dominatingcols[k];
+                const int unbounded_col = dominating.col;
+                const int scale = dominating.scale;
+                const REAL& scaled_val = dominating.scaled_val;
+                REAL scaled_obj = obj[unbounded_col] * scale;
+                const int prefix = (int) colinfo[unbounded_col]
+                                       .getPosSignature( scale )
+                                       .getPrefix( kPrefixBits );
+
+                dominated.clear();
+
+                for( int side = 0; side != 2; ++side )
                 {
-                   assert( scaled_val < 0 &&
-                           rflags[bestrow].test( RowFlag::kRhsInf ) );
-                   if( !cflags[col].test( ColFlag::kLbInf ) &&
-                       num.isGE( scaled_val, rowvals[j] ) &&
-                       num.isLE( scaled_obj, obj[col] ) &&
-                       checkDominance( unbounded_col, col, scale, 1 ) )
-                      to_lb = true;
-
-                   if( !cflags[col].test( ColFlag::kUbInf ) &&
-                       num.isGE( scaled_val, -rowvals[j] ) &&
-                       num.isLE( scaled_obj, -obj[col] ) &&
-                       checkDominance( unbounded_col, col, scale, -1 ) )
-                      to_ub = true;
+                   // iterate all keys that are supersets of the prefix
+                   for( int key = prefix;
+                        key < kNumKeys && work < maxbucketwork;
+                        key = ( key + 1 ) | prefix )
+                   {
+                      const int first = keystart[side * kNumKeys + key];
+                      const int last = keystart[side * kNumKeys + key + 1];
+
+                      for( int i = first; i != last; ++i )
+                      {
+                         const DomcolCandidate& cand = candidates[i];
+
+                         if( !num.isLE( scaled_obj, cand.obj ) ||
+                             ++work > maxbucketwork )
+                            break;
+
+                         int col = cand.col;
+                         if( col == unbounded_col ||
+                             ( cflags[unbounded_col].test(
+                                   ColFlag::kIntegral ) &&
+                               !cflags[col].test( ColFlag::kIntegral ) ) )
+                            continue;
+
+                         bool coefallows;
+                         if( !rflags[row].test( RowFlag::kLhsInf,
+                                                RowFlag::kRhsInf ) )
+                            coefallows = num.isEq( scaled_val, cand.val );
+                         else if( rflags[row].test( RowFlag::kLhsInf ) )
+                         {
+                            assert( scaled_val > 0 &&
+                                    !rflags[row].test( RowFlag::kRhsInf ) );
+                            coefallows = num.isLE( scaled_val, cand.val );
+                         }
+                         else
+                         {
+                            assert( scaled_val < 0 &&
+                                    rflags[row].test( RowFlag::kRhsInf ) );
+                            coefallows = num.isGE( scaled_val, cand.val );
+                         }
+
+                         if( coefallows &&
+                             checkDominance( unbounded_col, col, scale,
+                                             cand.scale ) )
+                            dominated.emplace_back( col, cand.scale );
+                      }
+                   }
                 }
 
-                if( to_lb || to_ub )
+                // a column dominated with both scales is moved to its lower
+                // bound
+                pdqsort( dominated.begin(), dominated.end(),
+                         []( const std::pair<int, int>& a,
+                             const std::pair<int, int>& b ) {
+                            return a.first < b.first ||
+                                   ( a.first == b.first && a.second > b.second );
+                         } );
+
+                for( int i = 0; i != (int) dominated.size(); ++i )
                 {
+                   if( i != 0 && dominated[i].first == dominated[i - 1].first )
+                      continue;
+
                    domcolreductions.push_back( DomcolReduction{
-                       unbounded_col, col, implrowlock,
-                       to_lb ? BoundChange::kUpper : BoundChange::kLower } );
+                       unbounded_col, dominated[i].first,
+                       dominating.implrowlock,
+                       dominated[i].second == 1 ? BoundChange::kUpper
+                                                : BoundChange::kLower } );
                 }
              }
           }
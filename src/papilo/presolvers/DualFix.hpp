@@ -26,6 +26,7 @@
 #include "papilo/core/PresolveMethod.hpp"
 #include "papilo/core/Problem.hpp"
 #include "papilo/core/ProblemUpdate.hpp"
+#include <numeric>
 
 namespace papilo
 {
@@ -107,7 +108,6 @@ DualFix<REAL>::execute( const Problem<REAL>& problem,
    const Vec<REAL>& objective = problem.getObjective().coefficients;
    const Vec<REAL>& lbs = problem.getLowerBounds();
    const Vec<REAL>& ubs = problem.getUpperBounds();
-   const int ncols = consMatrix.getNCols();
    const Vec<RowFlags>& rflags = consMatrix.getRowFlags();
    const Vec<REAL>& lhs = consMatrix.getLeftHandSides();
    const Vec<REAL>& rhs = consMatrix.getRightHandSides();
@@ -115,6 +115,16 @@ DualFix<REAL>::execute( const Problem<REAL>& problem,
    PresolveStatus result = PresolveStatus::kUnchanged;
    bool noStrongReductions = problemUpdate.getPresolveOptions().dualreds < 2;
 
+   // the locks and implied bounds of a column only change if the column or
+   // one of its rows changed since the last call
+   Vec<int> cols;
+   if( !this->getAffectedCols( problemUpdate, cols ) )
+   {
+      cols.resize( consMatrix.getNCols() );
+      std::iota( cols.begin(), cols.end(), 0 );
+   }
+   const int ncols = static_cast<int>( cols.size() );
+
    // calculating the basis for variable tightening (not fixings) may lead in
    // the postsolving step to a solution that is not in a vertex. In this case a
    // crossover would be required is too expensive performance wise
@@ -133,7 +143,7 @@ DualFix<REAL>::execute( const Problem<REAL>& problem,
    if( problemUpdate.getPresolveOptions().runs_sequential() ||
        !problemUpdate.getPresolveOptions().dual_fix_parallel )
    {
-      for( int col = 0; col < ncols; ++col )
+      for( int col : cols )
       {
          PresolveStatus local_status = perform_dual_fix_step(
              num, reductions, consMatrix, activities, cflags, objective, lbs,
@@ -157,11 +167,11 @@ DualFix<REAL>::execute( const Problem<REAL>& problem,
       tbb::parallel_for(
           tbb::blocked_range<int>( 0, ncols ),
           [&]( const tbb::blocked_range<int>& r ) {
-             for( int col = r.begin(); col < r.end(); ++col )
+             for( int i = r.begin(); i < r.end(); ++i )
              {
                 PresolveStatus local_status = perform_dual_fix_step(
-                    num, stored_reductions[col], consMatrix, activities, cflags,
-                    objective, lbs, ubs, rflags, lhs, rhs, col,
+                    num, stored_reductions[i], consMatrix, activities, cflags,
+                    objective, lbs, ubs, rflags, lhs, rhs, cols[i],
                     noStrongReductions, skip_variable_tightening, bound_tightening_offset );
                 assert( local_status == PresolveStatus::kUnchanged ||
                         local_status == PresolveStatus::kReduced ||
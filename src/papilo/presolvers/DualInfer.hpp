@@ -27,6 +27,7 @@
 #include "papilo/core/Problem.hpp"
 #include "papilo/core/ProblemUpdate.hpp"
 #include "papilo/core/SingleRow.hpp"
+#include "papilo/misc/compress_vector.hpp"
 
 namespace papilo
 {
@@ -34,6 +35,23 @@ namespace papilo
 template <typename REAL>
 class DualInfer : public PresolveMethod<REAL>
 {
+   /// vectors of execute() kept between the calls, so that the rounds
+   /// allocate nothing until the problem is compressed
+   struct Workspace
+   {
+      Vec<RowActivity<REAL>> activitiesCopy;
+      Vec<REAL> dualLB;
+      Vec<REAL> dualUB;
+      Vec<ColFlags> dualColFlags;
+      Vec<RowFlags> dualRowFlags;
+      Vec<std::pair<int, int>> checkRedundantBounds;
+      Vec<RowActivity<REAL>> dualActivities;
+      Vec<int> changedActivity;
+      Vec<int> nextChangedActivity;
+   };
+
+   Workspace workspace;
+
  public:
    DualInfer() : PresolveMethod<REAL>()
    {
@@ -48,7 +66,26 @@ class DualInfer : public PresolveMethod<REAL>
    {
       if( presolveOptions.dualreds == 0 )
          this->setEnabled( false );
-      return false;
+      return true;
+   }
+
+   void
+   compress( const Vec<int>& rowmap, const Vec<int>& colmap ) override
+   {
+      std::size_t nrows =
+          rowmap.size() - std::count( rowmap.begin(), rowmap.end(), -1 );
+      std::size_t ncols =
+          colmap.size() - std::count( colmap.begin(), colmap.end(), -1 );
+
+      shrink_scratch_vector( workspace.activitiesCopy, nrows );
+      shrink_scratch_vector( workspace.dualLB, nrows );
+      shrink_scratch_vector( workspace.dualUB, nrows );
+      shrink_scratch_vector( workspace.dualColFlags, nrows );
+      shrink_scratch_vector( workspace.dualRowFlags, ncols );
+      shrink_scratch_vector( workspace.checkRedundantBounds, ncols );
+      shrink_scratch_vector( workspace.dualActivities, ncols );
+      shrink_scratch_vector( workspace.changedActivity, ncols );
+      shrink_scratch_vector( workspace.nextChangedActivity, ncols );
    }
    
    bool
@@ -115,7 +152,8 @@ DualInfer<REAL>::execute( const Problem<REAL>& problem,
    // presolver can be expensive otherwise
    this->skipRounds( this->getNCalls() );
 
-   Vec<RowActivity<REAL>> activitiesCopy( activities );
+   Vec<RowActivity<REAL>>& activitiesCopy = workspace.activitiesCopy;
+   activitiesCopy.assign( activities.begin(), activities.end() );
    auto checkNonImpliedBounds = [&]( int col, bool& lbinf, bool& ubinf ) {
       const REAL& lb = lbValues[col];
       const REAL& ub = ubValues[col];
@@ -167,12 +205,13 @@ DualInfer<REAL>::execute( const Problem<REAL>& problem,
    };
 
    // initialize dual variable domains
-   Vec<REAL> dualLB;
-   Vec<REAL> dualUB;
-   Vec<ColFlags> dualColFlags( nrows );
+   Vec<REAL>& dualLB = workspace.dualLB;
+   Vec<REAL>& dualUB = workspace.dualUB;
+   Vec<ColFlags>& dualColFlags = workspace.dualColFlags;
 
-   dualLB.resize( nrows, REAL{ 0 } );
-   dualUB.resize( nrows, REAL{ 0 } );
+   dualLB.assign( nrows, REAL{ 0 } );
+   dualUB.assign( nrows, REAL{ 0 } );
+   dualColFlags.assign( nrows, ColFlags() );
 
    for( int i = 0; i != nrows; ++i )
    {
@@ -191,9 +230,12 @@ DualInfer<REAL>::execute( const Problem<REAL>& problem,
    // redundant to skip them for propagation
    const Vec<REAL>& dualLHS = obj;
    const Vec<REAL>& dualRHS = obj;
-   Vec<RowFlags> dualRowFlags( ncols );
+   Vec<RowFlags>& dualRowFlags = workspace.dualRowFlags;
+   dualRowFlags.assign( ncols, RowFlags() );
 
-   Vec<std::pair<int, int>> checkRedundantBounds;
+   Vec<std::pair<int, int>>& checkRedundantBounds =
+       workspace.checkRedundantBounds;
+   checkRedundantBounds.clear();
    checkRedundantBounds.reserve( ncols );
    const Vec<int>& colperm = problemUpdate.getRandomColPerm();
    for( int c = 0; c != ncols; ++c )
@@ -251,10 +293,13 @@ DualInfer<REAL>::execute( const Problem<REAL>& problem,
    }
 
    // compute initial activities, skip redundant rows
-   Vec<RowActivity<REAL>> dualActivities( ncols );
+   Vec<RowActivity<REAL>>& dualActivities = workspace.dualActivities;
+   dualActivities.assign( ncols, RowActivity<REAL>() );
 
-   Vec<int> changedActivity;
-   Vec<int> nextChangedActivity;
+   Vec<int>& changedActivity = workspace.changedActivity;
+   Vec<int>& nextChangedActivity = workspace.nextChangedActivity;
+   changedActivity.clear();
+   nextChangedActivity.clear();
 
    auto checkRedundancy = [&]( int dualRow ) {
       if( ( dualRowFlags[dualRow].test( RowFlag::kLhsInf ) ||
@@ -26,10 +26,16 @@
 #include "papilo/core/PresolveMethod.hpp"
 #include "papilo/core/Problem.hpp"
 #include "papilo/core/ProblemUpdate.hpp"
+#include "papilo/misc/Array.hpp"
 #include "papilo/misc/Num.hpp"
 #include "papilo/misc/fmt.hpp"
 #include "papilo/external/pdqsort/pdqsort.h"
+#include <algorithm>
+#include <atomic>
 #include <boost/dynamic_bitset.hpp>
+#ifdef PAPILO_TBB
+#include "papilo/misc/tbb.hpp"
+#endif
 
 namespace papilo
 {
@@ -38,6 +44,18 @@ template <typename REAL>
 class Substitution : public PresolveMethod<REAL>
 {
    Vec<int> ntried;
+   bool parallelselection = false;
+
+   using Equality = std::tuple<SparseVectorView<REAL>, int>;
+
+   /// substitution of a column with an equality found in the parallel mode
+   struct Candidate
+   {
+      int row;
+      int col;
+      int lbrowlock;
+      int ubrowlock;
+   };
 
  public:
    Substitution() : PresolveMethod<REAL>()
@@ -70,6 +88,17 @@ class Substitution : public PresolveMethod<REAL>
       return true;
    }
 
+   void
+   addPresolverParams( ParameterSet& paramSet ) override
+   {
+      paramSet.addParameter(
+          "substitution.parallelselection",
+          "find a substitution for every equality in parallel and apply a "
+          "set of them whose columns share no rows, chosen deterministically "
+          "in the order of the equalities",
+          parallelselection );
+   }
+
    PresolveStatus
    execute( const Problem<REAL>& problem,
             const ProblemUpdate<REAL>& problemUpdate,
@@ -79,6 +108,34 @@ class Substitution : public PresolveMethod<REAL>
    bool
    is_divisible( const Num<REAL>& num, int length, const REAL* row_values,
                  REAL min_abs_int_value ) const;
+
+   void
+   set_parallel_selection( bool val );
+
+ private:
+   bool
+   collect_column_candidates( const Problem<REAL>& problem,
+                              const ProblemUpdate<REAL>& problemUpdate,
+                              const Num<REAL>& num,
+                              const SparseVectorView<REAL>& equality,
+                              const boost::dynamic_bitset<>* colUnusable,
+                              Vec<int>& column_candidates ) const;
+
+   bool
+   is_implied_free( const Problem<REAL>& problem, const Num<REAL>& num,
+                    int row, int col, const REAL& rowvalue,
+                    const boost::dynamic_bitset<>* touchedRows,
+                    int& lbrowlock, int& ubrowlock ) const;
+
+   void
+   add_substitution( Reductions<REAL>& reductions, int row, int col,
+                     int lbrowlock, int ubrowlock );
+
+   PresolveStatus
+   execute_parallel( const Problem<REAL>& problem,
+                     const ProblemUpdate<REAL>& problemUpdate,
+                     const Num<REAL>& num, Reductions<REAL>& reductions,
+                     const Vec<Equality>& equalities );
 };
 
 #ifdef PAPILO_USE_EXTERN_TEMPLATES
@@ -97,16 +154,7 @@ Substitution<REAL>::execute( const Problem<REAL>& problem,
    // verify the conditions add them to a hash map, loop over the hash map
    // and compute the implied bounds and finally look for implied free
    // variables and add reductions
-   const auto& domains = problem.getVariableDomains();
-   const auto& lower_bounds = domains.lower_bounds;
-   const auto& upper_bounds = domains.upper_bounds;
-   const auto& cflags = domains.flags;
-
-   const auto& activities = problem.getRowActivities();
-
    const auto& constMatrix = problem.getConstraintMatrix();
-   const auto& lhs_values = constMatrix.getLeftHandSides();
-   const auto& rhs_values = constMatrix.getRightHandSides();
    const auto& rflags = constMatrix.getRowFlags();
    const auto& nrows = constMatrix.getNRows();
    const auto& ncols = constMatrix.getNCols();
@@ -114,7 +162,6 @@ Substitution<REAL>::execute( const Problem<REAL>& problem,
 
    PresolveStatus result = PresolveStatus::kUnchanged;
 
-   using Equality = std::tuple<SparseVectorView<REAL>, int>;
    Vec<Equality> equalities;
    equalities.reserve( nrows );
    for( int i = 0; i < nrows; ++i )
@@ -125,7 +172,8 @@ Substitution<REAL>::execute( const Problem<REAL>& problem,
          continue;
 
       assert( !rflags[i].test( RowFlag::kLhsInf, RowFlag::kRhsInf ) &&
-              lhs_values[i] == rhs_values[i] );
+              constMatrix.getLeftHandSides()[i] ==
+                  constMatrix.getRightHandSides()[i] );
 
       equalities.emplace_back( constMatrix.getRowCoefficients( i ), i );
    }
@@ -140,6 +188,10 @@ Substitution<REAL>::execute( const Problem<REAL>& problem,
                                        rowperm[std::get<1>( b )] );
             } );
 
+   if( parallelselection )
+      return execute_parallel( problem, problemUpdate, num, reductions,
+                               equalities );
+
    boost::dynamic_bitset<> colUnusable( ncols );
    boost::dynamic_bitset<> touchedRows( nrows );
    Vec<int> column_candidates;
@@ -148,85 +200,304 @@ Substitution<REAL>::execute( const Problem<REAL>& problem,
    for( auto equality : equalities )
    {
       int row = std::get<1>( equality );
-      const int length = std::get<0>( equality ).getLength();
       const int* rowindices = std::get<0>( equality ).getIndices();
       const REAL* rowvalues = std::get<0>( equality ).getValues();
       REAL maxabsvalue = std::get<0>( equality ).getMaxAbsValue();
-      REAL minabsintvalue = maxabsvalue;
-      bool containsContinuous = false;
-      bool containsNonBinInt = false;
-      for( int i = 0; i != length; ++i )
+
+      if( !collect_column_candidates( problem, problemUpdate, num,
+                                      std::get<0>( equality ), &colUnusable,
+                                      column_candidates ) )
+         continue;
+
+      for( int i : column_candidates )
       {
-         if( !cflags[rowindices[i]].test( ColFlag::kIntegral ) )
+         int col = rowindices[i];
+         auto colvec = constMatrix.getColumnCoefficients( col );
+
+         // check the numerics conditions
+         if( ( abs( rowvalues[i] ) <
+                   REAL(problemUpdate.getPresolveOptions().markowitz_tolerance) *
+                       maxabsvalue &&
+               abs( rowvalues[i] ) <
+                   REAL(problemUpdate.getPresolveOptions().markowitz_tolerance) *
+                       colvec.getMaxAbsValue() ) )
+            continue;
+
+         int lbrowlock = -1;
+         int ubrowlock = -1;
+
+         // mark the column to not be used in later substitutions, because
+         // it's either not free or used for this substitution
+         colUnusable[col] = true;
+
+         if( is_implied_free( problem, num, row, col, rowvalues[i],
+                              &touchedRows, lbrowlock, ubrowlock ) )
          {
-            containsContinuous = true;
+            if (!this->check_if_substitution_generates_huge_or_small_coefficients(num, constMatrix, row, col))
+               return PresolveStatus::kUnchanged;
+            // reductions
+            result = PresolveStatus::kReduced;
+            add_substitution( reductions, row, col, lbrowlock, ubrowlock );
+
+            const int* indices = colvec.getIndices();
+            const int len = colvec.getLength();
+
+            for( int j = 0; j != len; ++j )
+               touchedRows.set( indices[j] );
+
             break;
          }
+      }
+   }
 
-         if( !problemUpdate.getPresolveOptions().substitutebinarieswithints &&
-             !domains.isBinary( rowindices[i] ) )
-            containsNonBinInt = true;
+   return result;
+}
 
-         if( abs( rowvalues[i] ) < minabsintvalue )
-            minabsintvalue = abs( rowvalues[i] );
+/// collects the positions of the columns of the equality that may be
+/// substituted with it ordered by the sparsification condition; returns false
+/// if the equality cannot be used for any substitution
+template <typename REAL>
+bool
+Substitution<REAL>::collect_column_candidates(
+    const Problem<REAL>& problem, const ProblemUpdate<REAL>& problemUpdate,
+    const Num<REAL>& num, const SparseVectorView<REAL>& equality,
+    const boost::dynamic_bitset<>* colUnusable,
+    Vec<int>& column_candidates ) const
+{
+   const auto& domains = problem.getVariableDomains();
+   const auto& cflags = domains.flags;
+
+   const int length = equality.getLength();
+   const int* rowindices = equality.getIndices();
+   const REAL* rowvalues = equality.getValues();
+   REAL maxabsvalue = equality.getMaxAbsValue();
+   REAL minabsintvalue = maxabsvalue;
+   bool containsContinuous = false;
+   bool containsNonBinInt = false;
+   for( int i = 0; i != length; ++i )
+   {
+      if( !cflags[rowindices[i]].test( ColFlag::kIntegral ) )
+      {
+         containsContinuous = true;
+         break;
       }
 
-      // If the row contains no continuous variables it might be suitable for
-      // substituting an integer variable. We can only substitute those
-      // integer variables whose absolute coefficient value in the row is
-      // equal to the smallest absolute coefficient in the row. Additional we
-      // need to ensure that all coefficients are integral if divided by the
-      // smallest absolute coefficient.
-      if( !containsContinuous &&
-          !is_divisible( num, length, rowvalues, minabsintvalue ) )
+      if( !problemUpdate.getPresolveOptions().substitutebinarieswithints &&
+          !domains.isBinary( rowindices[i] ) )
+         containsNonBinInt = true;
+
+      if( abs( rowvalues[i] ) < minabsintvalue )
+         minabsintvalue = abs( rowvalues[i] );
+   }
+
+   // If the row contains no continuous variables it might be suitable for
+   // substituting an integer variable. We can only substitute those
+   // integer variables whose absolute coefficient value in the row is
+   // equal to the smallest absolute coefficient in the row. Additional we
+   // need to ensure that all coefficients are integral if divided by the
+   // smallest absolute coefficient.
+   if( !containsContinuous &&
+       !is_divisible( num, length, rowvalues, minabsintvalue ) )
+      return false;
+
+   column_candidates.clear();
+
+   for( int i = 0; i < length; ++i )
+   {
+      int col = rowindices[i];
+      // if the column has been already used for a substitution or known
+      // to be not implied free we can skip it
+      if( colUnusable != nullptr && ( *colUnusable )[col] )
          continue;
 
-      column_candidates.clear();
+      // check if integrality condition is guaranteed for this column
+      if( cflags[col].test( ColFlag::kIntegral ) )
+      {
+         // if the row contains continuous variables we cannot use it for
+         // substituting an integral column
+         if( containsContinuous )
+            continue;
+
+         // TODO: why not saving the index of the value also? this would
+         // reduce the if statement to just comparing indices
+
+         // the divisibility of the coefficients has been checked
+         // above and we know that we can use it only if its coefficient has
+         // the smallest magnitude of the coefficients within the row
+         if( !num.isEq( abs( rowvalues[i] ), minabsintvalue ) )
+            continue;
+
+         // do not substitute a binary variable with integer variables if the
+         // option is set
+         if( !problemUpdate.getPresolveOptions()
+                  .substitutebinarieswithints &&
+             containsNonBinInt && domains.isBinary( rowindices[i] ) )
+            continue;
+      }
+
+      column_candidates.push_back( i );
+   }
+
+   pdqsort( column_candidates.begin(), column_candidates.end(),
+            [&]( int i1, int i2 ) {
+               int col1 = rowindices[i1];
+               int col2 = rowindices[i2];
+               return problemUpdate
+                   .check_sparsification_condition_on_substitution( col1,
+                                                                    col2 );
+            } );
 
-      for( int i = 0; i < length; ++i )
+   return true;
+}
+
+/// checks whether the equality and the other rows of the column imply its
+/// bounds and returns the rows implying them; if touchedRows is given the
+/// rows in it are only used if the other rows do not imply the bounds
+template <typename REAL>
+bool
+Substitution<REAL>::is_implied_free( const Problem<REAL>& problem,
+                                     const Num<REAL>& num, int row, int col,
+                                     const REAL& rowvalue,
+                                     const boost::dynamic_bitset<>* touchedRows,
+                                     int& lbrowlock, int& ubrowlock ) const
+{
+   const auto& domains = problem.getVariableDomains();
+   const auto& lower_bounds = domains.lower_bounds;
+   const auto& upper_bounds = domains.upper_bounds;
+   const auto& cflags = domains.flags;
+
+   const auto& activities = problem.getRowActivities();
+
+   const auto& constMatrix = problem.getConstraintMatrix();
+   const auto& lhs_values = constMatrix.getLeftHandSides();
+   const auto& rhs_values = constMatrix.getRightHandSides();
+   const auto& rflags = constMatrix.getRowFlags();
+
+   bool upperboundImplied =
+       row_implies_UB( num, lhs_values[row], rhs_values[row], rflags[row],
+                       activities[row], rowvalue, lower_bounds[col],
+                       upper_bounds[col], cflags[col] );
+   bool lowerboundImplied =
+       row_implies_LB( num, lhs_values[row], rhs_values[row], rflags[row],
+                       activities[row], rowvalue, lower_bounds[col],
+                       upper_bounds[col], cflags[col] );
+
+   auto colvec = constMatrix.getColumnCoefficients( col );
+   const REAL* colvalues = colvec.getValues();
+   const int* colindices = colvec.getIndices();
+   const int collength = colvec.getLength();
+
+   auto checkIfImpliedFree = [&]( bool checkTouchedRows ) {
+      int j = 0;
+
+      while( ( !upperboundImplied || !lowerboundImplied ) &&
+             j != collength )
       {
-         int col = rowindices[i];
-         // if the column has been already used for a substitution or known
-         // to be not implied free we can skip it
-         if( colUnusable[col] )
+         int colrow = colindices[j];
+         REAL colval = colvalues[j];
+         ++j;
+
+         if( colrow == row )
+            continue;
+
+         bool isTouched =
+             touchedRows != nullptr && touchedRows->test( colrow );
+
+         if( ( !checkTouchedRows && isTouched ) ||
+             ( checkTouchedRows && !isTouched ) )
             continue;
 
-         // check if integrality condition is guaranteed for this column
-         if( cflags[col].test( ColFlag::kIntegral ) )
+         if( !upperboundImplied )
          {
-            // if the row contains continuous variables we cannot use it for
-            // substituting an integral column
-            if( containsContinuous )
-               continue;
-
-            // TODO: why not saving the index of the value also? this would
-            // reduce the if statement to just comparing indices
-
-            // the divisibility of the coefficients has been checked
-            // above and we know that we can use it only if its coefficient has
-            // the smallest magnitude of the coefficients within the row
-            if( !num.isEq( abs( rowvalues[i] ), minabsintvalue ) )
-               continue;
-
-            // do not substitute a binary variable with integer variables if the
-            // option is set
-            if( !problemUpdate.getPresolveOptions()
-                     .substitutebinarieswithints &&
-                containsNonBinInt && domains.isBinary( rowindices[i] ) )
-               continue;
+            upperboundImplied = row_implies_UB(
+                num, lhs_values[colrow], rhs_values[colrow],
+                rflags[colrow], activities[colrow], colval,
+                lower_bounds[col], upper_bounds[col], cflags[col] );
+
+            if( upperboundImplied && colrow != row &&
+                colrow != lbrowlock )
+               ubrowlock = colrow;
          }
 
-         column_candidates.push_back( i );
+         if( !lowerboundImplied )
+         {
+            lowerboundImplied = row_implies_LB(
+                num, lhs_values[colrow], rhs_values[colrow],
+                rflags[colrow], activities[colrow], colval,
+                lower_bounds[col], upper_bounds[col], cflags[col] );
+
+            if( lowerboundImplied && colrow != row &&
+                colrow != ubrowlock )
+               lbrowlock = colrow;
+         }
       }
+   };
+
+   checkIfImpliedFree( false );
+   if( touchedRows != nullptr )
+      checkIfImpliedFree( true );
+
+   return upperboundImplied && lowerboundImplied;
+}
+
+template <typename REAL>
+void
+Substitution<REAL>::add_substitution( Reductions<REAL>& reductions, int row,
+                                      int col, int lbrowlock, int ubrowlock )
+{
+   ++ntried[row];
+
+   TransactionGuard<REAL> guard{ reductions };
+
+   reductions.lockRow( row );
+   if( lbrowlock != -1 )
+      reductions.lockRow( lbrowlock );
+   if( ubrowlock != -1 )
+      reductions.lockRow( ubrowlock );
 
-      pdqsort( column_candidates.begin(), column_candidates.end(),
-               [&]( int i1, int i2 ) {
-                  int col1 = rowindices[i1];
-                  int col2 = rowindices[i2];
-                  return problemUpdate
-                      .check_sparsification_condition_on_substitution( col1,
-                                                                       col2 );
-               } );
+   reductions.lockColBounds( col );
+
+   if( lbrowlock != -1 )
+      reductions.impliedBounds( true, lbrowlock );
+   if( ubrowlock != -1 )
+      reductions.impliedBounds( false, ubrowlock );
+
+   reductions.aggregateFreeCol( col, row );
+}
+
+/// finds the first substitution of every equality in parallel and applies the
+/// greedy independent set of them in the order of the equalities: two
+/// substitutions conflict if their columns share a row. The set is found in
+/// rounds, in each round the substitutions that come first on all rows of
+/// their column are chosen and the ones sharing a row with them are dropped.
+/// The result only depends on the order of the equalities, which is given by
+/// the random seed, and not on the number of threads.
+template <typename REAL>
+PresolveStatus
+Substitution<REAL>::execute_parallel( const Problem<REAL>& problem,
+                                      const ProblemUpdate<REAL>& problemUpdate,
+                                      const Num<REAL>& num,
+                                      Reductions<REAL>& reductions,
+                                      const Vec<Equality>& equalities )
+{
+   const auto& constMatrix = problem.getConstraintMatrix();
+   const int nrows = constMatrix.getNRows();
+   const int nequalities = static_cast<int>( equalities.size() );
+   const REAL markowitz_tolerance =
+       REAL( problemUpdate.getPresolveOptions().markowitz_tolerance );
+
+   Vec<Candidate> candidates( nequalities, Candidate{ -1, -1, -1, -1 } );
+
+   auto findSubstitution = [&]( int k, Vec<int>& column_candidates ) {
+      int row = std::get<1>( equalities[k] );
+      const SparseVectorView<REAL>& equality = std::get<0>( equalities[k] );
+      const int* rowindices = equality.getIndices();
+      const REAL* rowvalues = equality.getValues();
+      REAL maxabsvalue = equality.getMaxAbsValue();
+
+      if( !collect_column_candidates( problem, problemUpdate, num, equality,
+                                      nullptr, column_candidates ) )
+         return;
 
       for( int i : column_candidates )
       {
@@ -234,115 +505,130 @@ Substitution<REAL>::execute( const Problem<REAL>& problem,
          auto colvec = constMatrix.getColumnCoefficients( col );
 
          // check the numerics conditions
-         if( ( abs( rowvalues[i] ) <
-                   REAL(problemUpdate.getPresolveOptions().markowitz_tolerance) *
-                       maxabsvalue &&
-               abs( rowvalues[i] ) <
-                   REAL(problemUpdate.getPresolveOptions().markowitz_tolerance) *
-                       colvec.getMaxAbsValue() ) )
+         if( abs( rowvalues[i] ) < markowitz_tolerance * maxabsvalue &&
+             abs( rowvalues[i] ) <
+                 markowitz_tolerance * colvec.getMaxAbsValue() )
             continue;
 
          int lbrowlock = -1;
          int ubrowlock = -1;
 
-         // mark the column to not be used in later substitutions, because
-         // it's either not free or used for this substitution
-         colUnusable[col] = true;
-
-         bool upperboundImplied =
-             row_implies_UB( num, lhs_values[row], rhs_values[row], rflags[row],
-                             activities[row], rowvalues[i], lower_bounds[col],
-                             upper_bounds[col], cflags[col] );
-         bool lowerboundImplied =
-             row_implies_LB( num, lhs_values[row], rhs_values[row], rflags[row],
-                             activities[row], rowvalues[i], lower_bounds[col],
-                             upper_bounds[col], cflags[col] );
+         if( is_implied_free( problem, num, row, col, rowvalues[i], nullptr,
+                              lbrowlock, ubrowlock ) )
+         {
+            if( this->
+                check_if_substitution_generates_huge_or_small_coefficients(
+                    num, constMatrix, row, col ) )
+               candidates[k] = Candidate{ row, col, lbrowlock, ubrowlock };
+            return;
+         }
+      }
+   };
+
+#ifdef PAPILO_TBB
+   tbb::combinable<Vec<int>> column_candidates;
+   tbb::parallel_for( tbb::blocked_range<int>( 0, nequalities ),
+                      [&]( const tbb::blocked_range<int>& r ) {
+                         Vec<int>& local = column_candidates.local();
+                         for( int k = r.begin(); k != r.end(); ++k )
+                            findSubstitution( k, local );
+                      } );
+#else
+   Vec<int> column_candidates;
+   for( int k = 0; k != nequalities; ++k )
+      findSubstitution( k, column_candidates );
+#endif
 
-         const REAL* colvalues = colvec.getValues();
-         const int* colindices = colvec.getIndices();
-         const int collength = colvec.getLength();
+   Vec<int> active;
+   for( int k = 0; k != nequalities; ++k )
+   {
+      if( candidates[k].col != -1 )
+         active.push_back( k );
+   }
 
-         auto checkIfImpliedFree = [&]( bool checkTouchedRows ) {
-            int j = 0;
+   if( active.empty() )
+      return PresolveStatus::kUnchanged;
+
+   // the first active substitution on every row, written by all threads
+   Array<std::atomic_int> rowowner( nrows );
+   Vec<uint8_t> rowblocked( nrows, 0 );
+   Vec<uint8_t> chosen( nequalities, 0 );
+   Vec<int> next;
+
+   auto forEachActive = [&]( auto&& func ) {
+#ifdef PAPILO_TBB
+      tbb::parallel_for( tbb::blocked_range<std::size_t>( 0, active.size() ),
+                         [&]( const tbb::blocked_range<std::size_t>& r ) {
+                            for( std::size_t i = r.begin(); i != r.end(); ++i )
+                               func( active[i] );
+                         } );
+#else
+      for( int k : active )
+         func( k );
+#endif
+   };
 
-            while( ( !upperboundImplied || !lowerboundImplied ) &&
-                   j != collength )
+   while( !active.empty() )
+   {
+      forEachActive( [&]( int k ) {
+         auto colvec = constMatrix.getColumnCoefficients( candidates[k].col );
+         for( int j = 0; j != colvec.getLength(); ++j )
+            rowowner[colvec.getIndices()[j]].store( nequalities,
+                                                    std::memory_order_relaxed );
+      } );
+
+      forEachActive( [&]( int k ) {
+         auto colvec = constMatrix.getColumnCoefficients( candidates[k].col );
+         for( int j = 0; j != colvec.getLength(); ++j )
+         {
+            std::atomic_int& owner = rowowner[colvec.getIndices()[j]];
+            int current = owner.load( std::memory_order_relaxed );
+            while( k < current && !owner.compare_exchange_weak(
+                                      current, k, std::memory_order_relaxed ) )
             {
-               int colrow = colindices[j];
-               REAL colval = colvalues[j];
-               ++j;
-
-               if( colrow == row )
-                  continue;
-
-               bool isTouched = touchedRows.test( colrow );
-
-               if( ( !checkTouchedRows && isTouched ) ||
-                   ( checkTouchedRows && !isTouched ) )
-                  continue;
-
-               if( !upperboundImplied )
-               {
-                  upperboundImplied = row_implies_UB(
-                      num, lhs_values[colrow], rhs_values[colrow],
-                      rflags[colrow], activities[colrow], colval,
-                      lower_bounds[col], upper_bounds[col], cflags[col] );
-
-                  if( upperboundImplied && colrow != row &&
-                      colrow != lbrowlock )
-                     ubrowlock = colrow;
-               }
-
-               if( !lowerboundImplied )
-               {
-                  lowerboundImplied = row_implies_LB(
-                      num, lhs_values[colrow], rhs_values[colrow],
-                      rflags[colrow], activities[colrow], colval,
-                      lower_bounds[col], upper_bounds[col], cflags[col] );
-
-                  if( lowerboundImplied && colrow != row &&
-                      colrow != ubrowlock )
-                     lbrowlock = colrow;
-               }
             }
-         };
-
-         checkIfImpliedFree( false );
-         checkIfImpliedFree( true );
+         }
+      } );
 
-         if( upperboundImplied && lowerboundImplied )
+      // a substitution that comes first on all of its rows is chosen, the
+      // columns of the chosen substitutions share no rows
+      forEachActive( [&]( int k ) {
+         auto colvec = constMatrix.getColumnCoefficients( candidates[k].col );
+         for( int j = 0; j != colvec.getLength(); ++j )
          {
-            if (!this->check_if_substitution_generates_huge_or_small_coefficients(num, constMatrix, row, col))
-               return PresolveStatus::kUnchanged;
-            // reductions
-            result = PresolveStatus::kReduced;
-            ++ntried[row];
-
-            TransactionGuard<REAL> guard{ reductions };
-
-            reductions.lockRow( row );
-            if( lbrowlock != -1 )
-               reductions.lockRow( lbrowlock );
-            if( ubrowlock != -1 )
-               reductions.lockRow( ubrowlock );
-
-            reductions.lockColBounds( col );
+            if( rowowner[colvec.getIndices()[j]].load(
+                    std::memory_order_relaxed ) != k )
+               return;
+         }
+         chosen[k] = 1;
+         for( int j = 0; j != colvec.getLength(); ++j )
+            rowblocked[colvec.getIndices()[j]] = 1;
+      } );
 
-            if( lbrowlock != -1 )
-               reductions.impliedBounds( true, lbrowlock );
-            if( ubrowlock != -1 )
-               reductions.impliedBounds( false, ubrowlock );
+      next.clear();
+      for( int k : active )
+      {
+         if( chosen[k] )
+            continue;
 
-            reductions.aggregateFreeCol( col, row );
-            const int* indices = colvec.getIndices();
-            const int len = colvec.getLength();
+         auto colvec = constMatrix.getColumnCoefficients( candidates[k].col );
+         const int* colindices = colvec.getIndices();
+         if( std::none_of( colindices, colindices + colvec.getLength(),
+                           [&]( int r ) { return rowblocked[r] != 0; } ) )
+            next.push_back( k );
+      }
+      active.swap( next );
+   }
 
-            for( int j = 0; j != len; ++j )
-               touchedRows.set( indices[j] );
+   PresolveStatus result = PresolveStatus::kUnchanged;
+   for( int k = 0; k != nequalities; ++k )
+   {
+      if( !chosen[k] )
+         continue;
 
-            break;
-         }
-      }
+      result = PresolveStatus::kReduced;
+      add_substitution( reductions, candidates[k].row, candidates[k].col,
+                        candidates[k].lbrowlock, candidates[k].ubrowlock );
    }
 
    return result;
@@ -364,6 +650,13 @@ Substitution<REAL>::is_divisible( const Num<REAL>& num, const int length,
    return true;
 }
 
+template <typename REAL>
+void
+Substitution<REAL>::set_parallel_selection( bool val )
+{
+   parallelselection = val;
+}
+
 } // namespace papilo
 
 #endif
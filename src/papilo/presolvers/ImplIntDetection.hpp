@@ -28,6 +28,7 @@
 #include "papilo/core/ProblemUpdate.hpp"
 #include "papilo/misc/Num.hpp"
 #include "papilo/misc/fmt.hpp"
+#include <numeric>
 
 namespace papilo
 {
@@ -82,7 +83,16 @@ ImplIntDetection<REAL>::execute( const Problem<REAL>& problem,
    const auto& lhs_values = consmatrix.getLeftHandSides();
    const auto& rhs_values = consmatrix.getRightHandSides();
    const auto& rflags = consmatrix.getRowFlags();
-   const auto& ncols = consmatrix.getNCols();
+
+   // only columns that changed or whose rows changed since the last call can
+   // become implied integer
+   Vec<int> cols;
+   if( !this->getAffectedCols( problemUpdate, cols ) )
+   {
+      cols.resize( consmatrix.getNCols() );
+      std::iota( cols.begin(), cols.end(), 0 );
+   }
+   const int ncols = static_cast<int>( cols.size() );
 
    PresolveStatus result = PresolveStatus::kUnchanged;
 
@@ -93,7 +103,7 @@ ImplIntDetection<REAL>::execute( const Problem<REAL>& problem,
    if( problemUpdate.getPresolveOptions().runs_sequential() ||
       !problemUpdate.getPresolveOptions().implied_integer_parallel )
    {
-      for( int col = 0; col < ncols; ++col )
+      for( int col : cols )
       {
          if( perform_implied_integer_task(
                  problemUpdate, num, reductions, cflags, consmatrix, lhs_values,
@@ -108,14 +118,14 @@ ImplIntDetection<REAL>::execute( const Problem<REAL>& problem,
       Vec<Reductions<REAL>> stored_reductions( ncols );
       tbb::parallel_for( tbb::blocked_range<int>( 0, ncols ),
                          [&]( const tbb::blocked_range<int>& r ) {
-                            for( int col = r.begin(); col < r.end(); ++col )
+                            for( int i = r.begin(); i < r.end(); ++i )
                             {
                                if( perform_implied_integer_task(
                                        problemUpdate, num,
-                                       stored_reductions[col], cflags,
+                                       stored_reductions[i], cflags,
                                        consmatrix, lhs_values, rhs_values,
                                        lower_bounds, upper_bounds, rflags,
-                                       col ) == PresolveStatus::kReduced )
+                                       cols[i] ) == PresolveStatus::kReduced )
                                   result = PresolveStatus::kReduced;
                             }
                          } );
@@ -106,6 +106,12 @@ class ParallelColDetection : public PresolveMethod<REAL>
    computeSupportId( const ConstraintMatrix<REAL>& constMatrix,
                      unsigned int* supportHashes );
 
+   void
+   computeApproxColHashes( const ConstraintMatrix<REAL>& constMatrix,
+                           const Vec<REAL>& obj, const Num<REAL>& num,
+                           const unsigned int* supportHashes,
+                           unsigned int* columnHashes );
+
    void
    addPresolverParams( ParameterSet& paramSet ) override
    {
@@ -113,6 +119,12 @@ class ParallelColDetection : public PresolveMethod<REAL>
           "should Parallel Cols search for symmetries at the end (for example "
           "for binary problems where merging columns does not work)",
           symmetries );
+      paramSet.addParameter(
+          "parallelcols.approxhashing",
+          "should columns whose scaled coefficients are only equal up to the "
+          "tolerance be put into the same bucket by also hashing the "
+          "neighbouring quanta of coefficients close to a quantum boundary",
+          approxhashing );
    }
 
  public:
@@ -145,6 +157,12 @@ class ParallelColDetection : public PresolveMethod<REAL>
                        const Num<REAL>& num, Reductions<REAL>& reductions,
                        const Timer& timer ) override;
 
+   void
+   set_approx_hashing( bool value )
+   {
+      approxhashing = value;
+   }
+
  private:
    int
    determineBucketSize( int nColumns,
@@ -166,7 +184,12 @@ class ParallelColDetection : public PresolveMethod<REAL>
    determineOderingForZeroObj( REAL val1, REAL val2, int colpermCol1,
             int colpermCol2 ) const;
 
+   /// maximal number of coefficients of a column for which the neighbouring
+   /// quantum is hashed in the approximate hashing mode
+   static constexpr int kMaxAmbiguousCoefs = 3;
+
    bool symmetries = false;
+   bool approxhashing = false;
 };
 
 #ifdef PAPILO_USE_EXTERN_TEMPLATES
@@ -528,6 +551,159 @@ ParallelColDetection<REAL>::computeSupportId(
    }
 }
 
+template <typename REAL>
+void
+ParallelColDetection<REAL>::computeApproxColHashes(
+    const ConstraintMatrix<REAL>& constMatrix, const Vec<REAL>& obj,
+    const Num<REAL>& num, const unsigned int* supportHashes,
+    unsigned int* columnHashes )
+{
+   const int ncols = constMatrix.getNCols();
+   const int nkeys = 1 << kMaxAmbiguousCoefs;
+
+   // hash the quantized scaled coefficients of every column like
+   // computeColHashes. If a coefficient is within the tolerance of the
+   // boundary of its quantum the hash with the neighbouring quantum is
+   // computed too, for at most kMaxAmbiguousCoefs coefficients of a column.
+   Vec<unsigned int> keys( static_cast<std::size_t>( ncols ) * nkeys );
+   Vec<int> nalternatives( ncols );
+
+#ifdef PAPILO_TBB
+   tbb::parallel_for(
+       tbb::blocked_range<int>( 0, ncols ),
+       [&]( const tbb::blocked_range<int>& r ) {
+          Vec<unsigned int> codes;
+          for( int i = r.begin(); i < r.end(); ++i )
+#else
+   Vec<unsigned int> codes;
+   for( int i = 0; i < ncols; i++ )
+#endif
+          {
+             auto columnCoefficients = constMatrix.getColumnCoefficients( i );
+             const REAL* values = columnCoefficients.getValues();
+             const int len = columnCoefficients.getLength();
+             unsigned int* colkeys =
+                 keys.data() + static_cast<std::size_t>( i ) * nkeys;
+
+             codes.clear();
+             std::pair<int, unsigned int> ambiguous[kMaxAmbiguousCoefs];
+             int nambiguous = 0;
+
+             if( len > 1 )
+             {
+                REAL scale = REAL( 2.0 / ( 1.0 + sqrt( 5.0 ) ) ) / values[0];
+                // two parallel columns that pass the check in
+                // check_parallelity differ by at most this value after
+                // scaling
+                REAL tolerance = 2 * num.getEpsilon() * abs( scale );
+
+                auto addCode = [&]( const REAL& scaledval ) {
+                   unsigned int code = Num<REAL>::hashCode( scaledval );
+                   if( nambiguous < kMaxAmbiguousCoefs )
+                   {
+                      unsigned int lower =
+                          Num<REAL>::hashCode( scaledval - tolerance );
+                      unsigned int upper =
+                          Num<REAL>::hashCode( scaledval + tolerance );
+                      if( lower != code )
+                         ambiguous[nambiguous++] =
+                             std::make_pair( (int) codes.size(), lower );
+                      else if( upper != code )
+                         ambiguous[nambiguous++] =
+                             std::make_pair( (int) codes.size(), upper );
+                   }
+                   codes.push_back( code );
+                };
+
+                for( int j = 1; j != len; ++j )
+                   addCode( values[j] * scale );
+                if( obj[i] != 0 )
+                   addCode( obj[i] * scale );
+             }
+
+             // the first key uses the quanta of all coefficients, the others
+             // replace a subset of the ambiguous ones by their neighbours
+             for( int k = 0; k != ( 1 << nambiguous ); ++k )
+             {
+                for( int a = 0; a != nambiguous; ++a )
+                {
+                   if( ( k >> a ) & 1 )
+                      std::swap( codes[ambiguous[a].first],
+                                 ambiguous[a].second );
+                }
+
+                Hasher<unsigned int> hasher( len );
+                for( unsigned int code : codes )
+                   hasher.addValue( code );
+                colkeys[k] = hasher.getHash();
+
+                for( int a = 0; a != nambiguous; ++a )
+                {
+                   if( ( k >> a ) & 1 )
+                      std::swap( codes[ambiguous[a].first],
+                                 ambiguous[a].second );
+                }
+             }
+             nalternatives[i] = ( 1 << nambiguous ) - 1;
+          }
+#ifdef PAPILO_TBB
+       } );
+#endif
+
+   // join the columns whose keys match with the same support. The columns of
+   // a group get the hash of the column with the smallest index in it.
+   Vec<int> group( ncols );
+   for( int i = 0; i < ncols; ++i )
+      group[i] = i;
+
+   auto findGroup = [&]( int col ) {
+      while( group[col] != col )
+      {
+         group[col] = group[group[col]];
+         col = group[col];
+      }
+      return col;
+   };
+
+   auto joinGroups = [&]( int col1, int col2 ) {
+      col1 = findGroup( col1 );
+      col2 = findGroup( col2 );
+      if( col1 < col2 )
+         group[col2] = col1;
+      else if( col2 < col1 )
+         group[col1] = col2;
+   };
+
+   auto supportKey = [&]( int col, unsigned int hash ) {
+      return ( static_cast<uint64_t>( supportHashes[col] ) << 32 ) | hash;
+   };
+
+   HashMap<uint64_t, int> keycols( static_cast<std::size_t>( ncols * 1.1 ) );
+
+   for( int i = 0; i < ncols; ++i )
+   {
+      auto insResult = keycols.emplace(
+          supportKey( i, keys[static_cast<std::size_t>( i ) * nkeys] ), i );
+      if( !insResult.second )
+         joinGroups( i, insResult.first->second );
+   }
+
+   for( int i = 0; i < ncols; ++i )
+   {
+      for( int k = 1; k <= nalternatives[i]; ++k )
+      {
+         auto it = keycols.find(
+             supportKey( i, keys[static_cast<std::size_t>( i ) * nkeys + k] ) );
+         if( it != keycols.end() )
+            joinGroups( i, it->second );
+      }
+   }
+
+   for( int i = 0; i < ncols; ++i )
+      columnHashes[i] =
+          keys[static_cast<std::size_t>( findGroup( i ) ) * nkeys];
+}
+
 template <typename REAL>
 PresolveStatus
 ParallelColDetection<REAL>::execute( const Problem<REAL>& problem,
@@ -560,7 +736,8 @@ ParallelColDetection<REAL>::execute( const Problem<REAL>& problem,
              col[i] = i;
        },
        [&constMatrix, &coefhash, &obj, this]() {
-          computeColHashes( constMatrix, obj, coefhash.get() );
+          if( !approxhashing )
+             computeColHashes( constMatrix, obj, coefhash.get() );
        },
        [&constMatrix, &supportid, this]() {
           computeSupportId( constMatrix, supportid.get() );
@@ -568,10 +745,15 @@ ParallelColDetection<REAL>::execute( const Problem<REAL>& problem,
 #else
    for( int i = 0; i < ncols; ++i )
       col[i] = i;
-   computeColHashes( constMatrix, obj, coefhash.get() );
+   if( !approxhashing )
+      computeColHashes( constMatrix, obj, coefhash.get() );
    computeSupportId( constMatrix, supportid.get() );
 #endif
 
+   if( approxhashing )
+      computeApproxColHashes( constMatrix, obj, num, supportid.get(),
+                              coefhash.get() );
+
    pdqsort(
        col.get(), col.get() + ncols,
        [&]( int a, int b )
@@ -43,21 +43,6 @@ class ParallelRowDetection : public PresolveMethod<REAL>
    {
       SupportHashCompare() = default;
 
-      static size_t
-      hash( const std::pair<int, const int*>& row )
-      {
-         Hasher<size_t> hasher( row.first );
-
-         const int* support = row.second;
-
-         for( int i = 0; i != row.first; ++i )
-         {
-            hasher.addValue( support[i] );
-         }
-
-         return hasher.getHash();
-      }
-
       static bool
       equal( const std::pair<int, const int*>& row1,
              const std::pair<int, const int*>& row2 )
@@ -73,25 +58,6 @@ class ParallelRowDetection : public PresolveMethod<REAL>
       }
    };
 
-   struct SupportHash
-   {
-      std::size_t
-      operator()( const std::pair<int, const int*>& row ) const
-      {
-         return SupportHashCompare::hash( row );
-      }
-   };
-
-   struct SupportEqual
-   {
-      bool
-      operator()( const std::pair<int, const int*>& row1,
-                  const std::pair<int, const int*>& row2 ) const
-      {
-         return SupportHashCompare::equal( row1, row2 );
-      }
-   };
-
    void
    findParallelRows( const Num<REAL>& num, const int* bucket, int bucketsize,
                      const ConstraintMatrix<REAL>& constMatrix,
@@ -251,26 +217,91 @@ void
 ParallelRowDetection<REAL>::computeSupportId(
     const ConstraintMatrix<REAL>& constMatrix, unsigned int* supporthashes )
 {
-   using SupportMap =
-       HashMap<std::pair<int, const int*>, int, SupportHash, SupportEqual>;
+   const int nRows = constMatrix.getNRows();
 
-   SupportMap supportMap(
-       static_cast<std::size_t>( constMatrix.getNRows() * 1.1 ) );
+   // sort the rows by a 64 bit hash of their support, so that rows with the
+   // same support are adjacent. Every row gets the smallest index of a row
+   // with the same support as id, like inserting the rows in order into a
+   // hash map would do.
+   Vec<std::pair<uint64_t, int>> supports( nRows );
 
-   for( int i = 0; i < constMatrix.getNRows(); ++i )
-   {
-      auto row = constMatrix.getRowCoefficients( i );
-      int length = row.getLength();
-      const int* support = row.getIndices();
+#ifdef PAPILO_TBB
+   tbb::parallel_for(
+       tbb::blocked_range<int>( 0, nRows ),
+       [&]( const tbb::blocked_range<int>& r ) {
+          for( int i = r.begin(); i != r.end(); ++i )
+#else
+   for( int i = 0; i != nRows; ++i )
+#endif
+          {
+             auto row = constMatrix.getRowCoefficients( i );
+             const int length = row.getLength();
+             const int* support = row.getIndices();
+
+             Hasher<uint64_t> hasher( length );
+             for( int j = 0; j != length; ++j )
+                hasher.addValue( support[j] );
+
+             supports[i] = std::make_pair( hasher.getHash(), i );
+          }
+#ifdef PAPILO_TBB
+       } );
+
+   tbb::parallel_sort( supports.begin(), supports.end() );
+#else
+   pdqsort( supports.begin(), supports.end() );
+#endif
 
-      auto insResult =
-          supportMap.emplace( std::make_pair( length, support ), i );
+   // assign the ids within each run of equal hashes, the rows of a run are
+   // sorted by their index and only differ in the support on hash collisions
+   auto assignSupportIds = [&]( int first, Vec<int>& representatives ) {
+      representatives.clear();
+
+      for( int k = first;
+           k != nRows && supports[k].first == supports[first].first; ++k )
+      {
+         const int i = supports[k].second;
+         auto row = constMatrix.getRowCoefficients( i );
+         const auto rowsupport =
+             std::make_pair( row.getLength(), row.getIndices() );
 
-      if( insResult.second )
          supporthashes[i] = i;
-      else // support already exists, use the previous support id
-         supporthashes[i] = insResult.first->second;
+         for( int representative : representatives )
+         {
+            auto reprow = constMatrix.getRowCoefficients( representative );
+            if( SupportHashCompare::equal(
+                    rowsupport, std::make_pair( reprow.getLength(),
+                                                reprow.getIndices() ) ) )
+            {
+               supporthashes[i] = representative;
+               break;
+            }
+         }
+
+         if( supporthashes[i] == (unsigned int) i )
+            representatives.push_back( i );
+      }
+   };
+
+#ifdef PAPILO_TBB
+   tbb::parallel_for( tbb::blocked_range<int>( 0, nRows ),
+                      [&]( const tbb::blocked_range<int>& r ) {
+                         Vec<int> representatives;
+                         for( int k = r.begin(); k != r.end(); ++k )
+                         {
+                            if( k == 0 ||
+                                supports[k].first != supports[k - 1].first )
+                               assignSupportIds( k, representatives );
+                         }
+                      } );
+#else
+   Vec<int> representatives;
+   for( int k = 0; k != nRows; ++k )
+   {
+      if( k == 0 || supports[k].first != supports[k - 1].first )
+         assignSupportIds( k, representatives );
    }
+#endif
 }
 
 template <typename REAL>
@@ -513,33 +544,59 @@ ParallelRowDetection<REAL>::execute( const Problem<REAL>& problem,
    computeSupportId( constMatrix, supportid.get() );
 #endif
 
-   pdqsort( row.get(), row.get() + nRows, [&]( int a, int b ) {
+   auto rowLess = [&]( int a, int b ) {
       return supportid[a] < supportid[b] ||
              ( supportid[a] == supportid[b] && coefhash[a] < coefhash[b] ) ||
              ( supportid[a] == supportid[b] && coefhash[a] == coefhash[b] &&
                rowperm[a] < rowperm[b] );
-   } );
+   };
+#ifdef PAPILO_TBB
+   tbb::parallel_sort( row.get(), row.get() + nRows, rowLess );
+#else
+   pdqsort( row.get(), row.get() + nRows, rowLess );
+#endif
 
-   Vec<Vec<int>> stored_parallel_rows;
+   // collect the buckets with more than one row and search them for parallel
+   // rows independently
+   Vec<std::pair<int, int>> buckets;
 
    for( int i = 0; i < nRows; )
    {
       int bucketSize =
           determineBucketSize( nRows, supportid, coefhash, row, i );
 
-      // if more  than one row is in the bucket try to find parallel rows
       if( bucketSize > 1 )
-      {
-         Vec<int> parallel_rows;
-         parallel_rows.reserve( bucketSize );
-         findParallelRows( num, row.get() + i, bucketSize, constMatrix,
-                           parallel_rows );
-         if( !parallel_rows.empty() )
-            stored_parallel_rows.emplace_back( parallel_rows );
-      }
+         buckets.emplace_back( i, bucketSize );
       i = bucketSize + i;
    }
 
+   Vec<Vec<int>> stored_parallel_rows( buckets.size() );
+
+#ifdef PAPILO_TBB
+   tbb::parallel_for(
+       tbb::blocked_range<int>( 0, (int) buckets.size() ),
+       [&]( const tbb::blocked_range<int>& r ) {
+          for( int b = r.begin(); b != r.end(); ++b )
+#else
+   for( int b = 0; b != (int) buckets.size(); ++b )
+#endif
+          {
+             stored_parallel_rows[b].reserve( buckets[b].second );
+             findParallelRows( num, row.get() + buckets[b].first,
+                               buckets[b].second, constMatrix,
+                               stored_parallel_rows[b] );
+          }
+#ifdef PAPILO_TBB
+       } );
+#endif
+
+   stored_parallel_rows.erase(
+       std::remove_if( stored_parallel_rows.begin(), stored_parallel_rows.end(),
+                       []( const Vec<int>& parallel_rows ) {
+                          return parallel_rows.empty();
+                       } ),
+       stored_parallel_rows.end() );
+
    if( !stored_parallel_rows.empty() )
    {
       result = PresolveStatus::kReduced;
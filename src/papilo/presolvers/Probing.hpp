@@ -23,6 +23,7 @@
 #ifndef _PAPILO_PRESOLVERS_PROBING_HPP_
 #define _PAPILO_PRESOLVERS_PROBING_HPP_
 
+#include "papilo/core/BatchProbingView.hpp"
 #include "papilo/core/PresolveMethod.hpp"
 #include "papilo/core/ProbingView.hpp"
 #include "papilo/core/Problem.hpp"
@@ -52,6 +53,28 @@ class Probing : public PresolveMethod<REAL>
    int minbadgesize = 10;
    int max_badge_size = DEFAULT_MAX_BADGE_SIZE;
    double mincontdomred = 0.3;
+   bool useimplications = true;
+   bool batchprobing = false;
+
+   /// vectors of execute() kept between the calls, so that the rounds
+   /// allocate nothing until the problem is compressed
+   struct Workspace
+   {
+      Vec<int> probing_cands;
+      Array<std::atomic_int> probing_scores{ 0 };
+#ifdef PAPILO_TBB
+      tbb::combinable<Vec<std::pair<REAL, int>>> binary_variables_in_row;
+#else
+      Vec<std::pair<REAL, int>> binary_variables_in_row;
+#endif
+      HashMap<std::pair<int, int>, int, boost::hash<std::pair<int, int>>>
+          substitutionsPos;
+      Vec<ProbingSubstitution<REAL>> substitutions;
+      Vec<int> boundPos;
+      Vec<ProbingBoundChg<REAL>> boundChanges;
+   };
+
+   Workspace workspace;
 
  public:
    Probing() : PresolveMethod<REAL>()
@@ -71,6 +94,12 @@ class Probing : public PresolveMethod<REAL>
                       "compress was called, compressed nprobed vector from "
                       "size {} to size {}\n",
                       colmap.size(), nprobed.size() );
+
+      const std::size_t ncols = nprobed.size();
+      shrink_scratch_vector( workspace.probing_cands, ncols );
+      workspace.probing_scores = Array<std::atomic_int>( ncols );
+      shrink_scratch_vector( workspace.boundPos, 2 * ncols );
+      shrink_scratch_vector( workspace.boundChanges, ncols );
    }
 
    bool
@@ -109,6 +138,19 @@ class Probing : public PresolveMethod<REAL>
           "minimum fraction of domain that needs to be reduced for continuous "
           "variables to accept a bound change in probing",
           mincontdomred, 0.0, 1.0 );
+
+      paramSet.addParameter(
+          "probing.useimplications",
+          "start the propagation of a probed value with the binary columns it "
+          "implies according to the implications found in previous rounds and "
+          "store the newly found ones",
+          useimplications );
+
+      paramSet.addParameter(
+          "probing.batchprobing",
+          "probe batches of 32 binary columns with both values in a single "
+          "propagation that only tightens the bounds of binary columns",
+          batchprobing );
    }
 
    PresolveStatus
@@ -125,6 +167,9 @@ class Probing : public PresolveMethod<REAL>
    void
    set_max_badge_size( int val);
 
+   void
+   set_batch_probing( bool val );
+
 };
 
 #ifdef PAPILO_USE_EXTERN_TEMPLATES
@@ -140,6 +185,8 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
                         const Num<REAL>& num, Reductions<REAL>& reductions,
                         const Timer& timer, int& reason_of_infeasibility)
 {
+   this->found_implications.clear();
+
    if( problem.getNumIntegralCols() == 0 )
       return PresolveStatus::kUnchanged;
 
@@ -156,8 +203,18 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
    const int ncols = problem.getNCols();
    const Vec<int>& colsize = consMatrix.getColSizes();
    const auto& colperm = problemUpdate.getRandomColPerm();
-
-   Vec<int> probing_cands;
+   const ImplicationStore& implications = problemUpdate.getImplications();
+   // implications of earlier rounds cannot be derived in the proof log
+   const bool use_implications =
+       useimplications &&
+       !problemUpdate.getPresolveOptions().verification_with_VeriPB;
+   // the proof log needs the propagation of a single probing column
+   const bool batch_probing =
+       batchprobing &&
+       !problemUpdate.getPresolveOptions().verification_with_VeriPB;
+
+   Vec<int>& probing_cands = workspace.probing_cands;
+   probing_cands.clear();
    probing_cands.reserve( ncols );
 
    for( int i = 0; i != ncols; ++i )
@@ -170,7 +227,9 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
    if( probing_cands.empty() )
       return PresolveStatus::kUnchanged;
 
-   Array<std::atomic_int> probing_scores( ncols );
+   if( workspace.probing_scores.getSize() < std::size_t( ncols ) )
+      workspace.probing_scores = Array<std::atomic_int>( ncols );
+   Array<std::atomic_int>& probing_scores = workspace.probing_scores;
 
    for( int i = 0; i != ncols; ++i )
       probing_scores[i].store( 0, std::memory_order_relaxed );
@@ -189,10 +248,12 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
        tbb::blocked_range<int>( 0, problem.getNRows() ),
        [&]( const tbb::blocked_range<int>& r )
        {
-          Vec<std::pair<REAL, int>> binary_variables_in_row;
+          Vec<std::pair<REAL, int>>& binary_variables_in_row =
+              workspace.binary_variables_in_row.local();
           for( int row = r.begin(); row != r.end(); ++row )
 #else
-   Vec<std::pair<REAL, int>> binary_variables_in_row;
+   Vec<std::pair<REAL, int>>& binary_variables_in_row =
+       workspace.binary_variables_in_row;
    for( int row = 0; row != problem.getNRows(); ++row )
 #endif
           {
@@ -344,27 +405,33 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
    int n_useless = 0;
    bool abort = false;
 
-   HashMap<std::pair<int, int>, int, boost::hash<std::pair<int, int>>>
-       substitutionsPos;
-   Vec<ProbingSubstitution<REAL>> substitutions;
-   Vec<int> boundPos( size_t( 2 * ncols ), 0 );
-   Vec<ProbingBoundChg<REAL>> boundChanges;
+   auto& substitutionsPos = workspace.substitutionsPos;
+   Vec<ProbingSubstitution<REAL>>& substitutions = workspace.substitutions;
+   Vec<int>& boundPos = workspace.boundPos;
+   Vec<ProbingBoundChg<REAL>>& boundChanges = workspace.boundChanges;
+   substitutionsPos.clear();
+   substitutions.clear();
+   boundPos.assign( size_t( 2 * ncols ), 0 );
+   boundChanges.clear();
    boundChanges.reserve( ncols );
 
    std::atomic_bool infeasible{ false };
    std::atomic_int infeasible_variable {-1};
 
-   // use tbb combinable so that each thread will copy the activities and
-   // bounds at most once
+   // use tbb combinable so that each thread has its own probing view, the
+   // views only store the domains and activities changed by probing
 #ifdef PAPILO_TBB
    tbb::combinable<ProbingView<REAL>> probing_views( [this, &problem, &num]() {
       ProbingView<REAL> probingView( problem, num );
       probingView.setMinContDomRed( mincontdomred );
       return probingView;
    } );
+   tbb::combinable<BatchProbingView<REAL>> batch_views(
+       [&problem, &num]() { return BatchProbingView<REAL>( problem, num ); } );
 #else
    ProbingView<REAL> probingView( problem, num );
    probingView.setMinContDomRed( mincontdomred );
+   BatchProbingView<REAL> batchView( problem, num );
 #endif
 
    do
@@ -400,7 +467,11 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
 
                    assert( !probingView.isInfeasible() );
                    probingView.setProbingColumn( col, true );
+                   if( use_implications )
+                      probingView.applyStoredImplications( implications );
                    probingView.propagateDomains();
+                   if( use_implications )
+                      probingView.storeBinaryImplications();
                    probingView.storeImplications();
                    probingView.reset();
 
@@ -409,7 +480,11 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
 
                    assert( !probingView.isInfeasible() );
                    probingView.setProbingColumn( col, false );
+                   if( use_implications )
+                      probingView.applyStoredImplications( implications );
                    probingView.propagateDomains();
+                   if( use_implications )
+                      probingView.storeBinaryImplications();
 
                    bool globalInfeasible = probingView.analyzeImplications();
                    probingView.reset();
@@ -428,7 +503,52 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
 #endif
       };
 
-      propagate_variables( current_badge_start, current_badge_end );
+      auto probe_batches = [&]( int start, int end ) {
+         constexpr int batchsize = BatchProbingView<REAL>::kMaxBatchCols;
+         const int nbatches = ( end - start + batchsize - 1 ) / batchsize;
+#ifdef PAPILO_TBB
+         tbb::parallel_for(
+             tbb::blocked_range<int>( 0, nbatches ),
+             [&]( const tbb::blocked_range<int>& r )
+             {
+                BatchProbingView<REAL>& batchView = batch_views.local();
+
+                for( int b = r.begin(); b != r.end(); ++b )
+#else
+         for( int b = 0; b < nbatches; ++b )
+#endif
+                {
+                   if( PresolveMethod<REAL>::is_time_exceeded(
+                           timer, problemUpdate.getPresolveOptions().tlim ) ||
+                       infeasible.load( std::memory_order_relaxed ) )
+                      break;
+
+                   const int first = start + b * batchsize;
+                   const int last = std::min( end, first + batchsize );
+
+                   bool globalInfeasible = batchView.probeBatch(
+                       probing_cands.data() + first, last - first,
+                       use_implications ? &implications : nullptr );
+
+                   for( int i = first; i != last; ++i )
+                      ++nprobed[probing_cands[i]];
+
+                   if( globalInfeasible )
+                   {
+                      infeasible.store( true, std::memory_order_relaxed );
+                      infeasible_variable.store( batchView.getInfeasibleCol() );
+                      break;
+                   }
+                }
+#ifdef PAPILO_TBB
+             } );
+#endif
+      };
+
+      if( batch_probing )
+         probe_batches( current_badge_start, current_badge_end );
+      else
+         propagate_variables( current_badge_start, current_badge_end );
 
       if( PresolveMethod<REAL>::is_time_exceeded(
               timer, problemUpdate.getPresolveOptions().tlim ) )
@@ -445,15 +565,18 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
       int nboundchgs = 0;
       int nsubstitutions = -substitutions.size();
 
-#ifdef PAPILO_TBB
-      probing_views.combine_each( [&]( ProbingView<REAL>& probingView ) {
-#endif
+      auto collect_results = [&]( auto& probingView ) {
          const auto& probingBoundChgs = probingView.getProbingBoundChanges();
          const auto& probingSubstitutions =
              probingView.getProbingSubstitutions();
 
          amountofwork += probingView.getAmountOfWork();
 
+         const auto& probingImplications = probingView.getProbingImplications();
+         this->found_implications.insert( this->found_implications.end(),
+                                          probingImplications.begin(),
+                                          probingImplications.end() );
+
          for( const ProbingSubstitution<REAL>& subst : probingSubstitutions )
          {
             auto insres = substitutionsPos.emplace(
@@ -522,8 +645,18 @@ Probing<REAL>::execute( const Problem<REAL>& problem,
          }
 
          probingView.clearResults();
+      };
+
 #ifdef PAPILO_TBB
-      } );
+      if( batch_probing )
+         batch_views.combine_each( collect_results );
+      else
+         probing_views.combine_each( collect_results );
+#else
+      if( batch_probing )
+         collect_results( batchView );
+      else
+         collect_results( probingView );
 #endif
       nsubstitutions += substitutions.size();
       current_badge_start = current_badge_end;
@@ -629,6 +762,13 @@ Probing<REAL>::set_max_badge_size( int val)
    max_badge_size = val;
 }
 
+template <typename REAL>
+void
+Probing<REAL>::set_batch_probing( bool val )
+{
+   batchprobing = val;
+}
+
 
 } // namespace papilo
 
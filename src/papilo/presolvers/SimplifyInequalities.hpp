@@ -28,6 +28,7 @@
 #include "papilo/core/ProblemUpdate.hpp"
 #include "papilo/external/pdqsort/pdqsort.h"
 #include <boost/integer/common_factor.hpp>
+#include <numeric>
 
 namespace papilo
 {
@@ -300,10 +301,18 @@ SimplifyInequalities<REAL>::execute( const Problem<REAL>& problem,
    const Vec<ColFlags>& cflags = problem.getColFlags();
    const Vec<REAL>& lhs = consMatrix.getLeftHandSides();
    const Vec<REAL>& rhs = consMatrix.getRightHandSides();
-   const int nrows = consMatrix.getNRows();
    const Vec<REAL>& lbs = problem.getLowerBounds();
    const Vec<REAL>& ubs = problem.getUpperBounds();
 
+   // rows that did not change since the last call cannot be simplified
+   Vec<int> rows;
+   if( !this->getChangedRows( problemUpdate, rows ) )
+   {
+      rows.resize( consMatrix.getNRows() );
+      std::iota( rows.begin(), rows.end(), 0 );
+   }
+   const int nrows = static_cast<int>( rows.size() );
+
    PresolveStatus result = PresolveStatus::kUnchanged;
 
 #ifndef PAPILO_TBB
@@ -316,7 +325,7 @@ SimplifyInequalities<REAL>::execute( const Problem<REAL>& problem,
       // allocate only once
       Vec<int> colOrder;
       Vec<int> coefficientsThatCanBeDeleted;
-      for( int row = 0; row < nrows; row++ )
+      for( int row : rows )
       {
          if( perform_simplify_ineq_task(
                  num, consMatrix, activities, rflags, cflags, lhs, rhs, lbs,
@@ -337,11 +346,11 @@ SimplifyInequalities<REAL>::execute( const Problem<REAL>& problem,
              // allocate only once per thread
              Vec<int> colOrder;
              Vec<int> coefficientsThatCanBeDeleted;
-             for( int row = r.begin(); row < r.end(); ++row )
+             for( int i = r.begin(); i < r.end(); ++i )
              {
                 PresolveStatus status = perform_simplify_ineq_task(
                     num, consMatrix, activities, rflags, cflags, lhs, rhs, lbs,
-                    ubs, row, stored_reductions[row],
+                    ubs, rows[i], stored_reductions[i],
                     coefficientsThatCanBeDeleted, colOrder );
                 if( status == PresolveStatus::kReduced )
                    result = PresolveStatus::kReduced;
@@ -28,6 +28,8 @@
 #include "papilo/core/ProblemUpdate.hpp"
 #include "papilo/core/SingleRow.hpp"
 #include "papilo/misc/Hash.hpp"
+#include "papilo/misc/Signature.hpp"
+#include "papilo/misc/compress_vector.hpp"
 #ifdef PAPILO_TBB
 #include "papilo/misc/tbb.hpp"
 #endif
@@ -39,6 +41,7 @@ template <typename REAL>
 class Sparsify : public PresolveMethod<REAL>
 {
    double maxscale = 1000;
+   int64_t maxequalitywork = 1000000;
 
    using HitCount = uint16_t;
 
@@ -46,15 +49,46 @@ class Sparsify : public PresolveMethod<REAL>
    {
       Vec<HitCount> candrowhits;
       Vec<int> candrows;
+      Vec<REAL> scales;
       Vec<std::pair<int, REAL>> sparsify;
       Vec<std::tuple<int, int, int>> reductionBuffer;
 
-      explicit SparsifyData( int nrows ) : candrowhits( nrows )
+      /// candrowhits is zero between the equalities, it only needs to be set
+      /// up when the data is new or the problem was compressed
+      void
+      prepare( int nrows )
       {
-         candrows.reserve( nrows );
+         if( static_cast<int>( candrowhits.size() ) != nrows )
+         {
+            candrowhits.assign( nrows, 0 );
+            candrows.reserve( nrows );
+         }
+      }
+
+      void
+      shrink( std::size_t nrows )
+      {
+         shrink_scratch_vector( candrowhits, nrows );
+         shrink_scratch_vector( candrows, nrows );
       }
    };
 
+   /// vectors of execute() kept between the calls, so that the rounds
+   /// allocate nothing until the problem is compressed
+   struct Workspace
+   {
+      Vec<int> equalities;
+      Vec<Signature64> rowsignatures;
+#ifdef PAPILO_TBB
+      tbb::combinable<SparsifyData> sparsifyData;
+#else
+      SparsifyData sparsifyData;
+#endif
+      Vec<std::tuple<int, int, std::pair<int, REAL>*>> reductionData;
+   };
+
+   Workspace workspace;
+
  public:
    Sparsify() : PresolveMethod<REAL>()
    {
@@ -63,6 +97,29 @@ class Sparsify : public PresolveMethod<REAL>
       this->setDelayed( true );
    }
 
+   bool
+   initialize( const Problem<REAL>& problem,
+               const PresolveOptions& presolveOptions ) override
+   {
+      return true;
+   }
+
+   void
+   compress( const Vec<int>& rowmap, const Vec<int>& colmap ) override
+   {
+      std::size_t nrows =
+          rowmap.size() - std::count( rowmap.begin(), rowmap.end(), -1 );
+
+      shrink_scratch_vector( workspace.equalities, nrows );
+      shrink_scratch_vector( workspace.rowsignatures, nrows );
+#ifdef PAPILO_TBB
+      workspace.sparsifyData.combine_each(
+          [nrows]( SparsifyData& localData ) { localData.shrink( nrows ); } );
+#else
+      workspace.sparsifyData.shrink( nrows );
+#endif
+   }
+
    void
    addPresolverParams( ParameterSet& paramSet ) override
    {
@@ -70,6 +127,17 @@ class Sparsify : public PresolveMethod<REAL>
           "sparsify.maxscale",
           "maximum absolute scale to use for cancelling nonzeros",
           this->maxscale, 1.0 );
+      paramSet.addParameter(
+          "sparsify.maxequalitywork",
+          "maximal number of nonzeros visited to find and compare the rows "
+          "that one equality can sparsify",
+          maxequalitywork, int64_t{ 0 } );
+   }
+
+   void
+   set_max_equality_work( int64_t val )
+   {
+      maxequalitywork = val;
    }
 
    PresolveStatus
@@ -104,6 +172,7 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
 
    const auto& rflags = consmatrix.getRowFlags();
    const auto& rowsize = consmatrix.getRowSizes();
+   const auto& colsize = consmatrix.getColSizes();
    const auto& nrows = consmatrix.getNRows();
 
    auto isBinaryCol = [&]( int col ) {
@@ -117,8 +186,8 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
    // after each call skip more rounds to not call sparsify too often
    this->skipRounds( this->getNCalls() );
 
-   Vec<int> equalities;
-   equalities.reserve( nrows );
+   Vec<int>& equalities = workspace.equalities;
+   equalities.clear();
 
    for( int i = 0; i < nrows; ++i )
    {
@@ -134,26 +203,73 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
       equalities.emplace_back( i );
    }
 
+   // the support signatures of the rows rule out most rows that share a
+   // column with an equality but miss more than one of its columns
+   Vec<Signature64>& rowsignatures = workspace.rowsignatures;
+   rowsignatures.resize( nrows );
+
+   auto computeRowSignatures = [&]( int begin, int end ) {
+      for( int row = begin; row != end; ++row )
+      {
+         auto rowvec = consmatrix.getRowCoefficients( row );
+         const int* rowcols = rowvec.getIndices();
+         const int rowlen = rowvec.getLength();
+
+         Signature64 signature;
+         for( int k = 0; k != rowlen; ++k )
+            signature.add( rowcols[k] );
+
+         rowsignatures[row] = signature;
+      }
+   };
+
+   if( !equalities.empty() )
+   {
 #ifdef PAPILO_TBB
-   tbb::combinable<SparsifyData> sparsifyData(
-       [nrows]() { return SparsifyData( nrows ); } );
+      tbb::parallel_for( tbb::blocked_range<int>( 0, nrows ),
+                         [&]( const tbb::blocked_range<int>& r ) {
+                            computeRowSignatures( r.begin(), r.end() );
+                         } );
+#else
+      computeRowSignatures( 0, nrows );
+#endif
+   }
+
+   // columns that are counted in the loop over the general integer columns
+   auto isCountedInIntLoop = [&]( int col ) {
+      return problem.getNumIntegralCols() == 0 ||
+             ( cflags[col].test( ColFlag::kIntegral ) && !isBinaryCol( col ) );
+   };
+
+#ifdef PAPILO_TBB
+   tbb::combinable<SparsifyData>& sparsifyData = workspace.sparsifyData;
+   sparsifyData.combine_each( []( SparsifyData& localData ) {
+      localData.sparsify.clear();
+      localData.reductionBuffer.clear();
+   } );
 
    tbb::parallel_for(
        tbb::blocked_range<int>( 0, static_cast<int>( equalities.size() ) ),
        [&]( const tbb::blocked_range<int>& r ) {
           SparsifyData& localData = sparsifyData.local();
+          localData.prepare( nrows );
           std::size_t sparsifyStart;
 
           auto& candrowhits = localData.candrowhits;
           auto& candrows = localData.candrows;
+          auto& scales = localData.scales;
           auto& sparsify = localData.sparsify;
           auto& reductionBuffer = localData.reductionBuffer;
 
           for( int i = r.begin(); i < r.end(); ++i )
 #else
-   SparsifyData s = SparsifyData(nrows);
+   SparsifyData& s = workspace.sparsifyData;
+   s.sparsify.clear();
+   s.reductionBuffer.clear();
+   s.prepare( nrows );
    auto& candrowhits = s.candrowhits;
    auto& candrows = s.candrows;
+   auto& scales = s.scales;
    auto& sparsify = s.sparsify;
    std::size_t sparsifyStart;
    auto& reductionBuffer = s.reductionBuffer;
@@ -174,6 +290,20 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
                  "trying sparsification with equality row {} of length {}\n",
                  eqrow, eqlen );
 
+             // the rows that are sparsified in the end miss at most one
+             // column of the equality, so rows with fewer nonzeros or whose
+             // signature misses two bits of the equality's are not counted
+             const Signature64 eqsignature = rowsignatures[eqrow];
+             auto mayBeSparsified = [&]( int row ) {
+                return rowsize[row] >= eqlen - 1 &&
+                       eqsignature.isSubsetUpToOne( rowsignatures[row] );
+             };
+
+             // nonzeros visited for this equality, when the budget is
+             // exceeded the equality is skipped or its comparisons stop
+             int64_t work = 0;
+             bool withinbudget = true;
+
              if( problem.getNumIntegralCols() != 0 )
              {
                 int ncont = 0;
@@ -197,6 +327,13 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
                    const int* colrows = colvec.getIndices();
                    int collen = colvec.getLength();
 
+                   work += collen;
+                   if( work > maxequalitywork )
+                   {
+                      withinbudget = false;
+                      break;
+                   }
+
                    for( int j = 0; j != collen; ++j )
                    {
                       int row = colrows[j];
@@ -206,7 +343,7 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
 
                       if( candrowhits[row] == 0 )
                       {
-                         if( nbin + ncont > 2 )
+                         if( nbin + ncont > 2 || !mayBeSparsified( row ) )
                             continue;
 
                          candrows.push_back( row );
@@ -252,21 +389,31 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
                 }
              }
 
-             if( problem.getNumIntegralCols() == 0 || nint != 0 )
+             if( withinbudget &&
+                 ( problem.getNumIntegralCols() == 0 || nint != 0 ) )
              {
-                for( int counter = 0; counter != eqlen; ++counter )
+                // rows that are not candidates yet can only reach minhits
+                // from the first eqlen - minhits + 1 columns on
+                int counter = 0;
+                for( ; counter != eqlen && counter <= eqlen - minhits;
+                     ++counter )
                 {
                    int col = eqcols[counter];
 
-                   if( problem.getNumIntegralCols() != 0 &&
-                       ( !cflags[col].test( ColFlag::kIntegral ) ||
-                         isBinaryCol( col ) ) )
+                   if( !isCountedInIntLoop( col ) )
                       continue;
 
                    auto colvec = consmatrix.getColumnCoefficients( col );
                    const int* colrows = colvec.getIndices();
                    int collen = colvec.getLength();
 
+                   work += collen;
+                   if( work > maxequalitywork )
+                   {
+                      withinbudget = false;
+                      break;
+                   }
+
                    for( int j = 0; j != collen; ++j )
                    {
                       int row = colrows[j];
@@ -276,7 +423,7 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
 
                       if( candrowhits[row] == 0 )
                       {
-                         if( counter > eqlen - minhits )
+                         if( !mayBeSparsified( row ) )
                             continue;
 
                          candrows.push_back( row );
@@ -286,6 +433,79 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
                    }
                 }
 
+                // the remaining columns only count the hits of the
+                // candidates, merging the candidate rows with the rest of a
+                // long equality visits fewer nonzeros than scanning its
+                // columns if there are few candidates
+                int64_t scanwork = 0;
+                int64_t mergework = 0;
+
+                if( withinbudget )
+                {
+                   for( int k = counter; k != eqlen; ++k )
+                   {
+                      if( isCountedInIntLoop( eqcols[k] ) )
+                         scanwork += colsize[eqcols[k]];
+                   }
+
+                   for( int candrow : candrows )
+                      mergework += rowsize[candrow] + eqlen - counter;
+
+                   work += std::min( scanwork, mergework );
+                   withinbudget = work <= maxequalitywork;
+                }
+
+                if( withinbudget && mergework < scanwork )
+                {
+                   for( int candrow : candrows )
+                   {
+                      auto candrowvec = consmatrix.getRowCoefficients( candrow );
+                      const int* candcols = candrowvec.getIndices();
+                      int candlen = candrowvec.getLength();
+
+                      int h = counter;
+                      int j = 0;
+
+                      while( h != eqlen && j != candlen )
+                      {
+                         if( eqcols[h] == candcols[j] )
+                         {
+                            if( isCountedInIntLoop( eqcols[h] ) )
+                               ++candrowhits[candrow];
+
+                            ++h;
+                            ++j;
+                         }
+                         else if( eqcols[h] < candcols[j] )
+                            ++h;
+                         else
+                            ++j;
+                      }
+                   }
+                }
+                else if( withinbudget )
+                {
+                   for( ; counter != eqlen; ++counter )
+                   {
+                      int col = eqcols[counter];
+
+                      if( !isCountedInIntLoop( col ) )
+                         continue;
+
+                      auto colvec = consmatrix.getColumnCoefficients( col );
+                      const int* colrows = colvec.getIndices();
+                      int collen = colvec.getLength();
+
+                      for( int j = 0; j != collen; ++j )
+                      {
+                         int row = colrows[j];
+
+                         if( row != eqrow && candrowhits[row] != 0 )
+                            ++candrowhits[row];
+                      }
+                   }
+                }
+
                 auto it = std::remove_if( candrows.begin(), candrows.end(),
                                           [&]( int _r ) {
                                              if( candrowhits[_r] < minhits )
@@ -299,9 +519,9 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
                 candrows.erase( it, candrows.end() );
              }
 
-             if( !candrows.empty() )
+             if( withinbudget && !candrows.empty() )
              {
-                Vec<REAL> scales( eqlen );
+                scales.resize( eqlen );
                 const REAL* eqvals = rowvec.getValues();
 
                 sparsifyStart = sparsify.size();
@@ -314,6 +534,10 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
                    const REAL* candvals = candrowvec.getValues();
                    int candlen = candrowvec.getLength();
 
+                   work += candlen + eqlen;
+                   if( work > maxequalitywork )
+                      break;
+
                    if( !cancelint && candrowhits[candrow] != eqlen )
                    {
                       bool has_integral = false;
@@ -402,14 +626,14 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
                    }
                 }
 
-                for( int candrow : candrows )
-                   candrowhits[candrow] = 0;
-                candrows.clear();
-
                 if( sparsify.size() != sparsifyStart )
                    reductionBuffer.emplace_back( eqrow, int( sparsifyStart ),
                                                  int( sparsify.size() ) );
              }
+
+             for( int candrow : candrows )
+                candrowhits[candrow] = 0;
+             candrows.clear();
           }
 #ifdef PAPILO_TBB
        } );
@@ -427,8 +651,9 @@ Sparsify<REAL>::execute( const Problem<REAL>& problem,
    {
       result = PresolveStatus::kReduced;
 
-      Vec<std::tuple<int, int, std::pair<int, REAL>*>> reductionData;
-
+      Vec<std::tuple<int, int, std::pair<int, REAL>*>>& reductionData =
+          workspace.reductionData;
+      reductionData.clear();
       reductionData.reserve( nreductions );
 
 #ifdef PAPILO_TBB
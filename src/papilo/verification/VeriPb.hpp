@@ -29,6 +29,7 @@
 #define VERIPB_VERSION 2
 
 #include "papilo/core/Problem.hpp"
+#include "papilo/io/AsyncFileWriter.hpp"
 #include "papilo/misc/Hash.hpp"
 #include "papilo/misc/Num.hpp"
 #include "papilo/misc/Vec.hpp"
@@ -66,7 +67,9 @@ class VeriPb : public CertificateInterface<REAL>
  public:
 
    Num<REAL> num;
-   std::ofstream proof_out;
+   /// collects the proof in blocks that are written on a background thread
+   AsyncFileWriter proof_writer;
+   std::ostream proof_out{ &proof_writer };
 
    int propagation_option;
    int status = 0; // 1 = solved, -1 = infeasible -2 = finished;
@@ -180,8 +183,17 @@ class VeriPb : public CertificateInterface<REAL>
       if( problem_name.substr( length - 4 ) == ".bz2" )
          ending = 8;
 #endif
-      proof_out =
-          std::ofstream( problem_name.substr( 0, length - ending ) + ".pbp" );
+      auto compression = static_cast<AsyncFileWriter::Compression>(
+          options.veripb_compression );
+      if( !AsyncFileWriter::isAvailable( compression ) )
+      {
+         fmt::print( "compression of the VeriPB proof is not available, the "
+                     "proof is written uncompressed\n" );
+         compression = AsyncFileWriter::Compression::kNone;
+      }
+      proof_writer.open( problem_name.substr( 0, length - ending ) + ".pbp" +
+                             AsyncFileWriter::getExtension( compression ),
+                         compression );
    }
 
    void
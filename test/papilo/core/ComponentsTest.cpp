@@ -0,0 +1,149 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "papilo/core/Components.hpp"
+#include "papilo/external/catch/catch.hpp"
+#include "papilo/core/Problem.hpp"
+#include "papilo/core/ProblemBuilder.hpp"
+
+using namespace papilo;
+
+Problem<double>
+setupProblemWithThreeComponents();
+
+TEST_CASE( "components-are-numbered-by-their-first-column", "[core]" )
+{
+   Problem<double> problem = setupProblemWithThreeComponents();
+   Components components;
+
+   REQUIRE( components.detectComponents( problem ) == 3 );
+
+   // the columns of a component keep their order
+   Vec<int> comp0cols( components.getComponentsCols( 0 ),
+                       components.getComponentsCols( 0 ) +
+                           components.getComponentsNumCols( 0 ) );
+   REQUIRE( comp0cols == Vec<int>{ 0, 3, 5 } );
+   REQUIRE( components.getComponentsNumCols( 1 ) == 2 );
+   REQUIRE( components.getComponentsCols( 1 )[0] == 1 );
+   REQUIRE( components.getComponentsCols( 1 )[1] == 4 );
+   REQUIRE( components.getComponentsNumCols( 2 ) == 1 );
+   REQUIRE( components.getComponentsCols( 2 )[0] == 2 );
+
+   REQUIRE( components.getComponentsNumRows( 0 ) == 2 );
+   REQUIRE( components.getComponentsRows( 0 )[0] == 0 );
+   REQUIRE( components.getComponentsRows( 0 )[1] == 2 );
+   REQUIRE( components.getComponentsNumRows( 1 ) == 1 );
+   REQUIRE( components.getComponentsRows( 1 )[0] == 1 );
+   REQUIRE( components.getComponentsNumRows( 2 ) == 1 );
+   REQUIRE( components.getComponentsRows( 2 )[0] == 3 );
+
+   // columns and rows are mapped to their position in the component
+   REQUIRE( components.getColComponentIdx( 5 ) == 2 );
+   REQUIRE( components.getColComponentIdx( 4 ) == 1 );
+   REQUIRE( components.getRowComponentIdx( 2 ) == 1 );
+
+   // the smallest component comes first
+   const Vec<ComponentInfo>& compInfo = components.getComponentInfo();
+   REQUIRE( compInfo[0].componentid == 2 );
+   REQUIRE( compInfo[0].nnonz == 1 );
+   REQUIRE( compInfo[1].componentid == 1 );
+   REQUIRE( compInfo[2].componentid == 0 );
+   REQUIRE( compInfo[2].nintegral == 1 );
+   REQUIRE( compInfo[2].ncontinuous == 2 );
+}
+
+TEST_CASE( "active-components-have-the-info-of-the-compressed-problem",
+           "[core]" )
+{
+   Problem<double> problem = setupProblemWithThreeComponents();
+   Components components;
+
+   REQUIRE( components.detectComponents( problem ) == 3 );
+   const Vec<ComponentInfo>& compInfo = components.getComponentInfo();
+   Vec<ComponentInfo> activeInfo =
+       Components::getActiveComponentInfo( problem );
+
+   REQUIRE( activeInfo.size() == compInfo.size() );
+   for( std::size_t i = 0; i != compInfo.size(); ++i )
+   {
+      REQUIRE( activeInfo[i].componentid == compInfo[i].componentid );
+      REQUIRE( activeInfo[i].nintegral == compInfo[i].nintegral );
+      REQUIRE( activeInfo[i].ncontinuous == compInfo[i].ncontinuous );
+      REQUIRE( activeInfo[i].nnonz == compInfo[i].nnonz );
+   }
+
+   // x2 is fixed and its row is redundant, the other components keep their
+   // ids since they are numbered by their first active column
+   problem.getColFlags()[2].set( ColFlag::kFixed );
+   problem.getRowFlags()[3].set( RowFlag::kRedundant );
+   activeInfo = Components::getActiveComponentInfo( problem );
+
+   REQUIRE( activeInfo.size() == 2 );
+   REQUIRE( activeInfo[0].componentid == 1 );
+   REQUIRE( activeInfo[1].componentid == 0 );
+   REQUIRE( activeInfo[1].nnonz == 4 );
+}
+
+Problem<double>
+setupProblemWithThreeComponents()
+{
+   // x0 + x3 <= 1
+   // x1 + x4 <= 1
+   // x3 + x5 <= 1
+   // x2      <= 1
+   Vec<double> coefficients{ 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+   Vec<double> upperBounds{ 2.0, 2.0, 2.0, 2.0, 2.0, 2.0 };
+   Vec<double> lowerBounds{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+   Vec<uint8_t> isIntegral{ 1, 0, 0, 0, 0, 0 };
+   Vec<uint8_t> lhsInfinity{ 1, 1, 1, 1 };
+   Vec<double> rhs{ 1.0, 1.0, 1.0, 1.0 };
+   Vec<std::string> rowNames{ "A1", "A2", "A3", "A4" };
+   Vec<std::string> columnNames{ "x0", "x1", "x2", "x3", "x4", "x5" };
+   Vec<std::tuple<int, int, double>> entries{
+       std::tuple<int, int, double>{ 0, 0, 1.0 },
+       std::tuple<int, int, double>{ 0, 3, 1.0 },
+       std::tuple<int, int, double>{ 1, 1, 1.0 },
+       std::tuple<int, int, double>{ 1, 4, 1.0 },
+       std::tuple<int, int, double>{ 2, 3, 1.0 },
+       std::tuple<int, int, double>{ 2, 5, 1.0 },
+       std::tuple<int, int, double>{ 3, 2, 1.0 } };
+
+   ProblemBuilder<double> pb;
+   pb.reserve( (int) entries.size(), (int) rowNames.size(),
+               (int) columnNames.size() );
+   pb.setNumRows( (int) rowNames.size() );
+   pb.setNumCols( (int) columnNames.size() );
+   pb.setColUbAll( upperBounds );
+   pb.setColLbAll( lowerBounds );
+   pb.setObjAll( coefficients );
+   pb.setObjOffset( 0.0 );
+   pb.setColIntegralAll( isIntegral );
+   pb.setRowLhsInfAll( lhsInfinity );
+   pb.setRowRhsAll( rhs );
+   pb.addEntryAll( entries );
+   pb.setColNameAll( columnNames );
+   pb.setRowNameAll( rowNames );
+   pb.setProblemName( "matrix with three components" );
+   Problem<double> problem = pb.build();
+   problem.recomputeLocks();
+   return problem;
+}
@@ -0,0 +1,129 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "papilo/core/ImplicationStore.hpp"
+#include "papilo/external/catch/catch.hpp"
+#include "papilo/core/Problem.hpp"
+#include "papilo/core/ProblemBuilder.hpp"
+
+using namespace papilo;
+
+Problem<double>
+setupProblemWithCliques();
+
+TEST_CASE( "implication-store-adds-contrapositives", "[core]" )
+{
+   const int x1 = ImplicationStore::literal( 0, true );
+   const int y1 = ImplicationStore::literal( 1, true );
+   const int z0 = ImplicationStore::literal( 2, false );
+
+   ImplicationStore store( 3 );
+   REQUIRE( store.addImplications( { { x1, y1 }, { x1, z0 } } ) == 4 );
+   REQUIRE( store.addImplications( { { x1, y1 } } ) == 0 );
+
+   REQUIRE( store.getNImplications() == 4 );
+   REQUIRE( store.implies( x1, y1 ) );
+   REQUIRE( store.implies( ImplicationStore::negated( y1 ),
+                           ImplicationStore::negated( x1 ) ) );
+   REQUIRE( store.implies( ImplicationStore::negated( z0 ),
+                           ImplicationStore::negated( x1 ) ) );
+   REQUIRE( !store.implies( y1, x1 ) );
+
+   // the store drops implications beyond its maximal size
+   ImplicationStore limited( 3, 2 );
+   REQUIRE( limited.addImplications( { { x1, y1 }, { x1, z0 } } ) == 2 );
+   REQUIRE( limited.getNImplications() == 2 );
+}
+
+TEST_CASE( "implication-store-detects-cliques-and-compresses", "[core]" )
+{
+   Num<double> num{};
+   Problem<double> problem = setupProblemWithCliques();
+
+   ImplicationStore store( problem.getNCols() );
+   REQUIRE( store.detectCliques( problem, num ) == 2 );
+
+   const int x1 = ImplicationStore::literal( 0, true );
+   REQUIRE( store.implies( x1, ImplicationStore::literal( 1, false ) ) );
+   REQUIRE( store.implies( x1, ImplicationStore::literal( 2, false ) ) );
+   REQUIRE( store.implies( x1, ImplicationStore::literal( 3, true ) ) );
+   REQUIRE( store.implies( ImplicationStore::literal( 3, false ),
+                           ImplicationStore::literal( 0, false ) ) );
+   REQUIRE( !store.implies( ImplicationStore::literal( 1, false ), x1 ) );
+
+   // deleting the second column shrinks the first clique to two literals
+   store.compress( { 0, -1, 1, 2 } );
+
+   REQUIRE( store.getNCols() == 3 );
+   REQUIRE( store.getNCliques() == 2 );
+   REQUIRE( store.implies( x1, ImplicationStore::literal( 1, false ) ) );
+   REQUIRE( store.implies( x1, ImplicationStore::literal( 2, true ) ) );
+
+   // deleting the first column leaves no clique with two literals
+   store.compress( { -1, 0, 1 } );
+
+   REQUIRE( store.getNCliques() == 0 );
+   REQUIRE( store.empty() );
+}
+
+Problem<double>
+setupProblemWithCliques()
+{
+   // x + y + z <= 1
+   // x - w <= 0
+   // 2x + y + z <= 3
+   Vec<double> coefficients{ 1.0, 1.0, 1.0, 1.0 };
+   Vec<double> upperBounds{ 1.0, 1.0, 1.0, 1.0 };
+   Vec<double> lowerBounds{ 0.0, 0.0, 0.0, 0.0 };
+   Vec<uint8_t> isIntegral{ 1, 1, 1, 1 };
+
+   Vec<double> rhs{ 1.0, 0.0, 3.0 };
+   Vec<std::string> rowNames{ "A1", "A2", "A3" };
+   Vec<std::string> columnNames{ "x", "y", "z", "w" };
+   Vec<std::tuple<int, int, double>> entries{
+       std::tuple<int, int, double>{ 0, 0, 1.0 },
+       std::tuple<int, int, double>{ 0, 1, 1.0 },
+       std::tuple<int, int, double>{ 0, 2, 1.0 },
+       std::tuple<int, int, double>{ 1, 0, 1.0 },
+       std::tuple<int, int, double>{ 1, 3, -1.0 },
+       std::tuple<int, int, double>{ 2, 0, 2.0 },
+       std::tuple<int, int, double>{ 2, 1, 1.0 },
+       std::tuple<int, int, double>{ 2, 2, 1.0 },
+   };
+
+   ProblemBuilder<double> pb;
+   pb.reserve( entries.size(), rowNames.size(), columnNames.size() );
+   pb.setNumRows( rowNames.size() );
+   pb.setNumCols( columnNames.size() );
+   pb.setColUbAll( upperBounds );
+   pb.setColLbAll( lowerBounds );
+   pb.setObjAll( coefficients );
+   pb.setObjOffset( 0.0 );
+   pb.setColIntegralAll( isIntegral );
+   pb.setRowRhsAll( rhs );
+   pb.setRowLhsInfAll( { 1, 1, 1 } );
+   pb.addEntryAll( entries );
+   pb.setColNameAll( columnNames );
+   pb.setProblemName( "matrix for testing cliques" );
+   Problem<double> problem = pb.build();
+   return problem;
+}
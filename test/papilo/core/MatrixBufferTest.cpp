@@ -23,6 +23,7 @@
 #include "papilo/core/MatrixBuffer.hpp"
 #include "papilo/external/catch/catch.hpp"
 #include "papilo/misc/fmt.hpp"
+#include <tuple>
 
 using namespace papilo;
 
@@ -165,3 +166,88 @@ TEST_CASE( "matrix-buffer", "[core]" )
 
    REQUIRE( stack.size() == 1 );
 }
+
+TEST_CASE( "matrix-buffer-sorted-batch", "[core]" )
+{
+   // same matrix as above, appended in the same order
+   Vec<std::tuple<int, int, double>> entries{
+       { 4, 8, 13.0 }, { 0, 0, 1.0 },  { 1, 2, 4.0 },  { 2, 1, 8.0 },
+       { 4, 7, 12.0 }, { 4, 0, 9.0 },  { 4, 2, 11.0 }, { 1, 5, 7.0 },
+       { 0, 1, 2.0 },  { 4, 1, 10.0 }, { 1, 4, 6.0 },  { 1, 1, 3.0 },
+       { 1, 3, 5.0 } };
+
+   Vec<double> colmajor{ 1.0,  9.0, 2.0, 3.0, 8.0,  10.0, 4.0,
+                         11.0, 5.0, 6.0, 7.0, 12.0, 13.0 };
+
+   MatrixBuffer<double> sortedBuffer;
+   MatrixBuffer<double> linkedBuffer;
+   sortedBuffer.sort_threshold = 1;
+   linkedBuffer.sort_threshold = (int) entries.size() + 1;
+
+   for( auto& e : entries )
+   {
+      sortedBuffer.appendEntry( std::get<0>( e ), std::get<1>( e ),
+                                std::get<2>( e ) );
+      linkedBuffer.appendEntry( std::get<0>( e ), std::get<1>( e ),
+                                std::get<2>( e ) );
+   }
+
+   sortedBuffer.sortOrLink();
+   linkedBuffer.sortOrLink();
+   REQUIRE( sortedBuffer.isSorted() );
+   REQUIRE( !linkedBuffer.isSorted() );
+   REQUIRE( checkBstProperty<true>( linkedBuffer ) );
+   REQUIRE( checkBstProperty<false>( linkedBuffer ) );
+
+   for( MatrixBuffer<double>* M : { &sortedBuffer, &linkedBuffer } )
+   {
+      SmallVec<int, 32> stack;
+
+      const MatrixEntry<double>* it = M->begin<true>( stack );
+      int i = 1;
+      while( it != M->end() )
+      {
+         REQUIRE( it->val == double( i ) );
+         it = M->next<true>( stack );
+         ++i;
+      }
+      REQUIRE( i == 14 );
+
+      it = M->begin<false>( stack );
+      i = 0;
+      while( it != M->end() )
+      {
+         REQUIRE( it->val == colmajor[i] );
+         it = M->next<false>( stack );
+         ++i;
+      }
+      REQUIRE( i == 13 );
+
+      // start of row 4 and of column 2
+      it = M->beginStart<true>( stack, 4, -1 );
+      REQUIRE( it->val == 9.0 );
+      it = M->beginStart<false>( stack, -1, 2 );
+      REQUIRE( it->val == 4.0 );
+      it = M->beginStart<true>( stack, 5, -1 );
+      REQUIRE( it == M->end() );
+   }
+
+   SparseStorage<double> sortedCsr = sortedBuffer.buildCSR( 5, 9 );
+   SparseStorage<double> linkedCsr = linkedBuffer.buildCSR( 5, 9 );
+   for( int row = 0; row != 5; ++row )
+   {
+      REQUIRE( sortedCsr.getRowRanges()[row].start ==
+               linkedCsr.getRowRanges()[row].start );
+      REQUIRE( sortedCsr.getRowRanges()[row].end ==
+               linkedCsr.getRowRanges()[row].end );
+   }
+
+   // looking up an entry links the sorted entries into the trees
+   MatrixEntry<double>* entry = sortedBuffer.findEntry<false>( 1, 3 );
+   REQUIRE( entry != nullptr );
+   REQUIRE( entry->val == 5.0 );
+   REQUIRE( !sortedBuffer.isSorted() );
+   REQUIRE( checkBstProperty<true>( sortedBuffer ) );
+   REQUIRE( checkBstProperty<false>( sortedBuffer ) );
+   REQUIRE( sortedBuffer.findEntry<true>( 3, 3 ) == nullptr );
+}
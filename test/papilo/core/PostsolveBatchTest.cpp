@@ -0,0 +1,74 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "papilo/core/Presolve.hpp"
+#include "papilo/core/postsolve/Postsolve.hpp"
+#include "papilo/external/catch/catch.hpp"
+#include "papilo/io/MpsParser.hpp"
+
+using namespace papilo;
+
+TEST_CASE( "postsolve-of-several-solutions-gives-same-result", "[core]" )
+{
+   boost::optional<Problem<double>> optional = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781.mps" );
+   REQUIRE( optional.is_initialized() == true );
+   Problem<double> problem = optional.get();
+
+   Presolve<double> presolve;
+   presolve.addDefaultPresolvers();
+   presolve.getPresolveOptions().threads = 1;
+   presolve.setVerbosityLevel( VerbosityLevel::kQuiet );
+   PresolveResult<double> result = presolve.apply( problem );
+
+   // validating after every step undoes the stack one by one
+   PostsolveStorage<double> sequential = result.postsolve;
+   sequential.presolveOptions.validation_after_every_postsolving_step = true;
+
+   // the solutions do not need to be feasible to compare the postsolve steps
+   Vec<Solution<double>> reduced;
+   for( int k = 0; k != 4; ++k )
+   {
+      Vec<double> values( problem.getNCols() );
+      for( int col = 0; col != problem.getNCols(); ++col )
+         values[col] = ( col + k ) % 3;
+      reduced.emplace_back( values );
+   }
+
+   Message msg{};
+   msg.setVerbosityLevel( VerbosityLevel::kQuiet );
+   Postsolve<double> postsolve{ msg, result.postsolve.getNum() };
+
+   Vec<Solution<double>> original;
+   postsolve.undo( reduced, original, result.postsolve );
+   REQUIRE( original.size() == reduced.size() );
+
+   for( int k = 0; k != (int) reduced.size(); ++k )
+   {
+      Solution<double> single;
+      Solution<double> stepwise;
+      postsolve.undo( reduced[k], single, result.postsolve );
+      postsolve.undo( reduced[k], stepwise, sequential );
+      REQUIRE( original[k].primal == single.primal );
+      REQUIRE( original[k].primal == stepwise.primal );
+   }
+}
@@ -67,7 +67,7 @@ lhs()
    return papilo::Vec<double>{ rhs()[0], rhs()[1] };
 }
 
-std::vector<int>
+papilo::Vec<int>
 row_sizes()
 {
    return papilo::Vec<int>{ 3, 2 };
@@ -76,6 +76,12 @@ row_sizes()
 papilo::Problem<double>
 setupProblemWithMultiplePresolvingOptions();
 
+papilo::Problem<double>
+setupProblemWithIndependentBlocks( int nblocks );
+
+papilo::Vec<double>
+solveBinaryProblem( const papilo::Problem<double>& problem );
+
 std::pair<std::pair<papilo::Problem<double>, papilo::PostsolveStorage<double>>,
           std::pair<int, int>>
 applyReductions( const papilo::Reductions<double>& reductions,
@@ -122,9 +128,9 @@ TEST_CASE( "happy-path-replace-variable", "[core]" )
 
    papilo::Problem<double> problem = pair.first.first;
 
-   std::vector<double> expected_objective{ 0.0, -2.0, 1.0, 1.0 };
-   std::vector<int> expected_colsizes{ ELIMINATED, 1, 2, 1 };
-   std::vector<int> expected_rowsizes{ 2, 2 };
+   papilo::Vec<double> expected_objective{ 0.0, -2.0, 1.0, 1.0 };
+   papilo::Vec<int> expected_colsizes{ ELIMINATED, 1, 2, 1 };
+   papilo::Vec<int> expected_rowsizes{ 2, 2 };
 
    REQUIRE( problem.getObjective().coefficients == expected_objective );
    REQUIRE( problem.getConstraintMatrix().getColSizes() == expected_colsizes );
@@ -165,8 +171,8 @@ TEST_CASE( "happy-path-substitute-matrix-coefficient-into-objective", "[core]" )
        pair = applyReductions( reductions, false );
    Problem<double> problem = pair.first.first;
 
-   std::vector<double> expected_objective{ 3.0, 1.0, 0.0, 0.0 };
-   std::vector<double> expected_upper_bounds{ 1.0, 1.0, 1.0, 0.0 };
+   papilo::Vec<double> expected_objective{ 3.0, 1.0, 0.0, 0.0 };
+   papilo::Vec<double> expected_upper_bounds{ 1.0, 1.0, 1.0, 0.0 };
 
    REQUIRE( problem.getObjective().coefficients == expected_objective );
    REQUIRE( problem.getNRows() == 2 );
@@ -202,8 +208,8 @@ TEST_CASE( "happy-path-aggregate-free-column", "[core]" )
    REQUIRE( result.second == 1 );
    Problem<double> problem = pair.first.first;
 
-   std::vector<double> expected_objective{ 3.0, 1.0, 0.0, 0.0 };
-   std::vector<int> expected_colsizes{ 1, 1, 1, ELIMINATED };
+   papilo::Vec<double> expected_objective{ 3.0, 1.0, 0.0, 0.0 };
+   papilo::Vec<int> expected_colsizes{ 1, 1, 1, ELIMINATED };
 
    REQUIRE( problem.getObjective().coefficients == expected_objective );
    REQUIRE( problem.getUpperBounds() == upperBounds() );
@@ -243,6 +249,92 @@ TEST_CASE( "presolve-activity-is-updated-correctly-huge-values", "[core]" )
 
 }
 
+TEST_CASE( "presolve-of-components-gives-same-solution", "[core]" )
+{
+   Problem<double> original = setupProblemWithIndependentBlocks( 4 );
+   Problem<double> problem = setupProblemWithIndependentBlocks( 4 );
+   Problem<double> problem_components = setupProblemWithIndependentBlocks( 4 );
+
+   Presolve<double> presolve{};
+   presolve.addDefaultPresolvers();
+   presolve.setVerbosityLevel( VerbosityLevel::kQuiet );
+   PresolveResult<double> result = presolve.apply( problem );
+
+   Presolve<double> presolve_components{};
+   presolve_components.addDefaultPresolvers();
+   presolve_components.getPresolveOptions().componentsminnnz = 0;
+   presolve_components.setVerbosityLevel( VerbosityLevel::kQuiet );
+   PresolveResult<double> result_components =
+       presolve_components.apply( problem_components );
+
+   REQUIRE( result_components.status == result.status );
+   REQUIRE( problem_components.getNCols() == problem.getNCols() );
+   REQUIRE( problem_components.getNRows() == problem.getNRows() );
+   REQUIRE( problem_components.getConstraintMatrix().getNnz() ==
+            problem.getConstraintMatrix().getNnz() );
+   REQUIRE( problem_components.getNCols() > 0 );
+
+   Message msg{};
+   msg.setVerbosityLevel( VerbosityLevel::kQuiet );
+   Postsolve<double> postsolve{ msg, result.postsolve.getNum() };
+
+   Solution<double> solution;
+   Solution<double> solution_components;
+   REQUIRE( postsolve.undo( Solution<double>( solveBinaryProblem( problem ) ),
+                            solution, result.postsolve ) ==
+            PostsolveStatus::kOk );
+   REQUIRE( postsolve.undo(
+                Solution<double>( solveBinaryProblem( problem_components ) ),
+                solution_components, result_components.postsolve ) ==
+            PostsolveStatus::kOk );
+
+   // both blocks have a unique optimal solution
+   REQUIRE( solution_components.primal == solution.primal );
+   REQUIRE( original.computeSolObjective( solution_components.primal ) ==
+            14.0 );
+}
+
+TEST_CASE( "presolve-with-async-exhaustive-rounds-gives-same-solution",
+           "[core]" )
+{
+   Problem<double> original = setupProblemWithIndependentBlocks( 4 );
+   Problem<double> problem = setupProblemWithIndependentBlocks( 4 );
+   Problem<double> problem_async = setupProblemWithIndependentBlocks( 4 );
+
+   Presolve<double> presolve{};
+   presolve.addDefaultPresolvers();
+   presolve.setVerbosityLevel( VerbosityLevel::kQuiet );
+   PresolveResult<double> result = presolve.apply( problem );
+
+   Presolve<double> presolve_async{};
+   presolve_async.addDefaultPresolvers();
+   presolve_async.getPresolveOptions().threads = 4;
+   presolve_async.getPresolveOptions().async_exhaustive_rounds = true;
+   presolve_async.setVerbosityLevel( VerbosityLevel::kQuiet );
+   PresolveResult<double> result_async = presolve_async.apply( problem_async );
+
+   // the reductions depend on the timing of the tasks, only the postsolved
+   // solution is unique
+   REQUIRE( result_async.status == result.status );
+
+   Message msg{};
+   msg.setVerbosityLevel( VerbosityLevel::kQuiet );
+   Postsolve<double> postsolve{ msg, result.postsolve.getNum() };
+
+   Solution<double> solution;
+   Solution<double> solution_async;
+   REQUIRE( postsolve.undo( Solution<double>( solveBinaryProblem( problem ) ),
+                            solution, result.postsolve ) ==
+            PostsolveStatus::kOk );
+   REQUIRE( postsolve.undo(
+                Solution<double>( solveBinaryProblem( problem_async ) ),
+                solution_async, result_async.postsolve ) ==
+            PostsolveStatus::kOk );
+
+   REQUIRE( solution_async.primal == solution.primal );
+   REQUIRE( original.computeSolObjective( solution_async.primal ) == 14.0 );
+}
+
 Problem<double>
 setupProblemWithMultiplePresolvingOptions()
 {
@@ -326,3 +418,119 @@ isRow( Problem<double>& problem, RowFlag rowflag, int row )
 {
    return problem.getRowFlags()[row].test( rowflag );
 }
+
+Problem<double>
+setupProblemWithIndependentBlocks( int nblocks )
+{
+   // the even blocks are copies of the problem of
+   // setupProblemWithMultiplePresolvingOptions(), the odd blocks are the
+   // covering problem
+   //  x + y >= 1, y + z >= 1, x + z >= 1
+   // with objective 2x + 3y + 4z. The columns of the blocks are interleaved.
+   Vec<Vec<std::pair<int, int>>> blockcols( nblocks );
+   int ncols = 0;
+   for( int j = 0; j < 4; ++j )
+   {
+      for( int b = 0; b < nblocks; ++b )
+      {
+         if( b % 2 == 0 || j < 3 )
+            blockcols[b].emplace_back( j, ncols++ );
+      }
+   }
+
+   Vec<std::tuple<int, int, double>> entries;
+   Vec<double> objective( ncols );
+   Vec<uint8_t> rhs_infinity;
+   Vec<double> lhs_values;
+   Vec<double> rhs_values;
+   int row = 0;
+   for( int b = 0; b < nblocks; ++b )
+   {
+      const Vec<std::pair<int, int>>& cols = blockcols[b];
+      if( b % 2 == 0 )
+      {
+         for( const std::pair<int, int>& col : cols )
+            objective[col.second] = coefficients()[col.first];
+         entries.emplace_back( row, cols[0].second, 2.0 );
+         entries.emplace_back( row, cols[1].second, 1.0 );
+         entries.emplace_back( row, cols[2].second, 1.0 );
+         entries.emplace_back( row + 1, cols[2].second, 1.0 );
+         entries.emplace_back( row + 1, cols[3].second, 1.0 );
+         rhs_infinity.insert( rhs_infinity.end(), { 0, 0 } );
+         lhs_values.insert( lhs_values.end(), { rhs()[0], rhs()[1] } );
+         rhs_values.insert( rhs_values.end(), { rhs()[0], rhs()[1] } );
+         row += 2;
+      }
+      else
+      {
+         for( int j = 0; j < 3; ++j )
+         {
+            objective[cols[j].second] = 2.0 + j;
+            entries.emplace_back( row, cols[j].second, 1.0 );
+            entries.emplace_back( row, cols[( j + 1 ) % 3].second, 1.0 );
+            rhs_infinity.push_back( 1 );
+            lhs_values.push_back( 1.0 );
+            rhs_values.push_back( 0.0 );
+            ++row;
+         }
+      }
+   }
+
+   ProblemBuilder<double> pb;
+   pb.reserve( (int) entries.size(), row, ncols );
+   pb.setNumRows( row );
+   pb.setNumCols( ncols );
+   pb.setColUbAll( Vec<double>( ncols, 1.0 ) );
+   pb.setColLbAll( Vec<double>( ncols, 0.0 ) );
+   pb.setObjAll( objective );
+   pb.setObjOffset( 0.0 );
+   pb.setColIntegralAll( Vec<uint8_t>( ncols, 1 ) );
+   pb.setRowLhsAll( lhs_values );
+   pb.setRowRhsAll( rhs_values );
+   pb.setRowRhsInfAll( rhs_infinity );
+   pb.addEntryAll( entries );
+   pb.setProblemName( "matrix with independent blocks" );
+   return pb.build();
+}
+
+Vec<double>
+solveBinaryProblem( const Problem<double>& problem )
+{
+   // enumerate all solutions of the problem with binary columns
+   const ConstraintMatrix<double>& consMatrix = problem.getConstraintMatrix();
+   const int ncols = problem.getNCols();
+   Vec<double> best;
+   double bestobj = std::numeric_limits<double>::infinity();
+
+   for( int k = 0; k != ( 1 << ncols ); ++k )
+   {
+      Vec<double> values( ncols );
+      for( int col = 0; col != ncols; ++col )
+         values[col] = ( k >> col ) & 1;
+
+      bool feasible = true;
+      for( int row = 0; row != problem.getNRows(); ++row )
+      {
+         auto rowvec = consMatrix.getRowCoefficients( row );
+         double activity = 0;
+         for( int i = 0; i != rowvec.getLength(); ++i )
+            activity += rowvec.getValues()[i] * values[rowvec.getIndices()[i]];
+
+         const RowFlags& rflags = consMatrix.getRowFlags()[row];
+         if( ( !rflags.test( RowFlag::kLhsInf ) &&
+               activity < consMatrix.getLeftHandSides()[row] ) ||
+             ( !rflags.test( RowFlag::kRhsInf ) &&
+               activity > consMatrix.getRightHandSides()[row] ) )
+            feasible = false;
+      }
+
+      double obj = problem.computeSolObjective( values );
+      if( feasible && obj < bestobj )
+      {
+         best = values;
+         bestobj = obj;
+      }
+   }
+
+   return best;
+}
@@ -69,6 +69,80 @@ TEST_CASE( "trivial-presolve-singleton-row-pt-2", "[core]" )
    REQUIRE( problemUpdate.getSingletonCols().size() == 2 );
 }
 
+TEST_CASE( "problem-update-logs-changes-since-epoch", "[core]" )
+{
+   Num<double> num{};
+   Message msg{};
+   Problem<double> problem = setupProblemPresolveSingletonRow();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   problemUpdate.trivialPresolve();
+   problemUpdate.clearStates();
+
+   int epoch = problemUpdate.getChangeEpoch();
+   problemUpdate.changeUB( 1, 5.0 );
+   problemUpdate.clearStates();
+   int nextEpoch = problemUpdate.getChangeEpoch();
+
+   Vec<int> cols;
+   problemUpdate.getChangedColsSince( epoch, cols );
+   REQUIRE( cols == Vec<int>{ 1 } );
+
+   Vec<int> rows;
+   problemUpdate.getChangedRowsSince( epoch, rows );
+   REQUIRE( rows == Vec<int>{ 0 } );
+
+   cols.clear();
+   problemUpdate.getAffectedColsSince( epoch, cols );
+   REQUIRE( cols == Vec<int>{ 0, 1, 2 } );
+
+   cols.clear();
+   rows.clear();
+   problemUpdate.getChangedColsSince( nextEpoch, cols );
+   problemUpdate.getChangedRowsSince( nextEpoch, rows );
+   REQUIRE( cols.empty() );
+   REQUIRE( rows.empty() );
+}
+
+TEST_CASE( "problem-update-recomputes-activity-after-many-updates", "[core]" )
+{
+   Num<double> num{};
+   Message msg{};
+   Problem<double> problem = setupProblemPresolveSingletonRow();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   presolveOptions.activityupdates = 3;
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   problemUpdate.trivialPresolve();
+
+   const RowActivity<double>& activity = problem.getRowActivities()[0];
+   int nupdates = activity.nupdates;
+   REQUIRE( nupdates < 3 );
+
+   for( int ub = 6; ub >= 3; --ub )
+      problemUpdate.changeUB( 1, ub );
+   REQUIRE( activity.nupdates == nupdates + 4 );
+
+   // the activity of the changed row is computed from the row again
+   REQUIRE( problemUpdate.flush( true ) != PresolveStatus::kInfeasible );
+   auto rowvec = problem.getConstraintMatrix().getRowCoefficients( 0 );
+   RowActivity<double> computed = compute_row_activity(
+       rowvec.getValues(), rowvec.getIndices(), rowvec.getLength(),
+       problem.getLowerBounds(), problem.getUpperBounds(),
+       problem.getColFlags() );
+   REQUIRE( activity.nupdates == 0 );
+   REQUIRE( activity.min == computed.min );
+   REQUIRE( activity.max == computed.max );
+   REQUIRE( activity.max == 10 );
+}
+
 Problem<double>
 setupProblemPresolveSingletonRow()
 {
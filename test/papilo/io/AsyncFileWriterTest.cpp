@@ -0,0 +1,90 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "papilo/io/AsyncFileWriter.hpp"
+#include "papilo/external/catch/catch.hpp"
+#include <boost/iostreams/copy.hpp>
+#include <cstdio>
+#include <iterator>
+#include <ostream>
+
+using namespace papilo;
+
+static std::string
+readBack( const std::string& filename, AsyncFileWriter::Compression compression )
+{
+   std::ifstream file( filename, std::ifstream::binary );
+   boost::iostreams::filtering_istream in;
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+   if( compression == AsyncFileWriter::Compression::kGzip )
+      in.push( boost::iostreams::gzip_decompressor() );
+#endif
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZSTD
+   if( compression == AsyncFileWriter::Compression::kZstd )
+      in.push( boost::iostreams::zstd_decompressor() );
+#endif
+   (void)compression;
+   in.push( file );
+
+   std::string content;
+   boost::iostreams::copy( in, std::back_inserter( content ) );
+   return content;
+}
+
+TEST_CASE( "async-file-writer-keeps-the-order-of-blocks", "[io]" )
+{
+   for( AsyncFileWriter::Compression compression :
+        { AsyncFileWriter::Compression::kNone,
+          AsyncFileWriter::Compression::kGzip,
+          AsyncFileWriter::Compression::kZstd } )
+   {
+      if( !AsyncFileWriter::isAvailable( compression ) )
+         continue;
+
+      std::string filename = std::string( "./async_file_writer.txt" ) +
+                             AsyncFileWriter::getExtension( compression );
+      std::string expected;
+
+      {
+         // blocks of 64 bytes are handed over every few lines
+         AsyncFileWriter writer( 64 );
+         REQUIRE( writer.open( filename, compression ) );
+         std::ostream out( &writer );
+
+         for( int i = 0; i < 10000; ++i )
+         {
+            out << "rup 1 x" << i << " +1 ~x" << i + 1 << " >= 1 ;\n";
+            expected += "rup 1 x" + std::to_string( i ) + " +1 ~x" +
+                        std::to_string( i + 1 ) + " >= 1 ;\n";
+            if( i % 1000 == 0 )
+               out.flush();
+         }
+         REQUIRE( out.good() );
+         REQUIRE( writer.finish() );
+         REQUIRE( !writer.isOpen() );
+      }
+
+      std::string written = readBack( filename, compression );
+      std::remove( filename.c_str() );
+      REQUIRE( written == expected );
+   }
+}
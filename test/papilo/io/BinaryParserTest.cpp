@@ -0,0 +1,138 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "papilo/io/BinaryParser.hpp"
+#include "papilo/external/catch/catch.hpp"
+#include "papilo/io/BinaryWriter.hpp"
+#include "papilo/io/MpsParser.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+using namespace papilo;
+
+TEST_CASE( "binary-problem-format-round-trip", "[io]" )
+{
+   boost::optional<Problem<double>> optional = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781.mps" );
+   REQUIRE( optional.is_initialized() == true );
+   const Problem<double>& problem = optional.get();
+
+   Vec<int> row_mapping( problem.getNRows() );
+   Vec<int> col_mapping( problem.getNCols() );
+   std::iota( row_mapping.begin(), row_mapping.end(), 0 );
+   std::iota( col_mapping.begin(), col_mapping.end(), 0 );
+   REQUIRE( BinaryWriter<double>::writeProb( "./presolved_ns2080781.pbin",
+                                             problem, row_mapping,
+                                             col_mapping ) );
+
+   boost::optional<Problem<double>> loaded =
+       BinaryParser<double>::loadProblem( "./presolved_ns2080781.pbin" );
+   std::remove( "./presolved_ns2080781.pbin" );
+   REQUIRE( loaded.is_initialized() == true );
+   const Problem<double>& copy = loaded.get();
+
+   REQUIRE( copy.getName() == problem.getName() );
+   REQUIRE( copy.getNCols() == problem.getNCols() );
+   REQUIRE( copy.getNRows() == problem.getNRows() );
+   REQUIRE( copy.getNumIntegralCols() == problem.getNumIntegralCols() );
+   REQUIRE( copy.getVariableNames() == problem.getVariableNames() );
+   REQUIRE( copy.getConstraintNames() == problem.getConstraintNames() );
+   REQUIRE( copy.getObjective().coefficients ==
+            problem.getObjective().coefficients );
+   REQUIRE( copy.getObjective().offset == problem.getObjective().offset );
+   REQUIRE( copy.getLowerBounds() == problem.getLowerBounds() );
+   REQUIRE( copy.getUpperBounds() == problem.getUpperBounds() );
+   REQUIRE( copy.getInputTolerance() == problem.getInputTolerance() );
+   REQUIRE( copy.test_problem_type( ProblemFlag::kMixedInteger ) );
+
+   const auto& matrix = problem.getConstraintMatrix();
+   const auto& copyMatrix = copy.getConstraintMatrix();
+   REQUIRE( copyMatrix.getLeftHandSides() == matrix.getLeftHandSides() );
+   REQUIRE( copyMatrix.getRightHandSides() == matrix.getRightHandSides() );
+   REQUIRE( copyMatrix.getRowSizes() == matrix.getRowSizes() );
+   REQUIRE( copyMatrix.getColSizes() == matrix.getColSizes() );
+   REQUIRE( copyMatrix.getNnz() == matrix.getNnz() );
+
+   for( int col = 0; col < problem.getNCols(); ++col )
+   {
+      REQUIRE( copy.getColFlags()[col].test( ColFlag::kIntegral ) ==
+               problem.getColFlags()[col].test( ColFlag::kIntegral ) );
+      REQUIRE( copy.getColFlags()[col].test( ColFlag::kUbInf ) ==
+               problem.getColFlags()[col].test( ColFlag::kUbInf ) );
+   }
+
+   for( int row = 0; row < problem.getNRows(); ++row )
+   {
+      auto rowvec = matrix.getRowCoefficients( row );
+      auto copyRowvec = copyMatrix.getRowCoefficients( row );
+      REQUIRE( copyRowvec.getLength() == rowvec.getLength() );
+      for( int k = 0; k < rowvec.getLength(); ++k )
+      {
+         REQUIRE( copyRowvec.getIndices()[k] == rowvec.getIndices()[k] );
+         REQUIRE( copyRowvec.getValues()[k] == rowvec.getValues()[k] );
+      }
+      REQUIRE( copy.getRowFlags()[row].test( RowFlag::kLhsInf ) ==
+               problem.getRowFlags()[row].test( RowFlag::kLhsInf ) );
+      REQUIRE( copy.getRowFlags()[row].test( RowFlag::kRhsInf ) ==
+               problem.getRowFlags()[row].test( RowFlag::kRhsInf ) );
+   }
+}
+
+TEST_CASE( "binary-problem-format-rejects-invalid-indices", "[io]" )
+{
+   boost::optional<Problem<double>> optional = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781.mps" );
+   REQUIRE( optional.is_initialized() == true );
+   const Problem<double>& problem = optional.get();
+
+   Vec<int> row_mapping( problem.getNRows() );
+   Vec<int> col_mapping( problem.getNCols() );
+   std::iota( row_mapping.begin(), row_mapping.end(), 0 );
+   std::iota( col_mapping.begin(), col_mapping.end(), 0 );
+   REQUIRE( BinaryWriter<double>::writeProb( "./invalid_ns2080781.pbin",
+                                             problem, row_mapping,
+                                             col_mapping ) );
+
+   std::ifstream file( "./invalid_ns2080781.pbin",
+                       std::ifstream::in | std::ifstream::binary );
+   std::string content( ( std::istreambuf_iterator<char>( file ) ),
+                        std::istreambuf_iterator<char>() );
+   file.close();
+   std::remove( "./invalid_ns2080781.pbin" );
+
+   binary::Header header;
+   REQUIRE( content.size() >= sizeof( binary::Header ) );
+   std::memcpy( &header, content.data(), sizeof( binary::Header ) );
+   REQUIRE( BinaryParser<double>::loadProblem( content.data(), content.size() )
+                .is_initialized() );
+
+   // the first entry of the first row refers to a column that does not exist
+   const int col = problem.getNCols();
+   std::memcpy( &content[header.sections[binary::kRowColumns].offset], &col,
+                sizeof( int ) );
+   REQUIRE( problem.getConstraintMatrix().getRowCoefficients( 0 ).getLength() >
+            0 );
+   REQUIRE( !BinaryParser<double>::loadProblem( content.data(), content.size() )
+                 .is_initialized() );
+}
@@ -22,9 +22,15 @@
 
 #include <memory>
 #include "papilo/io/MpsParser.hpp"
+#include "papilo/io/MpsWriter.hpp"
 #include "papilo/external/catch/catch.hpp"
 #include "papilo/core/PresolveMethod.hpp"
 #include "papilo/core/Problem.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <numeric>
 
 using namespace papilo;
 
@@ -42,3 +48,164 @@ TEST_CASE( "mps-parser-loading-simple-problem", "[io]" )
    REQUIRE(problem.getConstraintMatrix().getRowSizes() == expected_row_sizes);
    REQUIRE(problem.getConstraintMatrix().getColSizes() == expected_col_sizes);
 }
+
+static void
+requireEqualProblems( const Problem<double>& problem,
+                      const Problem<double>& other )
+{
+   REQUIRE( other.getNCols() == problem.getNCols() );
+   REQUIRE( other.getNRows() == problem.getNRows() );
+   REQUIRE( other.getVariableNames() == problem.getVariableNames() );
+   REQUIRE( other.getObjective().coefficients ==
+            problem.getObjective().coefficients );
+   REQUIRE( other.getNumIntegralCols() == problem.getNumIntegralCols() );
+
+   const auto& matrix = problem.getConstraintMatrix();
+   const auto& otherMatrix = other.getConstraintMatrix();
+   REQUIRE( otherMatrix.getNnz() == matrix.getNnz() );
+   for( int col = 0; col < problem.getNCols(); ++col )
+   {
+      auto column = matrix.getColumnCoefficients( col );
+      auto otherColumn = otherMatrix.getColumnCoefficients( col );
+      REQUIRE( otherColumn.getLength() == column.getLength() );
+      for( int k = 0; k < column.getLength(); ++k )
+      {
+         REQUIRE( otherColumn.getIndices()[k] == column.getIndices()[k] );
+         REQUIRE( otherColumn.getValues()[k] == column.getValues()[k] );
+      }
+   }
+}
+
+TEST_CASE( "mps-parser-loading-in-small-chunks", "[io]" )
+{
+   // a chunk size of 0 parses the file as a stream, tiny chunks split the
+   // COLUMNS section after almost every line
+   boost::optional<Problem<double>> streamed = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781.mps", 0 );
+   boost::optional<Problem<double>> chunked = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781.mps", 16 );
+   REQUIRE( streamed.is_initialized() == true );
+   REQUIRE( chunked.is_initialized() == true );
+
+   // the integral columns are enclosed by markers and the columns with more
+   // than one entry are split across a chunk boundary
+   REQUIRE( streamed->getNCols() == 162 );
+   REQUIRE( streamed->getNRows() == 167 );
+   REQUIRE( streamed->getNumIntegralCols() == 78 );
+   const auto& colsizes = streamed->getConstraintMatrix().getColSizes();
+   REQUIRE( *std::max_element( colsizes.begin(), colsizes.end() ) > 1 );
+
+   requireEqualProblems( streamed.get(), chunked.get() );
+   for( int col = 0; col < streamed->getNCols(); ++col )
+   {
+      REQUIRE( chunked->getColFlags()[col].test( ColFlag::kIntegral ) ==
+               streamed->getColFlags()[col].test( ColFlag::kIntegral ) );
+      REQUIRE( chunked->getLowerBounds()[col] ==
+               streamed->getLowerBounds()[col] );
+      REQUIRE( chunked->getUpperBounds()[col] ==
+               streamed->getUpperBounds()[col] );
+   }
+}
+
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+TEST_CASE( "mps-parser-loading-compressed-problem", "[io]" )
+{
+   boost::optional<Problem<double>> optional = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781.mps" );
+   boost::optional<Problem<double>> gzip = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781.mps.gz" );
+   // members of 4096 bytes that are inflated in parallel
+   boost::optional<Problem<double>> bgzf = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781_bgzf.mps.gz" );
+   REQUIRE( optional.is_initialized() == true );
+   REQUIRE( gzip.is_initialized() == true );
+   REQUIRE( bgzf.is_initialized() == true );
+
+   requireEqualProblems( optional.get(), gzip.get() );
+   requireEqualProblems( optional.get(), bgzf.get() );
+}
+
+TEST_CASE( "mps-parser-rejects-corrupt-compressed-problem", "[io]" )
+{
+   std::ifstream file( "./resources/presolved_ns2080781.mps.gz",
+                       std::ifstream::binary );
+   std::string compressed( ( std::istreambuf_iterator<char>( file ) ),
+                           std::istreambuf_iterator<char>() );
+   REQUIRE( compressed.size() > 100 );
+
+   // truncated in the middle, without the gzip trailer and with damaged
+   // deflate data
+   std::string truncated = compressed.substr( 0, compressed.size() / 2 );
+   std::string notrailer = compressed.substr( 0, compressed.size() - 8 );
+   std::string damaged = compressed;
+   for( std::size_t i = damaged.size() / 2; i != damaged.size() / 2 + 64; ++i )
+      damaged[i] = static_cast<char>( ~damaged[i] );
+
+   for( const std::string& content : { truncated, notrailer, damaged } )
+   {
+      {
+         std::ofstream out( "./corrupt_ns2080781.mps.gz",
+                            std::ofstream::binary );
+         out.write( content.data(), content.size() );
+      }
+      boost::optional<Problem<double>> problem =
+          MpsParser<double>::loadProblem( "./corrupt_ns2080781.mps.gz" );
+      std::remove( "./corrupt_ns2080781.mps.gz" );
+      REQUIRE( problem.is_initialized() == false );
+   }
+}
+#endif
+
+static std::string
+readFile( const std::string& filename )
+{
+   std::ifstream file( filename, std::ifstream::binary );
+   return std::string( std::istreambuf_iterator<char>( file ),
+                       std::istreambuf_iterator<char>() );
+}
+
+TEST_CASE( "mps-writer-round-trip", "[io]" )
+{
+   boost::optional<Problem<double>> optional = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781.mps" );
+   REQUIRE( optional.is_initialized() == true );
+   const Problem<double>& problem = optional.get();
+
+   Vec<int> row_mapping( problem.getNRows() );
+   Vec<int> col_mapping( problem.getNCols() );
+   std::iota( row_mapping.begin(), row_mapping.end(), 0 );
+   std::iota( col_mapping.begin(), col_mapping.end(), 0 );
+
+   MpsWriter<double>::writeProb( "./written_ns2080781.mps", problem,
+                                 row_mapping, col_mapping );
+   // tiny blocks are formatted in several parallel batches
+   MpsWriter<double>::writeProb( "./written_ns2080781_blocks.mps", problem,
+                                 row_mapping, col_mapping, 4 );
+   std::string written = readFile( "./written_ns2080781.mps" );
+   std::string blocks = readFile( "./written_ns2080781_blocks.mps" );
+   std::remove( "./written_ns2080781_blocks.mps" );
+   REQUIRE( !written.empty() );
+   REQUIRE( written == blocks );
+
+   boost::optional<Problem<double>> loaded =
+       MpsParser<double>::loadProblem( "./written_ns2080781.mps" );
+   std::remove( "./written_ns2080781.mps" );
+   REQUIRE( loaded.is_initialized() == true );
+   REQUIRE( loaded->getNCols() == problem.getNCols() );
+   REQUIRE( loaded->getNRows() == problem.getNRows() );
+   REQUIRE( loaded->getNumIntegralCols() == problem.getNumIntegralCols() );
+   REQUIRE( loaded->getConstraintNames() == problem.getConstraintNames() );
+   REQUIRE( loaded->getConstraintMatrix().getNnz() ==
+            problem.getConstraintMatrix().getNnz() );
+
+#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
+   // every block is written as a gzip member of its own
+   MpsWriter<double>::writeProb( "./written_ns2080781.mps.gz", problem,
+                                 row_mapping, col_mapping, 4 );
+   boost::optional<Problem<double>> gzip =
+       MpsParser<double>::loadProblem( "./written_ns2080781.mps.gz" );
+   std::remove( "./written_ns2080781.mps.gz" );
+   REQUIRE( gzip.is_initialized() == true );
+   requireEqualProblems( loaded.get(), gzip.get() );
+#endif
+}
@@ -0,0 +1,81 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "papilo/io/PostsolveArchive.hpp"
+#include "papilo/core/Presolve.hpp"
+#include "papilo/core/postsolve/Postsolve.hpp"
+#include "papilo/external/catch/catch.hpp"
+#include "papilo/io/MpsParser.hpp"
+#include <cstdio>
+
+using namespace papilo;
+
+TEST_CASE( "postsolve-archive-round-trip", "[io]" )
+{
+   boost::optional<Problem<double>> optional = MpsParser<double>::loadProblem(
+       "./resources/presolved_ns2080781.mps" );
+   REQUIRE( optional.is_initialized() == true );
+   Problem<double> problem = optional.get();
+
+   Presolve<double> presolve;
+   presolve.addDefaultPresolvers();
+   presolve.getPresolveOptions().threads = 1;
+   PresolveResult<double> result = presolve.apply( problem );
+   const PostsolveStorage<double>& storage = result.postsolve;
+
+   REQUIRE( PostsolveArchive<double>::write( "./presolved_ns2080781.postsolve",
+                                             storage ) );
+   REQUIRE( PostsolveArchive<double>::isArchive(
+       "./presolved_ns2080781.postsolve" ) );
+
+   PostsolveStorage<double> loaded;
+   bool success = PostsolveArchive<double>::read(
+       "./presolved_ns2080781.postsolve", loaded );
+   std::remove( "./presolved_ns2080781.postsolve" );
+   REQUIRE( success );
+
+   REQUIRE( loaded.nColsOriginal == storage.nColsOriginal );
+   REQUIRE( loaded.nRowsOriginal == storage.nRowsOriginal );
+   REQUIRE( loaded.postsolveType == storage.postsolveType );
+   REQUIRE( loaded.origcol_mapping == storage.origcol_mapping );
+   REQUIRE( loaded.origrow_mapping == storage.origrow_mapping );
+   REQUIRE( loaded.types == storage.types );
+   REQUIRE( loaded.indices == storage.indices );
+   REQUIRE( loaded.values == storage.values );
+   REQUIRE( loaded.start == storage.start );
+   REQUIRE( loaded.num.getFeasTol() == storage.num.getFeasTol() );
+   REQUIRE( loaded.getOriginalProblem().getVariableNames() ==
+            storage.getOriginalProblem().getVariableNames() );
+   REQUIRE( loaded.getOriginalProblem().getLowerBounds() ==
+            storage.getOriginalProblem().getLowerBounds() );
+
+   // the solution does not need to be feasible to compare the postsolve steps
+   Message msg{};
+   msg.setVerbosityLevel( VerbosityLevel::kQuiet );
+   Solution<double> reduced{ Vec<double>( problem.getNCols(), 0.0 ) };
+   Solution<double> original;
+   Solution<double> originalFromArchive;
+   Postsolve<double> postsolve{ msg, storage.getNum() };
+   REQUIRE( postsolve.undo( reduced, original, storage ) ==
+            postsolve.undo( reduced, originalFromArchive, loaded ) );
+   REQUIRE( originalFromArchive.primal == original.primal );
+}
@@ -0,0 +1,94 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "papilo/misc/ArenaAllocator.hpp"
+#include "papilo/external/catch/catch.hpp"
+#include <thread>
+#include <vector>
+
+using namespace papilo;
+
+TEST_CASE( "arena-allocator-reuses-freed-blocks", "[misc]" )
+{
+   ArenaAllocator<double> alloc;
+
+   double* first = alloc.allocate( 3 );
+   alloc.deallocate( first, 3 );
+   // 24 and 32 bytes are in the same size class
+   double* second = alloc.allocate( 4 );
+   REQUIRE( second == first );
+   alloc.deallocate( second, 4 );
+
+   std::vector<int, ArenaAllocator<int>> values;
+   for( int i = 0; i != 100000; ++i )
+      values.push_back( i );
+   REQUIRE( values[99999] == 99999 );
+
+   // blocks freed by another thread are put on its free list and stay valid
+   std::vector<int, ArenaAllocator<int>> moved;
+   std::thread thread( [&]() {
+      moved = std::move( values );
+      moved.clear();
+      moved.shrink_to_fit();
+      for( int i = 0; i != 1000; ++i )
+         moved.push_back( i );
+   } );
+   thread.join();
+   REQUIRE( moved.size() == 1000 );
+   REQUIRE( moved[999] == 999 );
+}
+
+TEST_CASE( "arena-allocator-counts-bytes-per-subsystem", "[misc]" )
+{
+   auto getBytes = []( const std::string& name ) {
+      for( const auto& subsystem : Arena::getStatistics().subsystems )
+      {
+         if( subsystem.name == name )
+            return subsystem.bytes;
+      }
+      return std::size_t{ 0 };
+   };
+
+   {
+      ArenaScope scope( "arena-test" );
+      std::vector<double, ArenaAllocator<double>> values( 100 );
+      {
+         ArenaScope inner( "arena-test-inner" );
+         std::vector<char, ArenaAllocator<char>> large( 100000 );
+      }
+      std::vector<double, ArenaAllocator<double>> more( 20 );
+   }
+   std::vector<double, ArenaAllocator<double>> outside( 1000 );
+
+   REQUIRE( getBytes( "arena-test" ) == 120 * sizeof( double ) );
+   REQUIRE( getBytes( "arena-test-inner" ) == 100000 );
+
+   // the counters of an exited thread are kept
+   std::thread thread( []() {
+      ArenaScope scope( "arena-test-thread" );
+      std::vector<int, ArenaAllocator<int>> values( 10 );
+   } );
+   thread.join();
+   REQUIRE( getBytes( "arena-test-thread" ) == 10 * sizeof( int ) );
+   REQUIRE( Arena::getStatistics().reservedbytes >=
+            std::size_t{ Arena::kChunkSize } );
+}
@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*    PaPILO --- Parallel Presolve for Integer and Linear Optimization       */
+/*                                                                           */
+/* Copyright (C) 2020-2024 Zuse Institute Berlin (ZIB)                       */
+/*                                                                           */
+/* This program is free software: you can redistribute it and/or modify      */
+/* it under the terms of the GNU Lesser General Public License as published  */
+/* by the Free Software Foundation, either version 3 of the License, or      */
+/* (at your option) any later version.                                       */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU Lesser General Public License for more details.                       */
+/*                                                                           */
+/* You should have received a copy of the GNU Lesser General Public License  */
+/* along with this program.  If not, see <https://www.gnu.org/licenses/>.    */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "papilo/misc/Signature.hpp"
+#include "papilo/external/catch/catch.hpp"
+
+using namespace papilo;
+
+template <typename SIG>
+void
+checkSubsetTests( int nelems )
+{
+   SIG small;
+   SIG large;
+   for( int i = 0; i != nelems; ++i )
+   {
+      large.add( i );
+      if( i % 3 == 0 )
+         small.add( i );
+   }
+
+   REQUIRE( small.isSubset( large ) );
+   REQUIRE( large.isSuperset( small ) );
+   REQUIRE( small.isSubset( small ) );
+   REQUIRE( small.isEqual( small ) );
+   REQUIRE( !small.isEqual( large ) );
+   REQUIRE( !large.isSubset( small ) );
+   REQUIRE( !small.isSuperset( large ) );
+}
+
+TEST_CASE( "signature-subset-tests", "[misc]" )
+{
+   checkSubsetTests<Signature32>( 12 );
+   checkSubsetTests<Signature64>( 24 );
+   checkSubsetTests<Signature128>( 48 );
+   checkSubsetTests<Signature256>( 96 );
+
+   // elements that are hashed to bits in the upper half of a 64 bit signature
+   // must not be mapped to the lower half
+   Signature64 upper;
+   Signature64 lower;
+   for( int i = 0; i != 1000; ++i )
+   {
+      Signature64 single;
+      single.add( i );
+      if( single.getPrefix( 31 ) == 0 )
+         upper.add( i );
+      else
+         lower.add( i );
+   }
+   REQUIRE( !upper.isEqual( Signature64{} ) );
+   REQUIRE( !upper.isSubset( lower ) );
+}
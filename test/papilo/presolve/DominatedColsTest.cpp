@@ -92,6 +92,75 @@ TEST_CASE( "domcol-happy-path", "[presolve]" )
    REQUIRE( reductions.getReduction( 7 ).newval == 0 );
 }
 
+TEST_CASE( "domcol-bucket-work-limit", "[presolve]" )
+{
+   double time = 0.0;
+   int cause = -1;
+   Timer t{time};
+   Num<double> num{};
+   Message msg{};
+   Problem<double> problem = setupMatrixForDominatedCols();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+
+   DominatedCols<double> presolvingMethod{};
+   Reductions<double> reductions{};
+   problem.recomputeAllActivities();
+
+   // no candidate of the shortest row can be compared without work
+   presolvingMethod.set_max_bucket_work( 0 );
+   PresolveStatus presolveStatus =
+       presolvingMethod.execute( problem, problemUpdate, num, reductions, t, cause);
+
+   REQUIRE( presolveStatus == PresolveStatus::kUnchanged );
+   REQUIRE( reductions.size() == 0 );
+
+   // the row and its candidates fit into the budget
+   presolvingMethod.set_max_bucket_work( 10 );
+   presolveStatus =
+       presolvingMethod.execute( problem, problemUpdate, num, reductions, t, cause);
+
+   REQUIRE( presolveStatus == PresolveStatus::kReduced );
+   REQUIRE( reductions.size() == 8 );
+}
+
+TEST_CASE( "domcol-signature-widths", "[presolve]" )
+{
+   double time = 0.0;
+   int cause = -1;
+   Timer t{time};
+   Num<double> num{};
+   Message msg{};
+   Problem<double> problem = setupMatrixForDominatedCols();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   problem.recomputeAllActivities();
+
+   // the width of the signatures must not change the reductions
+   for( int width : { 32, 64, 128, 256 } )
+   {
+      DominatedCols<double> presolvingMethod{};
+      Reductions<double> reductions{};
+      presolvingMethod.set_signature_width( width );
+
+      PresolveStatus presolveStatus = presolvingMethod.execute(
+          problem, problemUpdate, num, reductions, t, cause );
+
+      REQUIRE( presolveStatus == PresolveStatus::kReduced );
+      REQUIRE( reductions.size() == 8 );
+      REQUIRE( reductions.getReduction( 7 ).row == ColReduction::FIXED );
+      REQUIRE( reductions.getReduction( 7 ).col == 1 );
+   }
+}
+
 TEST_CASE( "domcol-parallel-columns", "[presolve]" )
 {
    double time = 0.0;
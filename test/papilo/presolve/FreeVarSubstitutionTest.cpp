@@ -27,6 +27,7 @@
 #include "papilo/core/ProblemBuilder.hpp"
 #include "papilo/core/Reductions.hpp"
 
+#include <set>
 #include <tuple>
 
 using namespace papilo;
@@ -34,6 +35,36 @@ using namespace papilo;
 Problem<double>
 setupProblemForFreeVariableSubstitution();
 
+Problem<double>
+setupProblemWithManyFreeVariableSubstitutions();
+
+static Reductions<double>
+findParallelSubstitutions( Problem<double>& problem )
+{
+   double time = 0.0;
+   int cause = -1;
+   Timer t{ time };
+   Num<double> num{};
+   Message msg{};
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   problem.recomputeAllActivities();
+
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+
+   Substitution<double> presolvingMethod{};
+   presolvingMethod.set_parallel_selection( true );
+   Reductions<double> reductions{};
+
+   presolvingMethod.initialize( problem, presolveOptions );
+   presolvingMethod.execute( problem, problemUpdate, num, reductions, t,
+                             cause );
+   return reductions;
+}
+
 
 TEST_CASE( "happy-path-test-free-variable-detection", "[presolve]" )
 {
@@ -79,6 +110,51 @@ TEST_CASE( "happy-path-test-free-variable-detection", "[presolve]" )
    REQUIRE( reductions.getReduction( 2 ).newval == 2 );
 }
 
+TEST_CASE( "free-variable-substitution-parallel-selection", "[presolve]" )
+{
+   // the single substitution is also found in the parallel mode
+   Problem<double> problem = setupProblemForFreeVariableSubstitution();
+   Reductions<double> reductions = findParallelSubstitutions( problem );
+
+   REQUIRE( reductions.size() == 3 );
+   REQUIRE( reductions.getReduction( 0 ).row == 2 );
+   REQUIRE( reductions.getReduction( 1 ).col == 3 );
+   REQUIRE( reductions.getReduction( 2 ).col == 3 );
+   REQUIRE( reductions.getReduction( 2 ).row == ColReduction::SUBSTITUTE );
+   REQUIRE( reductions.getReduction( 2 ).newval == 2 );
+
+   // the substituted columns share no rows and the selection does not
+   // depend on the number of threads
+   Problem<double> many = setupProblemWithManyFreeVariableSubstitutions();
+   Reductions<double> parallel = findParallelSubstitutions( many );
+   Reductions<double> serial;
+#ifdef PAPILO_TBB
+   tbb::task_arena( 1 ).execute(
+       [&]() { serial = findParallelSubstitutions( many ); } );
+#else
+   serial = findParallelSubstitutions( many );
+#endif
+
+   REQUIRE( parallel.getTransactions().size() > 1 );
+   REQUIRE( parallel.size() == serial.size() );
+   std::set<int> usedRows;
+   for( int i = 0; i < (int) parallel.size(); ++i )
+   {
+      const Reduction<double>& reduction = parallel.getReduction( i );
+      REQUIRE( reduction.row == serial.getReduction( i ).row );
+      REQUIRE( reduction.col == serial.getReduction( i ).col );
+      REQUIRE( reduction.newval == serial.getReduction( i ).newval );
+
+      if( reduction.row != ColReduction::SUBSTITUTE )
+         continue;
+
+      auto column =
+          many.getConstraintMatrix().getColumnCoefficients( reduction.col );
+      for( int j = 0; j < column.getLength(); ++j )
+         REQUIRE( usedRows.insert( column.getIndices()[j] ).second );
+   }
+}
+
 Problem<double>
 setupProblemForFreeVariableSubstitution()
 {
@@ -128,3 +204,32 @@ setupProblemForFreeVariableSubstitution()
    problem.getConstraintMatrix().modifyLeftHandSide( 2, num, lhs[2] );
    return problem;
 }
+
+Problem<double>
+setupProblemWithManyFreeVariableSubstitutions()
+{
+   // 40 equalities over 60 free columns, every equality has three entries
+   // and neighbouring equalities share columns
+   const int nrows = 40;
+   const int ncols = 60;
+   ProblemBuilder<double> pb;
+   pb.reserve( 3 * nrows, nrows, ncols );
+   pb.setNumRows( nrows );
+   pb.setNumCols( ncols );
+   for( int col = 0; col < ncols; ++col )
+   {
+      pb.setColLbInf( col, true );
+      pb.setColUbInf( col, true );
+      pb.setObj( col, 1.0 );
+   }
+   for( int row = 0; row < nrows; ++row )
+   {
+      pb.addEntry( row, row, 1.0 );
+      pb.addEntry( row, ( row * 7 + 3 ) % ncols, 2.0 );
+      pb.addEntry( row, ( row * 13 + 11 ) % ncols, -1.0 );
+      pb.setRowLhs( row, 1.0 );
+      pb.setRowRhs( row, 1.0 );
+   }
+   pb.setProblemName( "equalities sharing free columns" );
+   return pb.build();
+}
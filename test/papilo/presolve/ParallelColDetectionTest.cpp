@@ -37,6 +37,9 @@ setupProblemWithParallelColumns( bool first_col_int, bool second_col_int,
 Problem<double>
 setupProblemWithMultipleParallelColumns();
 
+Problem<double>
+setupProblemWithAlmostParallelColumns();
+
 TEST_CASE( "parallel_col_detection_2_integer_columns", "[presolve]" )
 {
    double time = 0.0;
@@ -397,6 +400,42 @@ TEST_CASE( "parallel_col_detection_multiple_parallel_columns", "[presolve]" )
    REQUIRE( reductions.getReduction( 12 ).newval == remaining_integer_col );
 }
 
+TEST_CASE( "parallel_col_detection_approximate_hashing", "[presolve]" )
+{
+   double time = 0.0;
+   int cause = -1;
+   Timer t{time};
+   Num<double> num{};
+   Message msg{};
+   Problem<double> problem = setupProblemWithAlmostParallelColumns();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   problemUpdate.checkChangedActivities();
+   ParallelColDetection<double> presolvingMethod{};
+
+   // the second coefficients of the columns are equal up to the tolerance
+   // but are hashed to neighbouring quanta
+   Reductions<double> reductions{};
+   PresolveStatus presolveStatus =
+       presolvingMethod.execute( problem, problemUpdate, num, reductions, t, cause );
+
+   REQUIRE( presolveStatus == PresolveStatus::kUnchanged );
+
+   presolvingMethod.set_approx_hashing( true );
+   Reductions<double> approx_reductions{};
+   presolveStatus = presolvingMethod.execute( problem, problemUpdate, num,
+                                              approx_reductions, t, cause );
+
+   REQUIRE( presolveStatus == PresolveStatus::kReduced );
+   REQUIRE( approx_reductions.size() == 3 );
+   REQUIRE( approx_reductions.getReduction( 2 ).row ==
+            ColReduction::PARALLEL );
+}
+
 Problem<double>
 setupProblemWithParallelColumns( bool first_col_int, bool second_col_int,
                                  double factor, double ub_first_col,
@@ -492,3 +531,45 @@ setupProblemWithMultipleParallelColumns()
    Problem<double> problem = pb.build();
    return problem;
 }
+
+Problem<double>
+setupProblemWithAlmostParallelColumns()
+{
+   // the second coefficient is scaled to 0.75 in the hashes, which is the
+   // boundary of a quantum
+   const double boundary = 0.75 * ( 1.0 + sqrt( 5.0 ) ) / 2.0;
+
+   Vec<double> coefficients{ 1.0, 1.0 };
+   Vec<double> lowerBounds{ 0.0, 0.0 };
+   Vec<double> upperBounds{ 10.0, 10.0 };
+   Vec<uint8_t> isIntegral{ 0, 0 };
+
+   Vec<double> rhs{ 1.0, 2.0 };
+   Vec<std::string> rowNames{
+       "A1",
+       "A2",
+   };
+   Vec<std::string> columnNames{ "c1", "c2" };
+   Vec<std::tuple<int, int, double>> entries{
+       std::tuple<int, int, double>{ 0, 0, 1.0 },
+       std::tuple<int, int, double>{ 0, 1, 1.0 },
+       std::tuple<int, int, double>{ 1, 0, boundary - 2e-10 },
+       std::tuple<int, int, double>{ 1, 1, boundary + 2e-10 },
+   };
+
+   ProblemBuilder<double> pb;
+   pb.reserve( entries.size(), rowNames.size(), columnNames.size() );
+   pb.setNumRows( rowNames.size() );
+   pb.setNumCols( columnNames.size() );
+   pb.setColUbAll( upperBounds );
+   pb.setColLbAll( lowerBounds );
+   pb.setObjAll( coefficients );
+   pb.setObjOffset( 0.0 );
+   pb.setColIntegralAll( isIntegral );
+   pb.setRowRhsAll( rhs );
+   pb.addEntryAll( entries );
+   pb.setColNameAll( columnNames );
+   pb.setProblemName( "matrix with columns parallel up to the tolerance" );
+   Problem<double> problem = pb.build();
+   return problem;
+}
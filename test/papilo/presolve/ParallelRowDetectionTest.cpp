@@ -34,6 +34,9 @@ setupProblemWithNoParallelRows();
 Problem<double>
 setupParallelRowWithMultipleParallelRows();
 
+Problem<double>
+setupParallelRowWithDifferentSupports();
+
 Problem<double>
 setupParallelRowWithMultipleParallelInequalities( double coeff );
 
@@ -987,6 +990,44 @@ int cause = -1;
    }
 }
 
+TEST_CASE( "parallel-row-different-supports", "[presolve]" )
+{
+   Num<double> num{};
+   double time = 0.0;
+   int cause = -1;
+   Timer t{ time };
+   Message msg{};
+   Problem<double> problem = setupParallelRowWithDifferentSupports();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   problemUpdate.checkChangedActivities();
+   ParallelRowDetection<double> presolvingMethod{};
+   Reductions<double> reductions{};
+
+   PresolveStatus presolveStatus =
+       presolvingMethod.execute( problem, problemUpdate, num, reductions, t, cause );
+
+   REQUIRE( presolveStatus == PresolveStatus::kReduced );
+
+   // rows 0 and 2 as well as rows 1 and 3 share their support and are
+   // parallel, row 4 has a support of its own
+   Vec<int> redundant_rows;
+   for( int i = 0; i < (int) reductions.size(); i++ )
+   {
+      if( reductions.getReduction( i ).col == RowReduction::REDUNDANT )
+         redundant_rows.push_back( reductions.getReduction( i ).row );
+   }
+
+   REQUIRE( redundant_rows.size() == 2 );
+   REQUIRE( ( redundant_rows[0] == 0 || redundant_rows[0] == 2 ) );
+   REQUIRE( ( redundant_rows[1] == 1 || redundant_rows[1] == 3 ) );
+   REQUIRE( reductions.getTransactions().size() == 2 );
+}
+
 Problem<double>
 setupProblemWithNoParallelRows()
 {
@@ -1333,3 +1374,51 @@ setupProblemParallelRowWithInfinity( bool firstRowRhsInfinity, double lhs,
    Problem<double> problem = pb.build();
    return problem;
 }
+
+Problem<double>
+setupParallelRowWithDifferentSupports()
+{
+   Vec<double> coefficients{ 1.0, 1.0, 1.0 };
+   Vec<double> upperBounds{ 10.0, 10.0, 10.0 };
+   Vec<double> lowerBounds{ 0.0, 0.0, 0.0 };
+   Vec<uint8_t> isIntegral{ 1, 1, 1 };
+
+   Vec<double> rhs{ 4.0, 5.0, 6.0, 9.0, 3.0 };
+   Vec<uint8_t> lhs_inf{ 1, 1, 1, 1, 1 };
+   Vec<std::string> rowNames{ "A1", "A2", "A3", "A4", "A5" };
+   Vec<std::string> columnNames{ "c1", "c2", "c3" };
+   Vec<std::tuple<int, int, double>> entries{
+       std::tuple<int, int, double>{ 0, 0, 1.0 },
+       std::tuple<int, int, double>{ 0, 1, 1.0 },
+
+       std::tuple<int, int, double>{ 1, 1, 1.0 },
+       std::tuple<int, int, double>{ 1, 2, 2.0 },
+
+       std::tuple<int, int, double>{ 2, 0, 2.0 },
+       std::tuple<int, int, double>{ 2, 1, 2.0 },
+
+       std::tuple<int, int, double>{ 3, 1, 3.0 },
+       std::tuple<int, int, double>{ 3, 2, 6.0 },
+
+       std::tuple<int, int, double>{ 4, 0, 1.0 },
+       std::tuple<int, int, double>{ 4, 2, 1.0 },
+   };
+
+   ProblemBuilder<double> pb;
+   pb.reserve( (int)entries.size(), (int)rowNames.size(),
+               (int)columnNames.size() );
+   pb.setNumRows( (int)rowNames.size() );
+   pb.setNumCols( (int)columnNames.size() );
+   pb.setColUbAll( upperBounds );
+   pb.setColLbAll( lowerBounds );
+   pb.setObjAll( coefficients );
+   pb.setObjOffset( 0.0 );
+   pb.setColIntegralAll( isIntegral );
+   pb.setRowRhsAll( rhs );
+   pb.setRowLhsInfAll( lhs_inf );
+   pb.addEntryAll( entries );
+   pb.setColNameAll( columnNames );
+   pb.setProblemName( "matrix with two pairs of parallel rows" );
+   Problem<double> problem = pb.build();
+   return problem;
+}
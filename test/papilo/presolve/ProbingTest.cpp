@@ -34,6 +34,12 @@ setupProblemWithProbing();
 Problem<double>
 setupProblemWithProbingWithNoBinary();
 
+Problem<double>
+setupProblemWithStoredImplications();
+
+Problem<double>
+setupProblemForBatchProbing();
+
 TEST_CASE( "happy-path-probing", "[presolve]" )
 {
    Num<double> num{};
@@ -89,6 +95,205 @@ TEST_CASE( "failed-path-probing-on-not-binary-variables", "[presolve]" )
    REQUIRE( presolveStatus == PresolveStatus::kUnchanged );
 }
 
+TEST_CASE( "probing-uses-stored-implications", "[presolve]" )
+{
+   Num<double> num{};
+   double time = 0.0;
+   int cause = -1;
+   Timer t{ time };
+   Message msg{};
+   Problem<double> problem = setupProblemWithStoredImplications();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   presolveOptions.dualreds = 0;
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   Probing<double> presolvingMethod{};
+   Reductions<double> reductions{};
+   problem.recomputeAllActivities();
+
+   // x = 1 implies y = 1 and z = 1 which violates y + z <= 1
+   const int x1 = ImplicationStore::literal( 0, true );
+   problemUpdate.getImplications().addImplications(
+       { { x1, ImplicationStore::literal( 1, true ) },
+         { x1, ImplicationStore::literal( 2, true ) } } );
+
+   PresolveStatus presolveStatus = presolvingMethod.execute(
+       problem, problemUpdate, num, reductions, t, cause );
+
+   REQUIRE( presolveStatus == PresolveStatus::kReduced );
+   REQUIRE( reductions.size() == 1 );
+   REQUIRE( reductions.getReduction( 0 ).col == 0 );
+   REQUIRE( reductions.getReduction( 0 ).row ==
+            papilo::ColReduction::UPPER_BOUND );
+   REQUIRE( reductions.getReduction( 0 ).newval == 0 );
+
+   // probing y = 1 fixes z to 0
+   const Vec<std::pair<int, int>>& found =
+       presolvingMethod.getFoundImplications();
+   REQUIRE( std::find( found.begin(), found.end(),
+                       std::make_pair( ImplicationStore::literal( 1, true ),
+                                       ImplicationStore::literal(
+                                           2, false ) ) ) != found.end() );
+}
+
+TEST_CASE( "batch-probing-finds-same-reductions", "[presolve]" )
+{
+   Num<double> num{};
+   double time = 0.0;
+   int cause = -1;
+   Timer t{ time };
+   Message msg{};
+   Problem<double> problem = setupProblemWithProbing();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   presolveOptions.dualreds = 0;
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   Probing<double> presolvingMethod{};
+   presolvingMethod.set_batch_probing( true );
+   Reductions<double> reductions{};
+   problem.recomputeAllActivities();
+
+   PresolveStatus presolveStatus = presolvingMethod.execute(
+       problem, problemUpdate, num, reductions, t, cause );
+
+   REQUIRE( presolveStatus == PresolveStatus::kReduced );
+   REQUIRE( reductions.size() == 1 );
+   REQUIRE( reductions.getReduction( 0 ).col == 1 );
+   REQUIRE( reductions.getReduction( 0 ).row ==
+            papilo::ColReduction::UPPER_BOUND );
+   REQUIRE( reductions.getReduction( 0 ).newval == 0 );
+
+   // probing y and z in one batch gives the implications of y + z <= 1
+   Problem<double> problem2 = setupProblemWithStoredImplications();
+   problem2.recomputeAllActivities();
+   BatchProbingView<double> batchView( problem2, num );
+   const Vec<int> cols{ 0, 1, 2 };
+
+   REQUIRE( !batchView.probeBatch( cols.data(), 3, nullptr ) );
+   REQUIRE( batchView.getProbingBoundChanges().empty() );
+   REQUIRE( batchView.getProbingSubstitutions().empty() );
+
+   ImplicationStore store( problem2.getNCols() );
+   REQUIRE( !batchView.probeBatch( cols.data(), 3, &store ) );
+   const Vec<std::pair<int, int>>& found = batchView.getProbingImplications();
+   REQUIRE( std::find( found.begin(), found.end(),
+                       std::make_pair( ImplicationStore::literal( 1, true ),
+                                       ImplicationStore::literal(
+                                           2, false ) ) ) != found.end() );
+   REQUIRE( std::find( found.begin(), found.end(),
+                       std::make_pair( ImplicationStore::literal( 2, true ),
+                                       ImplicationStore::literal(
+                                           1, false ) ) ) != found.end() );
+}
+
+static void
+probeProblemForBatchProbing( bool batchprobing,
+                             Vec<std::tuple<int, int, double>>& found_reductions,
+                             Vec<std::pair<int, int>>& found_implications )
+{
+   Num<double> num{};
+   double time = 0.0;
+   int cause = -1;
+   Timer t{ time };
+   Message msg{};
+   Problem<double> problem = setupProblemForBatchProbing();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   presolveOptions.dualreds = 0;
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   Probing<double> presolvingMethod{};
+   presolvingMethod.set_batch_probing( batchprobing );
+   // probe all candidates in a single badge so that both modes probe the
+   // same columns
+   ParameterSet paramSet;
+   presolvingMethod.addPresolverParams( paramSet );
+   paramSet.setParameter( "probing.minbadgesize", problem.getNCols() );
+   Reductions<double> reductions{};
+   problem.recomputeAllActivities();
+
+   PresolveStatus presolveStatus = presolvingMethod.execute(
+       problem, problemUpdate, num, reductions, t, cause );
+   REQUIRE( presolveStatus == PresolveStatus::kReduced );
+
+   found_reductions.clear();
+   for( int i = 0; i != static_cast<int>( reductions.size() ); ++i )
+   {
+      const auto& reduction = reductions.getReduction( i );
+      found_reductions.emplace_back( reduction.row, reduction.col,
+                                     reduction.newval );
+   }
+   found_implications = presolvingMethod.getFoundImplications();
+
+   // the reductions are collected from the threads in any order
+   std::sort( found_reductions.begin(), found_reductions.end() );
+   std::sort( found_implications.begin(), found_implications.end() );
+}
+
+TEST_CASE( "batch-probing-finds-same-reductions-as-scalar-probing",
+           "[presolve]" )
+{
+   Vec<std::tuple<int, int, double>> scalar_reductions;
+   Vec<std::pair<int, int>> scalar_implications;
+   probeProblemForBatchProbing( false, scalar_reductions, scalar_implications );
+
+   Vec<std::tuple<int, int, double>> batch_reductions;
+   Vec<std::pair<int, int>> batch_implications;
+   probeProblemForBatchProbing( true, batch_reductions, batch_implications );
+
+   auto countReductions = []( const Vec<std::tuple<int, int, double>>& reds,
+                              int type ) {
+      return std::count_if( reds.begin(), reds.end(),
+                            [type]( const std::tuple<int, int, double>& red ) {
+                               return std::get<0>( red ) == type;
+                            } );
+   };
+
+   // the instance has fixings, substitutions and implications
+   REQUIRE( countReductions( scalar_reductions,
+                             papilo::ColReduction::UPPER_BOUND ) > 0 );
+   REQUIRE( countReductions( scalar_reductions,
+                             papilo::ColReduction::REPLACE ) > 0 );
+   REQUIRE( !scalar_implications.empty() );
+
+   REQUIRE( batch_reductions == scalar_reductions );
+   REQUIRE( batch_implications == scalar_implications );
+}
+
+TEST_CASE( "probing-view-stores-only-changed-domains", "[presolve]" )
+{
+   Num<double> num{};
+   Problem<double> problem = setupProblemWithStoredImplications();
+   problem.recomputeAllActivities();
+   ProbingView<double> probingView( problem, num );
+
+   // probing y = 1 fixes z to 0 in the view but not in the problem
+   probingView.setProbingColumn( 1, true );
+   probingView.propagateDomains();
+
+   REQUIRE( !probingView.isInfeasible() );
+   REQUIRE( probingView.getProbingLowerBounds()[1] == 1 );
+   REQUIRE( probingView.getProbingUpperBounds()[2] == 0 );
+   REQUIRE( !probingView.getProbingUpperBounds().isChanged( 0 ) );
+   REQUIRE( probingView.getProbingUpperBounds()[0] == 1 );
+   REQUIRE( problem.getUpperBounds()[2] == 1 );
+
+   probingView.reset();
+
+   REQUIRE( probingView.getProbingLowerBounds().getNChanged() == 0 );
+   REQUIRE( probingView.getProbingUpperBounds().getNChanged() == 0 );
+   REQUIRE( probingView.getProbingLowerBounds()[1] == 0 );
+   REQUIRE( probingView.getProbingUpperBounds()[2] == 1 );
+}
+
 Problem<double>
 setupProblemWithProbing()
 {
@@ -159,3 +364,116 @@ setupProblemWithProbingWithNoBinary()
    Problem<double> problem = pb.build();
    return problem;
 }
+
+Problem<double>
+setupProblemWithStoredImplications()
+{
+   // x + y + z <= 3
+   // y + z <= 1
+   Vec<double> coefficients{ 1.0, 1.0, 1.0 };
+   Vec<double> upperBounds{ 1.0, 1.0, 1.0 };
+   Vec<double> lowerBounds{ 0.0, 0.0, 0.0 };
+   Vec<uint8_t> isIntegral{ 1, 1, 1 };
+
+   Vec<double> rhs{ 3.0, 1.0 };
+   Vec<std::string> rowNames{ "A1", "A2" };
+   Vec<std::string> columnNames{ "x", "y", "z" };
+   Vec<std::tuple<int, int, double>> entries{
+       std::tuple<int, int, double>{ 0, 0, 1.0 },
+       std::tuple<int, int, double>{ 0, 1, 1.0 },
+       std::tuple<int, int, double>{ 0, 2, 1.0 },
+       std::tuple<int, int, double>{ 1, 1, 1.0 },
+       std::tuple<int, int, double>{ 1, 2, 1.0 },
+   };
+
+   ProblemBuilder<double> pb;
+   pb.reserve( entries.size(), rowNames.size(), columnNames.size() );
+   pb.setNumRows( rowNames.size() );
+   pb.setNumCols( columnNames.size() );
+   pb.setColUbAll( upperBounds );
+   pb.setColLbAll( lowerBounds );
+   pb.setObjAll( coefficients );
+   pb.setObjOffset( 0.0 );
+   pb.setColIntegralAll( isIntegral );
+   pb.setRowRhsAll( rhs );
+   pb.addEntryAll( entries );
+   pb.setColNameAll( columnNames );
+   pb.setProblemName( "matrix for testing probing with stored implications" );
+   Problem<double> problem = pb.build();
+   return problem;
+}
+
+Problem<double>
+setupProblemForBatchProbing()
+{
+   // 72 binaries are probed in three batches of at most 32 columns
+   // knapsacks 1 x_9k + 2 x_9k+1 + ... + 5 x_9k+4 + 1 x_9k+5 + ... <= 6 give
+   // each probe in a row a different slack
+   // x_9m + x_9m+36 = 1 for m < 4 gives substitutions
+   // x_j+64 - x_j+16 <= 0 and x_j+64 + x_j+16 <= 1 for j < 8 give fixings
+   const int ncols = 72;
+   Vec<double> coefficients( ncols, 1.0 );
+   Vec<double> upperBounds( ncols, 1.0 );
+   Vec<double> lowerBounds( ncols, 0.0 );
+   Vec<uint8_t> isIntegral( ncols, 1 );
+   Vec<std::string> columnNames;
+   for( int j = 0; j != ncols; ++j )
+      columnNames.push_back( "x" + std::to_string( j ) );
+
+   Vec<double> lhs;
+   Vec<uint8_t> lhs_inf;
+   Vec<double> rhs;
+   Vec<std::tuple<int, int, double>> entries;
+   for( int k = 0; k != ncols / 9; ++k )
+   {
+      for( int j = 0; j != 9; ++j )
+         entries.emplace_back( int( rhs.size() ), 9 * k + j, 1.0 + j % 5 );
+      lhs.push_back( 0.0 );
+      lhs_inf.push_back( 1 );
+      rhs.push_back( 6.0 );
+   }
+   for( int m = 0; m != 4; ++m )
+   {
+      entries.emplace_back( int( rhs.size() ), 9 * m, 1.0 );
+      entries.emplace_back( int( rhs.size() ), 9 * m + 36, 1.0 );
+      lhs.push_back( 1.0 );
+      lhs_inf.push_back( 0 );
+      rhs.push_back( 1.0 );
+   }
+   for( int j = 0; j != 8; ++j )
+   {
+      entries.emplace_back( int( rhs.size() ), j + 64, 1.0 );
+      entries.emplace_back( int( rhs.size() ), j + 16, -1.0 );
+      lhs.push_back( 0.0 );
+      lhs_inf.push_back( 1 );
+      rhs.push_back( 0.0 );
+
+      entries.emplace_back( int( rhs.size() ), j + 64, 1.0 );
+      entries.emplace_back( int( rhs.size() ), j + 16, 1.0 );
+      lhs.push_back( 0.0 );
+      lhs_inf.push_back( 1 );
+      rhs.push_back( 1.0 );
+   }
+   Vec<std::string> rowNames;
+   for( int i = 0; i != static_cast<int>( rhs.size() ); ++i )
+      rowNames.push_back( "A" + std::to_string( i ) );
+
+   ProblemBuilder<double> pb;
+   pb.reserve( entries.size(), rowNames.size(), columnNames.size() );
+   pb.setNumRows( rowNames.size() );
+   pb.setNumCols( columnNames.size() );
+   pb.setColUbAll( upperBounds );
+   pb.setColLbAll( lowerBounds );
+   pb.setObjAll( coefficients );
+   pb.setObjOffset( 0.0 );
+   pb.setColIntegralAll( isIntegral );
+   pb.setRowLhsInfAll( lhs_inf );
+   pb.setRowLhsAll( lhs );
+   pb.setRowRhsAll( rhs );
+   pb.addEntryAll( entries );
+   pb.setColNameAll( columnNames );
+   pb.setRowNameAll( rowNames );
+   pb.setProblemName( "matrix for testing batch probing" );
+   Problem<double> problem = pb.build();
+   return problem;
+}
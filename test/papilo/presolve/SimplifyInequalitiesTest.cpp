@@ -37,6 +37,9 @@ setup_simplify_ineq_reduce_rhs();
 Problem<double>
 setup_simple_problem_for_simplify_inequalities_2();
 
+Problem<double>
+setup_simplify_ineq_two_rows();
+
 TEST_CASE( "happy-path-simplify-inequalities", "[presolve]" )
 {
    // 15x1 +15x2 +7x3 +3x4 +y1 <= 26
@@ -148,6 +151,71 @@ TEST_CASE( "simplify_inequ_doesnt_apply_lb_and_ub_on_one_row", "[presolve]" )
    REQUIRE( presolveStatus == PresolveStatus::kUnchanged );
 }
 
+TEST_CASE( "simplify_inequ_on_changed_rows_matches_full_run", "[presolve]" )
+{
+   Num<double> num{};
+   double time = 0.0;
+   int cause = -1;
+   Timer t{ time };
+   Message msg{};
+   Problem<double> problem = setup_simplify_ineq_two_rows();
+   Statistics statistics{};
+   PresolveOptions presolveOptions{};
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   problem.recomputeAllActivities();
+   SimplifyInequalities<double> presolvingMethod{};
+   presolvingMethod.initialize( problem, presolveOptions );
+   Reductions<double> reductions{};
+
+   // the first call simplifies only the first row
+   PresolveStatus presolveStatus = presolvingMethod.run(
+       problem, problemUpdate, num, reductions, t, cause );
+   REQUIRE( presolveStatus == PresolveStatus::kReduced );
+   for( const auto& reduction : reductions.getReductions() )
+      REQUIRE( reduction.row == 0 );
+
+   const auto& reds = reductions.getReductions();
+   REQUIRE( problemUpdate.applyTransaction( reds.data(),
+                                            reds.data() + reds.size(),
+                                            ArgumentType::kPrimal ) ==
+            ApplyResult::kApplied );
+   problemUpdate.flushChangedCoeffs();
+   REQUIRE( problemUpdate.flush( true ) != PresolveStatus::kInfeasible );
+   problemUpdate.clearStates();
+
+   // the bound change makes the second row simplifiable
+   problemUpdate.changeUB( 9, 1.0 );
+   problemUpdate.flush( true );
+   problemUpdate.clearStates();
+
+   Reductions<double> incremental{};
+   presolveStatus = presolvingMethod.run( problem, problemUpdate, num,
+                                          incremental, t, cause );
+   REQUIRE( presolveStatus == PresolveStatus::kReduced );
+
+   SimplifyInequalities<double> freshMethod{};
+   freshMethod.initialize( problem, presolveOptions );
+   Reductions<double> full{};
+   presolveStatus =
+       freshMethod.run( problem, problemUpdate, num, full, t, cause );
+   REQUIRE( presolveStatus == PresolveStatus::kReduced );
+
+   REQUIRE( incremental.size() == full.size() );
+   for( int i = 0; i != static_cast<int>( full.size() ); ++i )
+   {
+      REQUIRE( incremental.getReduction( i ).row ==
+               full.getReduction( i ).row );
+      REQUIRE( incremental.getReduction( i ).col ==
+               full.getReduction( i ).col );
+      REQUIRE( incremental.getReduction( i ).newval ==
+               full.getReduction( i ).newval );
+   }
+   REQUIRE( full.getReduction( 0 ).row == 1 );
+}
+
 Problem<double>
 setupProblemForSimplifyingInequalities()
 {
@@ -268,3 +336,48 @@ setup_simple_problem_for_simplify_inequalities_2()
    Problem<double> problem = pb.build();
    return problem;
 }
+
+Problem<double>
+setup_simplify_ineq_two_rows()
+{
+   // 15x1 +15x2 +7x3 +3x4 +y1 <= 26
+   // 15x5 +15x6 +7x7 +3x8 +y2 <= 26 with y2 <= 100
+   Vec<double> coefficients( 10, 1.0 );
+   Vec<double> lowerBounds( 10, 0.0 );
+   Vec<double> upperBounds{ 1, 1, 1, 1, 1, 1, 1, 1, 1, 100 };
+   Vec<uint8_t> lhsInf{ 1, 1 };
+   Vec<uint8_t> isIntegral{ 1, 1, 1, 1, 0, 1, 1, 1, 1, 0 };
+
+   Vec<double> rhs{ 26, 26 };
+   Vec<std::string> rowNames{ "A1", "A2" };
+   Vec<std::string> columnNames{ "x1", "x2", "x3", "x4", "y1",
+                                 "x5", "x6", "x7", "x8", "y2" };
+   Vec<std::tuple<int, int, double>> entries{
+       std::tuple<int, int, double>{ 0, 0, 15.0 },
+       std::tuple<int, int, double>{ 0, 1, 15.0 },
+       std::tuple<int, int, double>{ 0, 2, 7.0 },
+       std::tuple<int, int, double>{ 0, 3, 3.0 },
+       std::tuple<int, int, double>{ 0, 4, 1.0 },
+       std::tuple<int, int, double>{ 1, 5, 15.0 },
+       std::tuple<int, int, double>{ 1, 6, 15.0 },
+       std::tuple<int, int, double>{ 1, 7, 7.0 },
+       std::tuple<int, int, double>{ 1, 8, 3.0 },
+       std::tuple<int, int, double>{ 1, 9, 1.0 } };
+
+   ProblemBuilder<double> pb;
+   pb.reserve( (int) entries.size(), (int) rowNames.size(), (int) columnNames.size() );
+   pb.setNumRows( (int) rowNames.size() );
+   pb.setNumCols( (int) columnNames.size() );
+   pb.setColLbAll( lowerBounds );
+   pb.setColUbAll( upperBounds );
+   pb.setObjAll( coefficients );
+   pb.setObjOffset( 0.0 );
+   pb.setColIntegralAll( isIntegral );
+   pb.setRowRhsAll( rhs );
+   pb.setRowLhsInfAll( lhsInf );
+   pb.addEntryAll( entries );
+   pb.setColNameAll( columnNames );
+   pb.setProblemName( "second row can be simplified after bounding y2" );
+   Problem<double> problem = pb.build();
+   return problem;
+}
@@ -25,6 +25,7 @@
 #include "papilo/core/PresolveMethod.hpp"
 #include "papilo/core/Problem.hpp"
 #include "papilo/core/ProblemBuilder.hpp"
+#include <numeric>
 
 using namespace papilo;
 
@@ -43,6 +44,9 @@ setupProblemForSparsifyWithOneMiss_2( uint8_t binary );
 Problem<double>
 setupProblemForSparsifyWithContinuousVariableMissTwo();
 
+Problem<double>
+setupProblemWithLongEqualityForSparsify();
+
 TEST_CASE( "happy-path-sparsify", "[presolve]" )
 {
    Num<double> num{};
@@ -125,6 +129,100 @@ TEST_CASE( "happy-path-sparsify-two-equalities", "[presolve]" )
    REQUIRE( reductions.getReduction( 2 ).newval == -3 );
 }
 
+TEST_CASE( "sparsify-reuses-workspace-between-calls", "[presolve]" )
+{
+   double time = 0.0;
+   int cause = -1;
+   Timer t{ time };
+   Num<double> num{};
+   Message msg{};
+   Problem<double> problem = setupProblemWithSparsify2Equalities();
+   const PresolveOptions presolveOptions{};
+   Statistics statistics{};
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   Sparsify<double> presolvingMethod{};
+   REQUIRE( presolvingMethod.initialize( problem, presolveOptions ) );
+   problem.recomputeAllActivities();
+
+   Reductions<double> first{};
+   REQUIRE( presolvingMethod.execute( problem, problemUpdate, num, first, t,
+                                      cause ) == PresolveStatus::kReduced );
+
+   // the second call works on the kept workspace, the third one after the
+   // workspace was shrunk by a compression that keeps all rows and columns
+   Vec<int> rowmap( problem.getNRows() );
+   Vec<int> colmap( problem.getNCols() );
+   std::iota( rowmap.begin(), rowmap.end(), 0 );
+   std::iota( colmap.begin(), colmap.end(), 0 );
+
+   for( int call = 0; call != 2; ++call )
+   {
+      if( call == 1 )
+         presolvingMethod.compress( rowmap, colmap );
+
+      Reductions<double> reductions{};
+      REQUIRE( presolvingMethod.execute( problem, problemUpdate, num,
+                                         reductions, t, cause ) ==
+               PresolveStatus::kReduced );
+      REQUIRE( reductions.size() == first.size() );
+      for( int i = 0; i != (int) first.size(); ++i )
+      {
+         REQUIRE( reductions.getReduction( i ).row ==
+                  first.getReduction( i ).row );
+         REQUIRE( reductions.getReduction( i ).col ==
+                  first.getReduction( i ).col );
+         REQUIRE( reductions.getReduction( i ).newval ==
+                  first.getReduction( i ).newval );
+      }
+   }
+}
+
+TEST_CASE( "sparsify-long-equality-within-work-budget", "[presolve]" )
+{
+   double time = 0.0;
+   int cause = -1;
+   Timer t{ time };
+   Num<double> num{};
+   Message msg{};
+   Problem<double> problem = setupProblemWithLongEqualityForSparsify();
+   const PresolveOptions presolveOptions{};
+   Statistics statistics{};
+   PostsolveStorage<double> postsolve =
+       PostsolveStorage<double>( problem, num, presolveOptions );
+   ProblemUpdate<double> problemUpdate( problem, postsolve, statistics,
+                                        presolveOptions, num, msg );
+   Sparsify<double> presolvingMethod{};
+   problem.recomputeAllActivities();
+
+   // only row 1 contains all columns of the equality, row 2 misses two of
+   // them and the short rows are ruled out before their hits are counted
+   Reductions<double> reductions{};
+   REQUIRE( presolvingMethod.execute( problem, problemUpdate, num, reductions,
+                                      t, cause ) == PresolveStatus::kReduced );
+   REQUIRE( reductions.size() == 3 );
+   REQUIRE( reductions.getReduction( 0 ).row == 0 );
+   REQUIRE( reductions.getReduction( 0 ).col == RowReduction::LOCKED );
+
+   REQUIRE( reductions.getReduction( 1 ).row == 0 );
+   REQUIRE( reductions.getReduction( 1 ).col == RowReduction::SPARSIFY );
+   REQUIRE( reductions.getReduction( 1 ).newval == 1 );
+
+   REQUIRE( reductions.getReduction( 2 ).row == 1 );
+   REQUIRE( reductions.getReduction( 2 ).col == RowReduction::NONE );
+   REQUIRE( reductions.getReduction( 2 ).newval == -1 );
+
+   // the equality is skipped if its columns exceed the work budget
+   presolvingMethod.set_max_equality_work( 100 );
+   Reductions<double> budgetReductions{};
+   REQUIRE( presolvingMethod.execute( problem, problemUpdate, num,
+                                      budgetReductions, t, cause ) ==
+            PresolveStatus::kUnchanged );
+   REQUIRE( budgetReductions.size() == 0 );
+}
+
 TEST_CASE( "failed-path-sparsify-if-misses-one-for-integer", "[presolve]" )
 {
    Num<double> num{};
@@ -410,3 +508,56 @@ setupProblemForSparsifyWithContinuousVariableMissTwo()
    problem.getConstraintMatrix().modifyLeftHandSide( 0, num, rhs[0] );
    return problem;
 }
+
+Problem<double>
+setupProblemWithLongEqualityForSparsify()
+{
+   Num<double> num{};
+   const int eqlen = 40;
+   const int ncols = eqlen + 1;
+   const int nshortrows = 200;
+   const int nrows = 3 + nshortrows;
+
+   Vec<double> coefficients( ncols, 1.0 );
+   Vec<double> upperBounds( ncols, 3.0 );
+   Vec<double> lowerBounds( ncols, 0.0 );
+   Vec<double> rhs( nrows, 2.0 );
+   rhs[0] = 4.0;
+
+   // row 0 is the equality over the first eqlen columns, row 1 contains all
+   // of them and row 2 misses the last two; the short rows share at most
+   // three columns with the equality
+   Vec<std::tuple<int, int, double>> entries;
+   for( int col = 0; col != ncols; ++col )
+   {
+      if( col != eqlen )
+         entries.emplace_back( 0, col, 1.0 );
+      entries.emplace_back( 1, col, 1.0 );
+      if( col < eqlen - 2 )
+         entries.emplace_back( 2, col, 1.0 );
+   }
+   for( int k = 0; k != nshortrows; ++k )
+   {
+      int row = 3 + k;
+      int first = k % 20 == 0 ? 0 : 2 + k % ( eqlen - 2 );
+      int second = 2 + ( k + 7 ) % ( eqlen - 2 );
+      entries.emplace_back( row, std::min( first, second ), 1.0 );
+      entries.emplace_back( row, std::max( first, second ), 1.0 );
+      entries.emplace_back( row, eqlen, 1.0 );
+   }
+
+   ProblemBuilder<double> pb;
+   pb.reserve( entries.size(), nrows, ncols );
+   pb.setNumRows( nrows );
+   pb.setNumCols( ncols );
+   pb.setColUbAll( upperBounds );
+   pb.setColLbAll( lowerBounds );
+   pb.setObjAll( coefficients );
+   pb.setObjOffset( 0.0 );
+   pb.setRowRhsAll( rhs );
+   pb.addEntryAll( entries );
+   pb.setProblemName( "Sparsify test: long equality" );
+   Problem<double> problem = pb.build();
+   problem.getConstraintMatrix().modifyLeftHandSide( 0, num, rhs[0] );
+   return problem;
+}